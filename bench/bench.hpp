@@ -0,0 +1,153 @@
+/* bench.hpp -- minimal benchmark harness for sokol_hpp_bench
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace bench {
+// Keep the compiler from optimizing away a value that is otherwise unused
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Which way a reported value improves; timings always get better as they go down
+enum class direction { lower_is_better, higher_is_better };
+
+struct result {
+    std::string name;
+    double ns_per_op = 0.0;      // median of all samples, or the value given to report()
+    double min_ns_per_op = 0.0;  // best sample
+    uint64_t iterations = 0;     // per sample
+    int samples = 0;
+    std::string unit = "ns/op";
+    direction dir = direction::lower_is_better;
+};
+
+class suite {
+public:
+    suite(double min_time_ms = 20.0, const char* filter = nullptr) : min_time_ms_(min_time_ms), filter_(filter) {}
+
+    // Time fn(), which performs one operation per call
+    template <typename F>
+    void run(const std::string& name, F&& fn) {
+        run_batch(name, 1, fn);
+    }
+
+    // Time fn(), which performs ops_per_call operations per call
+    template <typename F>
+    void run_batch(const std::string& name, uint64_t ops_per_call, F&& fn) {
+        if (filter_ && name.find(filter_) == std::string::npos)
+            return;
+        // grow the iteration count until one sample takes a tenth of the time budget
+        uint64_t iters = 1;
+        double sample_ns = 0.0;
+        for (;;) {
+            sample_ns = time(iters, fn);
+            if (sample_ns >= min_time_ms_ * 1e5 || iters >= (1ull << 40))
+                break;
+            iters *= 2;
+        }
+        std::vector<double> samples;
+        samples.reserve(num_samples);
+        for (int i = 0; i < num_samples; i++)
+            samples.push_back(time(iters, fn) / (double)(iters * ops_per_call));
+        std::sort(samples.begin(), samples.end());
+        result r;
+        r.name = name;
+        r.ns_per_op = samples[samples.size() / 2];
+        r.min_ns_per_op = samples.front();
+        r.iterations = iters;
+        r.samples = num_samples;
+        results_.push_back(r);
+        printf("%-60s %12.2f ns/op %12.2f min\n", name.c_str(), r.ns_per_op, r.min_ns_per_op);
+        fflush(stdout);
+    }
+
+    // Record a value measured by the caller (e.g. a ratio or a throughput figure)
+    void report(const std::string& name, double value, const char* unit, direction dir) {
+        if (filter_ && name.find(filter_) == std::string::npos)
+            return;
+        result r;
+        r.name = name;
+        r.ns_per_op = value;
+        r.min_ns_per_op = value;
+        r.samples = 1;
+        r.unit = unit;
+        r.dir = dir;
+        results_.push_back(r);
+        printf("%-60s %12.2f %s\n", name.c_str(), value, unit);
+        fflush(stdout);
+    }
+
+    const std::vector<result>& results() const { return results_; }
+
+    void write_json(FILE* out, const char* build_type) const {
+        fprintf(out, "{\n  \"version\": 2,\n");
+        fprintf(out, "  \"context\": {\"compiler\": \"%s\", \"build_type\": \"%s\"},\n", compiler(), build_type ? build_type : "");
+        fprintf(out, "  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results_.size(); i++) {
+            const result& r = results_[i];
+            fprintf(out, "    {\"name\": \"%s\", \"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, \"iterations\": %llu, \"samples\": %d, "
+                         "\"unit\": \"%s\", \"higher_is_better\": %s}%s\n",
+                    r.name.c_str(), r.ns_per_op, r.min_ns_per_op, (unsigned long long)r.iterations, r.samples,
+                    r.unit.c_str(), r.dir == direction::higher_is_better ? "true" : "false",
+                    i + 1 < results_.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+
+    static constexpr int num_samples = 7;
+
+private:
+    template <typename F>
+    static double time(uint64_t iters, F& fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iters; i++)
+            fn();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    static const char* compiler() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc";
+#else
+        return "unknown";
+#endif
+    }
+
+    double min_time_ms_;
+    const char* filter_;
+    std::vector<result> results_;
+};
+} // namespace bench
@@ -0,0 +1,85 @@
+// Allocator backends for the sokol allocator hooks against malloc
+
+#include "sokol.hpp"
+#include "sokol_alloc.hpp"
+#include "bench.hpp"
+
+using bench::do_not_optimize;
+
+namespace {
+// Setup pattern: pool-sized allocations of a few bytes to a few hundred KB, freed at shutdown
+const size_t setup_sizes[] = {
+    64, 4096, 128 * 96, 128 * 240, 64 * 176, 64 * 312, 128 * 64, 4 * 1024 * 64,
+    256, 512, 1024, 128 * 48, 32 * 1024, 16, 65536, 8192,
+};
+constexpr int num_setup = sizeof(setup_sizes) / sizeof(setup_sizes[0]);
+
+template <typename Alloc>
+void setup_teardown(Alloc&& alloc) {
+    void* ptrs[num_setup];
+    for (int i = 0; i < num_setup; i++)
+        ptrs[i] = alloc.alloc(setup_sizes[i]);
+    do_not_optimize(ptrs);
+    for (int i = num_setup - 1; i >= 0; i--)
+        alloc.free(ptrs[i]);
+}
+
+// Churn pattern: small per-resource allocations (16..2048 bytes) with interleaved frees
+struct churn {
+    static constexpr int slots = 256;
+    void* ptrs[slots] = {};
+    uint32_t rng = 12345;
+
+    template <typename Alloc>
+    void step(Alloc&& alloc) {
+        rng = rng * 1664525u + 1013904223u;
+        int slot = (int)((rng >> 8) % slots);
+        if (ptrs[slot]) {
+            alloc.free(ptrs[slot]);
+            ptrs[slot] = nullptr;
+        } else {
+            ptrs[slot] = alloc.alloc(16 + ((rng >> 16) & 2047));
+        }
+    }
+
+    template <typename Alloc>
+    void drain(Alloc&& alloc) {
+        for (auto& p : ptrs) {
+            alloc.free(p);
+            p = nullptr;
+        }
+    }
+};
+
+// Arena without a reset between runs would run out, reset it per setup instead
+struct arena_setup {
+    sokol::arena_allocator& arena;
+    void* alloc(size_t size) const { return arena.malloc(size); }
+    void free(void* ptr) const { arena.release(ptr); }
+};
+} // namespace
+
+void bench_alloc(bench::suite& s) {
+    sokol::allocator sys;
+    sokol::tlsf_allocator tlsf(64 * 1024 * 1024);
+    sokol::arena_allocator arena(8 * 1024 * 1024);
+    sokol::tracking_allocator tracked("bench", sys);
+    const sokol::allocator tlsf_hooks = tlsf.get();
+    const sokol::allocator tracked_hooks = tracked.get();
+
+    s.run_batch("alloc.setup.malloc", num_setup, [&] { setup_teardown(sys); });
+    s.run_batch("alloc.setup.tlsf", num_setup, [&] { setup_teardown(tlsf_hooks); });
+    s.run_batch("alloc.setup.arena", num_setup, [&] {
+        setup_teardown(arena_setup{arena});
+        arena.reset();
+    });
+    s.run_batch("alloc.setup.tracking_malloc", num_setup, [&] { setup_teardown(tracked_hooks); });
+
+    churn c_sys, c_tlsf, c_tracked;
+    s.run("alloc.churn.malloc", [&] { c_sys.step(sys); });
+    s.run("alloc.churn.tlsf", [&] { c_tlsf.step(tlsf_hooks); });
+    s.run("alloc.churn.tracking_malloc", [&] { c_tracked.step(tracked_hooks); });
+    c_sys.drain(sys);
+    c_tlsf.drain(tlsf_hooks);
+    c_tracked.drain(tracked_hooks);
+}
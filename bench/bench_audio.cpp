@@ -0,0 +1,168 @@
+// Audio: mixer throughput in voices per millisecond of stream callback time, resampler
+// throughput and quality per preset, DSP graph cost with and without silent subgraphs, and
+// the real-time factor of an offline render through the stream callback
+
+#include "sokol.hpp"
+#include "bench.hpp"
+
+using bench::do_not_optimize;
+
+namespace {
+constexpr int callback_frames = 512;
+
+// Mixes num_voices looping voices of the given source channel count into a stereo callback
+void bench_mixer(bench::suite& s, int num_voices, int source_channels, int max_audible) {
+    std::vector<float> samples((size_t)48000 * (size_t)source_channels);
+    for (size_t i = 0; i < samples.size(); i++)
+        samples[i] = (float)((i * 7919) % 2001) / 1000.0f - 1.0f;
+    const saudio::sound snd = {samples.data(), 48000, source_channels};
+
+    saudio::mixer::config cfg;
+    cfg.max_voices = num_voices;
+    cfg.max_audible = max_audible;
+    cfg.command_capacity = num_voices;
+    saudio::mixer mx(cfg);
+    for (int i = 0; i < num_voices; i++) {
+        saudio::mixer::voice_params params;
+        params.gain = 0.25f + 0.5f * (float)(i % 7) / 7.0f;
+        params.pan = (float)(i % 11) / 5.0f - 1.0f;
+        params.start_frame = (i * 997) % 48000;
+        params.loop = true;
+        mx.play(snd, params);
+    }
+    std::vector<float> out((size_t)callback_frames * 2);
+
+    std::string name = "audio.mixer." + std::to_string(num_voices) + "v." + (source_channels == 1 ? "mono" : "stereo");
+    if (max_audible)
+        name += ".audible" + std::to_string(max_audible);
+    const size_t before = s.results().size();
+    s.run(name, [&] {
+        mx.mix(out.data(), callback_frames, 2);
+        do_not_optimize(out[0]);
+    });
+    if (s.results().size() > before)
+        s.report(name + ".voices_per_ms", (double)num_voices / (s.results().back().ns_per_op * 1e-6), "voices/ms", bench::direction::higher_is_better);
+}
+
+const char* preset_name(saudio::resampler::quality q) {
+    static const char* names[] = {"fast", "balanced", "high", "best"};
+    return names[(int)q];
+}
+
+// SNR of a 1 kHz sine converted from in_rate to out_rate against the exact sine
+double resampler_snr(saudio::resampler::quality q, double in_rate, double out_rate) {
+    const double two_pi = 6.28318530717958647692;
+    const int in_frames = (int)in_rate;
+    std::vector<float> in((size_t)in_frames);
+    for (int i = 0; i < in_frames; i++)
+        in[(size_t)i] = (float)std::sin(two_pi * 1000.0 * i / in_rate);
+    const int out_frames = (int)((double)in_frames * out_rate / in_rate) - 256;
+    std::vector<float> out((size_t)out_frames);
+    saudio::resampler rs(1, in_rate, out_rate, q);
+    int consumed = 0, produced = 0;
+    while (produced < out_frames) {
+        saudio::resampler::result r = rs.process(in.data() + consumed, in_frames - consumed, out.data() + produced, out_frames - produced);
+        consumed += r.consumed;
+        produced += r.produced;
+    }
+    double signal = 0.0, noise = 0.0;
+    for (int i = rs.taps(); i < out_frames; i++) {
+        const double ref = std::sin(two_pi * 1000.0 * (double)i * in_rate / out_rate / in_rate);
+        const double err = (double)out[(size_t)i] - ref;
+        signal += ref * ref;
+        noise += err * err;
+    }
+    return 10.0 * std::log10(signal / noise);
+}
+
+void bench_resampler(bench::suite& s, saudio::resampler::quality q) {
+    const std::string name = std::string("audio.resampler.") + preset_name(q);
+    std::vector<float> in((size_t)callback_frames * 2);
+    for (size_t i = 0; i < in.size(); i++)
+        in[i] = (float)((i * 7919) % 2001) / 1000.0f - 1.0f;
+    std::vector<float> out((size_t)callback_frames * 2);
+    saudio::resampler rs(2, 44100.0, 48000.0, q, 1.0f, callback_frames);
+    // stereo 44.1 kHz -> 48 kHz, one callback worth of output per call
+    s.run_batch(name + ".stereo_44k1_48k", callback_frames, [&] {
+        rs.pull(out.data(), callback_frames, [&](float* frames, int n) { memcpy(frames, in.data(), (size_t)n * 2 * sizeof(float)); });
+        do_not_optimize(out[0]);
+    });
+    s.report(name + ".snr_44k1_48k", resampler_snr(q, 44100.0, 48000.0), "dB", bench::direction::higher_is_better);
+    s.report(name + ".snr_48k_44k1", resampler_snr(q, 48000.0, 44100.0), "dB", bench::direction::higher_is_better);
+}
+// Source that is audible for the first `audible` callbacks only
+struct bench_source {
+    int audible;
+    void operator()(float* out, int frames, int channels) {
+        const size_t count = (size_t)frames * (size_t)channels;
+        for (size_t i = 0; i < count; i++)
+            out[i] = audible > 0 ? (float)((i * 7919) % 2001) / 1000.0f - 1.0f : 0.0f;
+        audible = std::max(audible - 1, 0);
+    }
+};
+
+// num_chains source -> filter -> compressor chains summed into a delay bus; silent chains are
+// skipped once the filter tail has passed
+void bench_graph(bench::suite& s, int num_chains, bool silent) {
+    std::vector<bench_source> sources((size_t)num_chains, bench_source{silent ? 1 : INT32_MAX});
+    saudio::graph g;
+    auto* bus = g.add<saudio::gain_node>(0.5f);
+    auto* echo = g.add<saudio::delay_node>(1.0f, 0.2f, 0.0f, 0.3f);
+    g.connect(bus, echo);
+    g.set_output(echo);
+    for (bench_source& src : sources) {
+        auto* in = g.add<saudio::source_node<bench_source>>(src);
+        auto* lp = g.add<saudio::biquad_node>(saudio::biquad_node::type::lowpass, 2000.0f);
+        auto* comp = g.add<saudio::compressor_node>();
+        g.connect(in, lp);
+        g.connect(lp, comp);
+        g.connect(comp, bus);
+    }
+    g.commit();
+    std::vector<float> out((size_t)callback_frames * 2);
+    // let the silent chains run out their tails before timing
+    for (int i = 0; i < 200; i++)
+        g(out.data(), callback_frames, 2);
+    const std::string name = "audio.graph." + std::to_string(num_chains) + "chains." + (silent ? "silent" : "audible");
+    s.run(name, [&] {
+        g(out.data(), callback_frames, 2);
+        do_not_optimize(out[0]);
+    });
+}
+// Ten seconds of a 256-voice mixer rendered through the desc's stream callback
+void bench_offline(bench::suite& s) {
+    const std::string name = "audio.offline.mixer256";
+    std::vector<float> samples(48000);
+    for (size_t i = 0; i < samples.size(); i++)
+        samples[i] = (float)((i * 7919) % 2001) / 1000.0f - 1.0f;
+    const saudio::sound snd = {samples.data(), 48000, 1};
+    saudio::mixer mx;
+    saudio::desc d;
+    d.sample_rate(48000).packet_frames(callback_frames);
+    mx.install(d);
+    saudio::offline_renderer r(d);
+    r.set_capture(false);
+    saudio::mixer::voice_params params;
+    params.loop = true;
+    for (int i = 0; i < 256; i++) {
+        params.start_frame = (i * 997) % 48000;
+        mx.play(snd, params);
+    }
+    r.render_seconds(10.0);
+    s.report(name + ".realtime_factor", r.realtime_factor(), "x", bench::direction::higher_is_better);
+}
+} // namespace
+
+void bench_audio(bench::suite& s) {
+    for (int voices : {64, 256, 1024})
+        bench_mixer(s, voices, 1, 0);
+    bench_mixer(s, 256, 2, 0);
+    bench_mixer(s, 1024, 1, 64);
+    for (int q = 0; q < 4; q++)
+        bench_resampler(s, (saudio::resampler::quality)q);
+    for (int chains : {8, 32}) {
+        bench_graph(s, chains, false);
+        bench_graph(s, chains, true);
+    }
+    bench_offline(s);
+}
@@ -0,0 +1,87 @@
+// Job system: per-job overhead and parallel_for scaling from one to all hardware threads on a
+// culling-style workload (sphere against six frustum planes)
+
+#include "sokol.hpp"
+#include "sokol_jobs.hpp"
+#include "bench.hpp"
+
+using bench::do_not_optimize;
+
+namespace {
+struct sphere {
+    float x, y, z, r;
+};
+
+struct plane {
+    float nx, ny, nz, d;
+};
+
+constexpr size_t num_spheres = 1 << 20;
+
+void cull(const sphere* spheres, const plane* planes, uint8_t* visible, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        const sphere& s = spheres[i];
+        bool inside = true;
+        for (int p = 0; p < 6; p++)
+            inside &= planes[p].nx * s.x + planes[p].ny * s.y + planes[p].nz * s.z + planes[p].d > -s.r;
+        visible[i] = inside;
+    }
+}
+
+void bench_scaling(bench::suite& s, const std::vector<sphere>& spheres, const plane* planes, std::vector<uint8_t>& visible) {
+    const int max_threads = std::max((int)std::thread::hardware_concurrency(), 1);
+    std::vector<int> counts;
+    for (int threads = 1; threads < max_threads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(max_threads);
+    double base_ns = 0.0;
+    for (int threads : counts) {
+        sokol::job_system::config cfg;
+        cfg.num_threads = threads - 1;
+        sokol::job_system js(cfg);
+        js.start();
+        const std::string name = "jobs.cull_1m." + std::to_string(threads) + "t";
+        const size_t before = s.results().size();
+        s.run(name, [&] {
+            js.parallel_for(0, num_spheres, 4096, [&](size_t b, size_t e) { cull(spheres.data(), planes, visible.data(), b, e); });
+            do_not_optimize(visible[0]);
+        });
+        js.stop();
+        if (s.results().size() == before)
+            continue;
+        const double ns = s.results().back().ns_per_op;
+        if (threads == 1)
+            base_ns = ns;
+        else if (base_ns > 0.0)
+            s.report(name + ".speedup", base_ns / ns, "x", bench::direction::higher_is_better);
+    }
+}
+} // namespace
+
+void bench_jobs(bench::suite& s) {
+    std::vector<sphere> spheres(num_spheres);
+    for (size_t i = 0; i < num_spheres; i++) {
+        const float t = (float)i;
+        spheres[i] = {std::sin(t) * 100.0f, std::cos(t * 0.7f) * 100.0f, (float)(i % 200), 1.0f + (float)(i % 5)};
+    }
+    const plane planes[6] = {{1, 0, 0, 50}, {-1, 0, 0, 50}, {0, 1, 0, 50}, {0, -1, 0, 50}, {0, 0, 1, -1}, {0, 0, -1, 150}};
+    std::vector<uint8_t> visible(num_spheres);
+
+    s.run("jobs.cull_1m.serial", [&] {
+        cull(spheres.data(), planes, visible.data(), 0, num_spheres);
+        do_not_optimize(visible[0]);
+    });
+
+    // scheduling cost of one empty job, spawned and waited on in batches
+    sokol::job_system js;
+    js.start();
+    s.run_batch("jobs.run_wait_empty", 256, [&] {
+        sokol::job_system::counter c;
+        for (int i = 0; i < 256; i++)
+            js.run([] {}, &c);
+        js.wait(c);
+    });
+    js.stop();
+
+    bench_scaling(s, spheres, planes, visible);
+}
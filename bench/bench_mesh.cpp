@@ -0,0 +1,111 @@
+// Mesh optimization: time per triangle for each pass of sg::mesh::optimize on a shuffled sphere,
+// and the resulting cache and fetch metrics; time per vertex and error of sg::mesh::quantize
+
+#include "sokol_mesh.hpp"
+#include "bench.hpp"
+
+using bench::do_not_optimize;
+
+namespace {
+struct vertex {
+    float pos[3];
+    float uv[2];
+};
+
+struct full_vertex {
+    float pos[3];
+    float normal[3];
+    float tangent[4];
+    float uv[2];
+    float color[4];
+};
+
+// UV sphere as an unindexed triangle list in random triangle order, the worst case for every pass
+std::vector<vertex> make_sphere(int n) {
+    std::vector<vertex> grid;
+    for (int y = 0; y <= n; y++) {
+        for (int x = 0; x <= n; x++) {
+            float theta = 3.14159265f * (float)y / (float)n, phi = 6.28318531f * (float)x / (float)n;
+            grid.push_back({{std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)},
+                            {(float)x / (float)n, (float)y / (float)n}});
+        }
+    }
+    std::vector<uint32_t> tris;
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+            tris.insert(tris.end(), {a, c, b, b, c, d});
+        }
+    }
+    // fixed-seed Fisher-Yates over triangles so runs are comparable
+    uint32_t seed = 1;
+    for (size_t t = tris.size() / 3 - 1; t > 0; t--) {
+        seed = seed * 1664525u + 1013904223u;
+        size_t other = seed % (t + 1);
+        for (int k = 0; k < 3; k++)
+            std::swap(tris[t * 3 + k], tris[other * 3 + k]);
+    }
+    std::vector<vertex> out;
+    for (uint32_t i : tris)
+        out.push_back(grid[i]);
+    return out;
+}
+} // namespace
+
+void bench_mesh(bench::suite& s) {
+    const std::vector<vertex> sphere = make_sphere(128);
+    const size_t tris = sphere.size() / 3;
+    const struct {
+        const char* name;
+        sg::mesh::cache_algorithm cache;
+        int position_offset;
+    } configs[] = {
+        {"dedup", sg::mesh::cache_algorithm::none, -1},
+        {"tipsify", sg::mesh::cache_algorithm::tipsify, -1},
+        {"tipsify_overdraw", sg::mesh::cache_algorithm::tipsify, 0},
+        {"forsyth", sg::mesh::cache_algorithm::forsyth, -1},
+    };
+    for (const auto& c : configs) {
+        sg::mesh::options opt;
+        opt.cache = c.cache;
+        opt.position_offset = c.position_offset;
+        const std::string name = std::string("mesh.") + c.name;
+        s.run_batch(name + ".per_triangle", tris, [&] {
+            sg::mesh::data m = sg::mesh::optimize(sphere.data(), sphere.size(), sizeof(vertex), nullptr, 0, opt);
+            do_not_optimize(m.vertex_count);
+        });
+        const sg::mesh::data m = sg::mesh::optimize(sphere.data(), sphere.size(), sizeof(vertex), nullptr, 0, opt);
+        s.report(name + ".acmr", m.stats.cache_after.acmr, "acmr", bench::direction::lower_is_better);
+        s.report(name + ".overfetch", m.stats.overfetch_after, "x", bench::direction::lower_is_better);
+        s.report(name + ".bytes_saved_pct", 100.0 * (double)m.stats.bytes_saved() / (double)m.stats.bytes_in, "%", bench::direction::higher_is_better);
+    }
+
+    // a typical float32 vertex into 24 bytes: positions SHORT4N, normals UINT10_N2, tangents
+    // BYTE4N, UVs HALF2, colors UBYTE4N
+    std::vector<full_vertex> full;
+    for (const vertex& v : sphere) {
+        full_vertex f = {};
+        memcpy(f.pos, v.pos, sizeof(f.pos));
+        memcpy(f.normal, v.pos, sizeof(f.normal));
+        f.tangent[0] = -v.pos[2], f.tangent[2] = v.pos[0], f.tangent[3] = 1.0f;
+        memcpy(f.uv, v.uv, sizeof(f.uv));
+        f.color[0] = v.uv[0], f.color[1] = v.uv[1], f.color[2] = 0.5f, f.color[3] = 1.0f;
+        full.push_back(f);
+    }
+    const std::vector<sg::mesh::attribute> attrs = {
+        sg::mesh::attribute::make(0, offsetof(full_vertex, pos), 3, SG_VERTEXFORMAT_SHORT4N),
+        sg::mesh::attribute::make(1, offsetof(full_vertex, normal), 3, SG_VERTEXFORMAT_UINT10_N2),
+        sg::mesh::attribute::make(2, offsetof(full_vertex, tangent), 4, SG_VERTEXFORMAT_BYTE4N, false),
+        sg::mesh::attribute::make(3, offsetof(full_vertex, uv), 2, SG_VERTEXFORMAT_HALF2, false),
+        sg::mesh::attribute::make(4, offsetof(full_vertex, color), 4, SG_VERTEXFORMAT_UBYTE4N, false),
+    };
+    s.run_batch("mesh.quantize.per_vertex", full.size(), [&] {
+        sg::mesh::quantized q = sg::mesh::quantize(full.data(), full.size(), sizeof(full_vertex), attrs);
+        do_not_optimize(q.stride);
+    });
+    const sg::mesh::quantized q = sg::mesh::quantize(full.data(), full.size(), sizeof(full_vertex), attrs);
+    const char* names[] = {"position", "normal", "tangent", "uv", "color"};
+    for (size_t i = 0; i < q.attributes.size(); i++)
+        s.report(std::string("mesh.quantize.") + names[i] + ".max_error_1e6", q.attributes[i].max_error * 1e6, "x 1e-6", bench::direction::lower_is_better);
+    s.report("mesh.quantize.bytes_saved_pct", 100.0 * (double)q.bytes_saved() / (double)q.bytes_in, "%", bench::direction::higher_is_better);
+}
@@ -0,0 +1,200 @@
+// Wrapper overhead: RAII handles, desc builders and trait dispatch against the raw C API
+
+#include "sokol.hpp"
+#include "sokol_gfx_debug.hpp"
+#include "bench.hpp"
+
+using bench::do_not_optimize;
+
+namespace {
+const float vertices[] = {
+    0.0f, 0.5f, 0.5f,
+    0.5f, -0.5f, 0.5f,
+    -0.5f, -0.5f, 0.5f,
+};
+
+// Filled-in builders, one per desc type, shared by the build and copy benchmarks
+sg::buffer_desc make_buffer_desc() {
+    return sg::buffer_desc::make_vertex_with_data(vertices, sizeof(vertices));
+}
+
+sg::image_desc make_image_desc() {
+    sg::image_desc desc = sg::image_desc::make_texture_2d(64, 64);
+    desc.num_mipmaps(1).label("bench");
+    return desc;
+}
+
+sg::sampler_desc make_sampler_desc() {
+    return sg::sampler_desc::make_linear_clamp();
+}
+
+sg::shader_desc make_shader_desc() {
+    sg::shader_desc desc;
+    desc.vertex_func_source("void main() {}")
+        .fragment_func_source("void main() {}")
+        .attr_base_type(0, SG_SHADERATTRBASETYPE_FLOAT)
+        .uniform_block_stage(0, SG_SHADERSTAGE_VERTEX)
+        .uniform_block_size(0, 64)
+        .view_texture_stage(0, SG_SHADERSTAGE_FRAGMENT)
+        .sampler_stage(0, SG_SHADERSTAGE_FRAGMENT)
+        .texture_sampler_pair_stage(0, SG_SHADERSTAGE_FRAGMENT)
+        .texture_sampler_pair_view_slot(0, 0)
+        .texture_sampler_pair_sampler_slot(0, 0)
+        .label("bench");
+    return desc;
+}
+
+sg::pipeline_desc make_pipeline_desc(sg_shader shd) {
+    sg::pipeline_desc desc;
+    desc.shader_id(shd.id)
+        .layout_attr_format(0, SG_VERTEXFORMAT_FLOAT3)
+        .layout_buffer_stride(0, 12)
+        .index_type(SG_INDEXTYPE_UINT16)
+        .depth_write_enabled(true)
+        .color_count(1)
+        .label("bench");
+    return desc;
+}
+
+sg::view_desc make_view_desc(sg_image img) {
+    sg::view_desc desc;
+    desc.texture_image_id(img.id).label("bench");
+    return desc;
+}
+
+sg::desc make_sg_desc() {
+    sg::desc desc;
+    desc.buffer_pool_size(256)
+        .image_pool_size(256)
+        .disable_validation(true)
+        .logger_func(slog_func);
+    return desc;
+}
+
+#ifndef SOKOL_NO_SAPP
+sapp::desc make_sapp_desc() {
+    sapp::desc desc;
+    desc.width(1280)
+        .height(720)
+        .sample_count(4)
+        .high_dpi(true)
+        .window_title("bench");
+    return desc;
+}
+#endif
+
+#ifndef SOKOL_NO_SAUDIO
+saudio::desc make_saudio_desc() {
+    saudio::desc desc;
+    desc.sample_rate(48000)
+        .num_channels(2)
+        .buffer_frames(2048)
+        .packet_frames(128)
+        .num_packets(64);
+    return desc;
+}
+#endif
+
+// builder vs. plain C struct: construction and copy
+template <typename Builder, typename Make>
+void bench_desc(bench::suite& s, const std::string& name, Make&& make) {
+    using c_type = std::decay_t<decltype(make().get())>;
+    s.run("desc." + name + ".build", [&] { Builder d = make(); do_not_optimize(d); });
+    const Builder proto = make();
+    s.run("desc." + name + ".copy_builder", [&] { Builder d = proto; do_not_optimize(d); });
+    s.run("desc." + name + ".copy_c", [&] { c_type d = proto.get(); do_not_optimize(d); });
+}
+
+template <typename Desc, typename Handle>
+void bench_handle(bench::suite& s, const std::string& name, const Desc& desc) {
+    using traits = sg::sg_type_traits<Desc>;
+    s.run("handle." + name + ".c", [&] {
+        Handle h = traits::make(&desc);
+        do_not_optimize(h);
+        traits::destroy(h);
+    });
+    s.run("handle." + name + ".ptr", [&] {
+        gen::sg::helper::ptr<Handle> h = traits::make(&desc);
+        do_not_optimize(h);
+    });
+}
+} // namespace
+
+void bench_wrapper(bench::suite& s) {
+    sg::buffer_desc buf_desc = make_buffer_desc();
+    sg::image_desc img_desc = make_image_desc();
+    sg::sampler_desc smp_desc = make_sampler_desc();
+    sg::shader_desc shd_desc = make_shader_desc();
+    sg::buffer keep_buf = buf_desc.build();
+    sg::image keep_img = img_desc.build();
+    sg::shader keep_shd = shd_desc.build();
+    sg::pipeline_desc pip_desc = make_pipeline_desc(keep_shd);
+    sg::view_desc vdesc = make_view_desc(keep_img);
+
+    // desc construction and copying
+    bench_desc<sg::buffer_desc>(s, "buffer", make_buffer_desc);
+    bench_desc<sg::image_desc>(s, "image", make_image_desc);
+    bench_desc<sg::sampler_desc>(s, "sampler", make_sampler_desc);
+    bench_desc<sg::shader_desc>(s, "shader", make_shader_desc);
+    bench_desc<sg::pipeline_desc>(s, "pipeline", [&] { return make_pipeline_desc(keep_shd); });
+    bench_desc<sg::view_desc>(s, "view", [&] { return make_view_desc(keep_img); });
+    bench_desc<sg::desc>(s, "sg", make_sg_desc);
+#ifndef SOKOL_NO_SAPP
+    bench_desc<sapp::desc>(s, "sapp", make_sapp_desc);
+#endif
+#ifndef SOKOL_NO_SAUDIO
+    bench_desc<saudio::desc>(s, "saudio", make_saudio_desc);
+#endif
+    s.run("desc.buffer.c_designated", [&] {
+        sg_buffer_desc d = {};
+        d.size = sizeof(vertices);
+        d.usage.vertex_buffer = true;
+        d.usage.immutable = true;
+        d.data.ptr = vertices;
+        d.data.size = sizeof(vertices);
+        do_not_optimize(d);
+    });
+
+    // handle create/destroy, raw C vs. RAII helper::ptr
+    bench_handle<sg_buffer_desc, sg_buffer>(s, "buffer", buf_desc.get());
+    bench_handle<sg_image_desc, sg_image>(s, "image", img_desc.get());
+    bench_handle<sg_sampler_desc, sg_sampler>(s, "sampler", smp_desc.get());
+    bench_handle<sg_shader_desc, sg_shader>(s, "shader", shd_desc.get());
+    bench_handle<sg_pipeline_desc, sg_pipeline>(s, "pipeline", pip_desc.get());
+    bench_handle<sg_view_desc, sg_view>(s, "view", vdesc.get());
+    s.run("handle.buffer.builder_build", [&] {
+        sg::buffer h = buf_desc.build();
+        do_not_optimize(h);
+    });
+
+    // trait-dispatched calls vs. direct C calls
+    const sg_buffer raw_buf = keep_buf;
+    s.run("dispatch.make_destroy.c", [&] {
+        sg_buffer h = sg_make_buffer(&buf_desc.get());
+        do_not_optimize(h);
+        sg_destroy_buffer(h);
+    });
+    s.run("dispatch.make_destroy.traits", [&] {
+        using traits = sg::sg_type_traits<sg_buffer_desc>;
+        sg_buffer h = traits::make(&buf_desc.get());
+        do_not_optimize(h);
+        traits::destroy(h);
+    });
+    s.run("dispatch.query_state.c", [&] { do_not_optimize(sg_query_buffer_state(raw_buf)); });
+    s.run("dispatch.query_state.traits", [&] { do_not_optimize(sg::sg_type_traits<sg_buffer_desc>::query_state(raw_buf)); });
+    s.run("dispatch.query_state.ptr", [&] { do_not_optimize(keep_buf.state()); });
+    s.run("dispatch.is_valid.ptr", [&] { do_not_optimize(keep_buf.is_valid()); });
+    s.run("dispatch.get.ptr", [&] { do_not_optimize(keep_buf.get()); });
+    s.run("dispatch.query_desc.c", [&] { do_not_optimize(sg_query_buffer_desc(raw_buf)); });
+    s.run("dispatch.query_desc.traits", [&] { do_not_optimize(sg::sg_type_traits<sg_buffer_desc>::query_desc(raw_buf)); });
+
+    // pipeline_checker: full shader/pipeline validation at creation, cached pass check per apply
+    s.run("validate.shader_pipeline", [&] { do_not_optimize(sg::validate(shd_desc.get(), pip_desc.get())); });
+    {
+        sg::pipeline_checker checker;
+        checker.track(shd_desc.get(), keep_shd);
+        sg::pipeline pip = sg::sg_type_traits<sg_pipeline_desc>::make(&pip_desc.get());
+        const sg::pass_layout pass = sg::pass_layout().color(0, SG_PIXELFORMAT_RGBA8).depth(SG_PIXELFORMAT_DEPTH_STENCIL);
+        s.run("validate.check_pass.cached", [&] { do_not_optimize(checker.check_pass(pip, pass)); });
+    }
+}
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+"""
+Compare two sokol_hpp_bench JSON reports.
+
+    compare.py baseline.json current.json [--threshold PERCENT]
+
+Exits with status 1 if any benchmark got worse than the threshold: timings regress when they
+go up, values recorded with higher_is_better (throughput, speedups, SNR, ...) when they go down.
+"""
+import argparse
+import json
+import sys
+
+def load(path):
+    with open(path, 'r') as f:
+        data = json.load(f)
+    return {b['name']: b for b in data['benchmarks']}
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare sokol_hpp_bench JSON reports')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='allowed regression in percent (default: 10)')
+    parser.add_argument('--metric', default='ns_per_op', choices=['ns_per_op', 'min_ns_per_op'],
+                        help='field to compare (default: ns_per_op)')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = []
+    print(f'{"benchmark":<60} {"baseline":>12} {"current":>12} {"delta":>9}')
+    for name, cur in current.items():
+        base = baseline.get(name)
+        if base is None:
+            print(f'{name:<60} {"-":>12} {cur[args.metric]:>12.2f} {"new":>9}')
+            continue
+        old, new = base[args.metric], cur[args.metric]
+        delta = (new - old) / old * 100.0 if old > 0 else 0.0
+        # reports from version 1 files carry no direction and compare like timings
+        worse = -delta if cur.get('higher_is_better', False) else delta
+        flag = ''
+        if worse > args.threshold:
+            flag = '  <-- regression'
+            regressions.append(name)
+        print(f'{name:<60} {old:>12.2f} {new:>12.2f} {delta:>+8.1f}%{flag}')
+    for name in baseline:
+        if name not in current:
+            print(f'{name:<60} {baseline[name][args.metric]:>12.2f} {"-":>12} {"removed":>9}')
+
+    if regressions:
+        print(f'\n{len(regressions)} benchmark(s) regressed by more than {args.threshold}%')
+        return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+Compile-time benchmark for the sokol.hpp headers over a synthetic many-TU project.
+
+    compile_time.py [--sokol-dir DIR] [--tus N] [--jobs N] [--cxx CXX] [--json FILE]
+
+Generates N translation units that use the gfx wrappers (every fourth one also uses
+saudio) and compiles them, without linking, in four configurations:
+
+    umbrella   every TU includes sokol.hpp
+    modules    every TU includes only the sokol_<module>.hpp headers it uses
+    pch        every TU includes sokol.hpp through a precompiled header (built once, counted)
+    extern     umbrella with SOKOL_HPP_EXTERN_TEMPLATES, plus one SOKOL_HPP_INSTANTIATE TU
+
+The JSON report uses the sokol_hpp_bench format, so two runs can be compared with
+bench/compare.py. Times are milliseconds and object sizes KiB, stored in the ns_per_op field.
+"""
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+
+TU = """{includes}
+#include <cstdint>
+
+namespace tu{index} {{
+const float vertices[] = {{ 0.0f, 0.5f, 0.5f, 0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f }};
+}}
+
+uint32_t tu{index}_gfx(sg_shader shd) {{
+    sg::buffer buf = sg::buffer_desc::make_vertex_with_data(tu{index}::vertices, sizeof(tu{index}::vertices)).build();
+    sg::image img = sg::image_desc::make_texture_2d(64, 64).label("tu{index}").build();
+    sg::pipeline_desc desc;
+    desc.shader_id(shd.id)
+        .layout_attr_format(0, SG_VERTEXFORMAT_FLOAT3)
+        .index_type(SG_INDEXTYPE_UINT16)
+        .color_count(1);
+    sg::pipeline pip = desc.build();
+    return buf.id() + img.id() + pip.id();
+}}
+{audio}"""
+
+TU_AUDIO = """
+int tu{index}_audio() {{
+    saudio::desc desc;
+    desc.sample_rate(48000).num_channels(2).buffer_frames(2048);
+    return desc.get().sample_rate;
+}}
+"""
+
+def write_project(out_dir, tus, modular):
+    sources = []
+    for i in range(tus):
+        audio = i % 4 == 0
+        if modular:
+            includes = '#include "sokol_gfx.hpp"' + ('\n#include "sokol_audio.hpp"' if audio else '')
+        else:
+            includes = '#include "sokol.hpp"'
+        path = os.path.join(out_dir, f'tu{i}.cpp')
+        with open(path, 'w') as f:
+            f.write(TU.format(includes=includes, index=i, audio=TU_AUDIO.format(index=i) if audio else ''))
+        sources.append(path)
+    return sources
+
+def compile_one(cmd):
+    start = time.perf_counter()
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    elapsed = time.perf_counter() - start
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout.decode(errors='replace'))
+        raise SystemExit(f'compile failed: {" ".join(cmd)}')
+    return elapsed
+
+def compile_all(cxx, flags, sources, jobs):
+    cmds = [[cxx] + flags + ['-c', src, '-o', src + '.o'] for src in sources]
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        per_tu = list(pool.map(compile_one, cmds))
+    wall = time.perf_counter() - start
+    return wall, sum(per_tu), sum(os.path.getsize(src + '.o') for src in sources)
+
+def is_clang(cxx):
+    out = subprocess.run([cxx, '--version'], stdout=subprocess.PIPE).stdout.decode(errors='replace')
+    return 'clang' in out
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile-time benchmark for the sokol.hpp headers')
+    parser.add_argument('--sokol-dir', default=os.path.join(ROOT, '..', 'sokol'),
+                        help='directory containing the sokol C headers (default: ../sokol)')
+    parser.add_argument('--tus', type=int, default=64, help='number of translation units (default: 64)')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1, help='parallel compiles (default: all cores)')
+    parser.add_argument('--cxx', default=os.environ.get('CXX', 'c++'), help='C++ compiler (default: $CXX or c++)')
+    parser.add_argument('--flags', default='-O0', help='extra compiler flags (default: -O0)')
+    parser.add_argument('--json', help='write a report in the sokol_hpp_bench JSON format')
+    parser.add_argument('--keep', action='store_true', help='keep the generated project')
+    args = parser.parse_args()
+
+    if not os.path.exists(os.path.join(args.sokol_dir, 'sokol_gfx.h')):
+        raise SystemExit(f'sokol headers not found in {args.sokol_dir}, pass --sokol-dir')
+
+    work = tempfile.mkdtemp(prefix='sokol_hpp_compile_')
+    base = ['-std=c++17', '-I' + ROOT, '-I' + args.sokol_dir] + args.flags.split()
+    results = []
+
+    def record(name, wall, cpu, size):
+        results.append((name, wall, cpu, size))
+        print(f'{name:<12} {wall * 1000.0:10.1f} ms wall {cpu * 1000.0 / args.tus:10.1f} ms/TU '
+              f'{size / 1024.0:10.1f} KiB objects', flush=True)
+
+    try:
+        print(f'{args.tus} TUs, {args.jobs} jobs, {args.cxx} {args.flags}')
+        umbrella_dir = os.path.join(work, 'umbrella')
+        modules_dir = os.path.join(work, 'modules')
+        os.makedirs(umbrella_dir)
+        os.makedirs(modules_dir)
+        umbrella = write_project(umbrella_dir, args.tus, False)
+        modules = write_project(modules_dir, args.tus, True)
+
+        record('umbrella', *compile_all(args.cxx, base, umbrella, args.jobs))
+        record('modules', *compile_all(args.cxx, base, modules, args.jobs))
+
+        # the PCH must be built with the same flags as the TUs that use it
+        pch_dir = os.path.join(work, 'pch')
+        os.makedirs(pch_dir)
+        pch_header = os.path.join(pch_dir, 'sokol_pch.hpp')
+        with open(pch_header, 'w') as f:
+            f.write('#include "sokol.hpp"\n')
+        start = time.perf_counter()
+        if is_clang(args.cxx):
+            pch_out = pch_header + '.pch'
+            compile_one([args.cxx] + base + ['-x', 'c++-header', pch_header, '-o', pch_out])
+            pch_flags = ['-include-pch', pch_out]
+        else:
+            compile_one([args.cxx] + base + ['-x', 'c++-header', pch_header, '-o', pch_header + '.gch'])
+            pch_flags = ['-include', pch_header]
+        pch_build = time.perf_counter() - start
+        wall, cpu, size = compile_all(args.cxx, base + pch_flags, umbrella, args.jobs)
+        record('pch', wall + pch_build, cpu + pch_build, size)
+
+        inst = os.path.join(umbrella_dir, 'sokol_instances.cpp')
+        with open(inst, 'w') as f:
+            f.write('#define SOKOL_HPP_INSTANTIATE\n#include "sokol.hpp"\n')
+        wall, cpu, size = compile_all(args.cxx, base + ['-DSOKOL_HPP_EXTERN_TEMPLATES'], umbrella, args.jobs)
+        inst_time = compile_one([args.cxx] + base + ['-c', inst, '-o', inst + '.o'])
+        record('extern', wall + inst_time, cpu + inst_time, size + os.path.getsize(inst + '.o'))
+    finally:
+        if args.keep:
+            print(f'project kept in {work}')
+        else:
+            shutil.rmtree(work, ignore_errors=True)
+
+    if args.json:
+        benchmarks = []
+        for name, wall, cpu, size in results:
+            for metric, value in (('wall_ms', wall * 1000.0), ('per_tu_ms', cpu * 1000.0 / args.tus),
+                                  ('object_kib', size / 1024.0)):
+                benchmarks.append({'name': f'compile.{name}.{metric}', 'ns_per_op': value,
+                                   'min_ns_per_op': value, 'iterations': args.tus, 'samples': 1})
+        report = {'version': 1, 'context': {'compiler': args.cxx, 'build_type': args.flags},
+                  'benchmarks': benchmarks}
+        with open(args.json, 'w') as f:
+            json.dump(report, f, indent=2)
+
+if __name__ == '__main__':
+    main()
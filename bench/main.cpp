@@ -0,0 +1,69 @@
+// sokol_hpp_bench -- microbenchmarks for the sokol.hpp wrapper layer
+//
+// usage: sokol_hpp_bench [--json FILE] [--filter SUBSTR] [--min-time MS]
+//
+// Compare two JSON reports with bench/compare.py to catch regressions.
+
+#include "sokol.hpp"
+#include "bench.hpp"
+#include <cstdlib>
+
+void bench_wrapper(bench::suite& s);
+void bench_alloc(bench::suite& s);
+void bench_audio(bench::suite& s);
+void bench_jobs(bench::suite& s);
+void bench_mesh(bench::suite& s);
+
+#ifdef NDEBUG
+#define BENCH_BUILD_TYPE "release"
+#else
+#define BENCH_BUILD_TYPE "debug"
+#endif
+
+int main(int argc, char* argv[]) {
+    const char* json_path = nullptr;
+    const char* filter = nullptr;
+    double min_time_ms = 20.0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json") && i + 1 < argc)
+            json_path = argv[++i];
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+            filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc)
+            min_time_ms = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--json FILE] [--filter SUBSTR] [--min-time MS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    stm_setup();
+    sg_setup(&sg::desc()
+        .disable_validation(true)
+        .buffer_pool_size(1024)
+        .image_pool_size(1024)
+        .view_pool_size(1024)
+        .logger_func(slog_func));
+    if (sg_query_backend() != SG_BACKEND_DUMMY)
+        fprintf(stderr, "warning: sokol_gfx is not using the dummy backend\n");
+
+    bench::suite s(min_time_ms, filter);
+    bench_wrapper(s);
+    bench_alloc(s);
+    bench_audio(s);
+    bench_jobs(s);
+    bench_mesh(s);
+
+    sg_shutdown();
+
+    if (json_path) {
+        FILE* out = fopen(json_path, "w");
+        if (!out) {
+            fprintf(stderr, "failed to open %s\n", json_path);
+            return 1;
+        }
+        s.write_json(out, BENCH_BUILD_TYPE);
+        fclose(out);
+    }
+    return 0;
+}
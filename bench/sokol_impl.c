@@ -0,0 +1,6 @@
+// sokol implementations for sokol_hpp_bench and the tests, SOKOL_DUMMY_BACKEND is set by CMakeLists.txt
+#define SOKOL_IMPL
+#include "sokol_log.h"
+#include "sokol_gfx.h"
+#include "sokol_time.h"
+#include "sokol_audio.h"
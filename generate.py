@@ -1,20 +1,128 @@
 #!/usr/bin/env python3
 """
-Generate sokol.hpp using the sokol bindgen framework.
+Generate the sokol.hpp builder fragments using the sokol bindgen framework.
 
-This script runs the C++ code generator to create sokol.hpp from the sokol headers.
+This script runs the C++ code generator over the sokol headers and splits its output
+into one fragment per module, so each sokol_<module>.hpp only pulls in what it wraps:
+
+    sokol_core.inl   helper::desc<T> and the extern template switch
+    sokol_log.inl    sokol_gfx.inl    sokol_app.inl    sokol_time.inl    sokol_audio.inl
+
+    generate.py                   run bindgen, then split
+    generate.py --split FILE      split an existing single-file generator output
 """
 import sys
 import os
+import re
 
 # Add sokol/bindgen to Python path
 sokol_bindgen_path = os.path.join(os.path.dirname(__file__), '..', 'sokol', 'bindgen')
 sys.path.insert(0, sokol_bindgen_path)
 
-import gen_cpp
+def fixup(path):
+    """Patch up generator output that does not compile as C++"""
+    with open(path, 'r') as f:
+        src = f.read()
+    # 'void (*)(void) value' -> 'void (*value)(void)'
+    src = re.sub(r'\(([^()]*?)\(\*\)\(([^()]*)\) value\)', r'(\1(*value)(\2))', src)
+    # sapp/saudio builders derive from the helper::desc template that lives in sg
+    for ns in ('sapp', 'saudio'):
+        src = src.replace(f'namespace {ns} {{\n', f'namespace {ns} {{\nnamespace helper = sg::helper;\n', 1)
+    with open(path, 'w') as f:
+        f.write(src)
+
+# fragment, C header include guard, disable macro
+MODULES = [
+    ('sokol_log.inl',   'SOKOL_LOG_INCLUDED',   'SOKOL_NO_SLOG'),
+    ('sokol_gfx.inl',   'SOKOL_GFX_INCLUDED',   'SOKOL_NO_SG'),
+    ('sokol_app.inl',   'SOKOL_APP_INCLUDED',   'SOKOL_NO_SAPP'),
+    ('sokol_time.inl',  'SOKOL_TIME_INCLUDED',  'SOKOL_NO_STM'),
+    ('sokol_audio.inl', 'SOKOL_AUDIO_INCLUDED', 'SOKOL_NO_SAUDIO'),
+]
+
+PREAMBLE = """// Machine generated C++ wrapper for Sokol library.
+// https://github.com/takeiteasy/sokol.hpp
+//
+// Do not edit manually; regenerate using generate.py.
+
+#pragma once
+#include <utility>
+#include <memory>
+"""
+
+# SOKOL_HPP_EXTERN_TEMPLATES turns the instantiation lists below into extern template
+# declarations; exactly one translation unit defines SOKOL_HPP_INSTANTIATE to provide them
+CORE_EXTERN = """
+#if defined(SOKOL_HPP_INSTANTIATE)
+#define SOKOL_HPP_EXTERN
+#elif defined(SOKOL_HPP_EXTERN_TEMPLATES)
+#define SOKOL_HPP_EXTERN extern
+#endif
+"""
+
+def report_lifetimes(gfx):
+    """Route builder builds and helper::ptr destruction through the sg::helper lifetime hooks
+    (declared in sokol_gfx.hpp ahead of the fragment), like sg_type_traits does"""
+    gfx = re.sub(r'\n(\s+)return sg_make_(\w+)\(&desc_\);',
+                 r'\n\1sg_\2 handle = sg_make_\2(&desc_);\n\1::sg::helper::on_make(&desc_, handle);\n\1return handle;', gfx)
+    return gfx.replace('        if (handle_ptr && handle_ptr->id != 0) {\n',
+                       '        if (handle_ptr && handle_ptr->id != 0) {\n            ::sg::helper::on_destroy(*handle_ptr);\n', 1)
+
+def instantiations(types, prefix=''):
+    lines = [f'SOKOL_HPP_EXTERN template class {prefix}helper::{t};' for t in types]
+    return '#ifdef SOKOL_HPP_EXTERN\n' + '\n'.join(lines) + '\n#endif\n'
+
+def split(path, out_dir):
+    """Split single-file generator output into the per-module fragments"""
+    with open(path, 'r') as f:
+        src = f.read()
+    blocks = {}
+    for fragment, guard, macro in MODULES:
+        begin = src.index(f'#ifndef {guard}\n')
+        end_marker = f'#endif // {macro}\n'
+        end = src.index(end_marker, begin) + len(end_marker)
+        blocks[fragment] = src[begin:end]
+
+    # helper::desc<T> is shared by the sg, sapp and saudio builders, so it lives in the core
+    # fragment and works without sokol_gfx.h
+    gfx = blocks['sokol_gfx.inl']
+    m = re.search(r'\ntemplate<typename T>\nclass desc \{.*?\n\};\n', gfx, re.S)
+    desc_template = m.group(0).strip('\n')
+    gfx = gfx[:m.start()] + '\n' + gfx[m.end():]
+    gfx = re.sub(r'\n\n+\} // namespace helper', '\n} // namespace helper', gfx, count=1)
+    gfx = report_lifetimes(gfx)
+
+    # explicit instantiations for helper::ptr and the helper::desc bases of every builder
+    handles = re.findall(r'using \w+ = helper::ptr<(\w+)>;', gfx)
+    descs = re.findall(r'public helper::desc<(\w+)>', gfx)
+    gfx = gfx.replace('} // namespace helper\n',
+                      '} // namespace helper\n' +
+                      instantiations([f'ptr<{t}>' for t in handles] + [f'desc<{t}>' for t in descs]), 1)
+    blocks['sokol_gfx.inl'] = gfx
+    for fragment, ns in (('sokol_app.inl', 'sapp'), ('sokol_audio.inl', 'saudio')):
+        block = blocks[fragment]
+        descs = re.findall(r'public helper::desc<(\w+)>', block)
+        if descs:
+            block = block.replace(f'namespace {ns} {{\n',
+                                  instantiations([f'desc<{t}>' for t in descs], 'sg::') + f'namespace {ns} {{\n', 1)
+        blocks[fragment] = block
+
+    core = PREAMBLE + CORE_EXTERN + '\nnamespace sg {\nnamespace helper {\n' + desc_template + \
+        '\n} // namespace helper\n} // namespace sg\n'
+    with open(os.path.join(out_dir, 'sokol_core.inl'), 'w') as f:
+        f.write(core)
+    for fragment, block in blocks.items():
+        with open(os.path.join(out_dir, fragment), 'w') as f:
+            f.write(PREAMBLE + '\n' + block)
+        print(f'  {fragment}: {block.count(chr(10))} lines')
 
 def main():
-    """Generate sokol.hpp from sokol headers"""
+    """Generate the sokol.hpp fragments from sokol headers"""
+    if len(sys.argv) == 3 and sys.argv[1] == '--split':
+        split(sys.argv[2], os.path.dirname(os.path.abspath(__file__)))
+        return
+
+    import gen_cpp
 
     # Change to bindgen directory for relative paths to work
     original_dir = os.getcwd()
@@ -30,11 +138,10 @@ def main():
             ['../sokol_audio.h',  'saudio_', []],
         ]
 
-        # Output path
+        # Single-file generator output, split into fragments afterwards
         output_path = os.path.join(original_dir, 'sokol.inl')
 
         print(f'Generating sokol.inl...')
-        print(f'Output: {output_path}')
         print()
 
         # Run generator
@@ -50,14 +157,12 @@ def main():
                 traceback.print_exc()
 
         gen_cpp.finalize(output_path)
+        fixup(output_path)
 
         print()
-        print(f'Successfully generated {output_path}')
-
-        # Show stats
-        with open(output_path, 'r') as f:
-            lines = len(f.readlines())
-        print(f'Generated {lines} lines of code')
+        print(f'Splitting {output_path}')
+        split(output_path, original_dir)
+        os.remove(output_path)
 
     finally:
         # Restore original directory
@@ -0,0 +1,366 @@
+/* sokol_alloc.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+// Allocators for the sokol allocator hooks: sokol::allocator, a TLSF allocator, an arena and
+// a tracking wrapper. Not part of the sokol.hpp umbrella
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace sokol {
+// Allocator hooks in the shape of sg_allocator / saudio_allocator
+struct allocator {
+    void* (*alloc_fn)(size_t size, void* user_data) = nullptr;
+    void (*free_fn)(void* ptr, void* user_data) = nullptr;
+    void* user_data = nullptr;
+
+    void* alloc(size_t size) const { return alloc_fn ? alloc_fn(size, user_data) : ::malloc(size); }
+    void free(void* ptr) const {
+        if (free_fn)
+            free_fn(ptr, user_data);
+        else
+            ::free(ptr);
+    }
+
+    // Set the allocator of any desc builder with allocator_* setters (sg::desc, saudio::desc)
+    template <typename Desc>
+    Desc& install(Desc& desc) const {
+        desc.allocator_alloc_fn(alloc_fn).allocator_free_fn(free_fn).allocator_user_data(user_data);
+        return desc;
+    }
+};
+
+namespace helper {
+inline int fls(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    return _BitScanReverse64(&index, x) ? (int)index : -1;
+#else
+    return x ? 63 - __builtin_clzll(x) : -1;
+#endif
+}
+
+inline int ffs(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    return _BitScanForward64(&index, x) ? (int)index : -1;
+#else
+    return x ? __builtin_ctzll(x) : -1;
+#endif
+}
+} // namespace helper
+
+// Two-level segregated fit allocator over a caller-provided region: O(1) alloc and
+// free with immediate coalescing and bounded fragmentation. Not thread-safe.
+class tlsf_allocator {
+public:
+    static constexpr size_t align = 16;
+
+    tlsf_allocator(void* memory, size_t size) { init(memory, size); }
+    explicit tlsf_allocator(size_t size) : owned_(new unsigned char[size + align]) {
+        init(owned_.get(), size + align);
+    }
+    tlsf_allocator(const tlsf_allocator&) = delete;
+    tlsf_allocator& operator=(const tlsf_allocator&) = delete;
+
+    static void* alloc(size_t size, void* user_data) { return ((tlsf_allocator*)user_data)->malloc(size); }
+    static void free(void* ptr, void* user_data) { ((tlsf_allocator*)user_data)->release(ptr); }
+    allocator get() { return {alloc, free, this}; }
+
+    void* malloc(size_t size) {
+        if (size == 0 || size > max_alloc)
+            return nullptr;
+        size = adjust(size);
+        int fl, sl;
+        mapping_search(size, fl, sl);
+        block* b = find_suitable(fl, sl);
+        if (!b)
+            return nullptr;
+        remove_free(b);
+        split(b, size);
+        b->set_free(false);
+        used_ += b->size();
+        return b->payload();
+    }
+
+    void release(void* ptr) {
+        if (!ptr)
+            return;
+        block* b = block::from_payload(ptr);
+        used_ -= b->size();
+        b->set_free(true);
+        block* prev = b->prev_phys;
+        if (prev && prev->is_free()) {
+            remove_free(prev);
+            b = merge(prev, b);
+        }
+        block* next = b->next_phys();
+        if (next->is_free()) {
+            remove_free(next);
+            b = merge(b, next);
+        }
+        insert_free(b);
+    }
+
+    size_t used_bytes() const { return used_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr int align_shift = 4;
+    static constexpr int sl_bits = 5;
+    static constexpr int sl_count = 1 << sl_bits;
+    static constexpr int fl_shift = sl_bits + align_shift;
+    static constexpr size_t small_block = (size_t)1 << fl_shift;
+    static constexpr int fl_max = 40;
+    static constexpr int fl_count = fl_max - fl_shift + 1;
+    static constexpr size_t max_alloc = ((size_t)1 << fl_max) - 1;
+
+    struct block {
+        block* prev_phys;
+        size_t size_flags;  // payload size, bit 0 set when free
+        block* next_free;   // free list links overlap the payload
+        block* prev_free;
+
+        static constexpr size_t header = 2 * sizeof(void*) > 16 ? 2 * sizeof(void*) : 16;
+
+        size_t size() const { return size_flags & ~(size_t)1; }
+        void set_size(size_t s) { size_flags = s | (size_flags & 1); }
+        bool is_free() const { return size_flags & 1; }
+        void set_free(bool f) { size_flags = f ? (size_flags | 1) : (size_flags & ~(size_t)1); }
+        void* payload() { return (unsigned char*)this + header; }
+        block* next_phys() { return (block*)((unsigned char*)payload() + size()); }
+        static block* from_payload(void* ptr) { return (block*)((unsigned char*)ptr - header); }
+    };
+
+    static size_t adjust(size_t size) {
+        size = (size + align - 1) & ~(align - 1);
+        return size < 2 * sizeof(void*) ? align : size;
+    }
+
+    static void mapping(size_t size, int& fl, int& sl) {
+        if (size < small_block) {
+            fl = 0;
+            sl = (int)(size >> align_shift);
+        } else {
+            int f = helper::fls(size);
+            sl = (int)(size >> (f - sl_bits)) ^ sl_count;
+            fl = f - (fl_shift - 1);
+        }
+    }
+
+    // Round up so any block in the found list is large enough
+    static void mapping_search(size_t size, int& fl, int& sl) {
+        if (size >= small_block)
+            size += ((size_t)1 << (helper::fls(size) - sl_bits)) - 1;
+        mapping(size, fl, sl);
+    }
+
+    block* find_suitable(int fl, int sl) {
+        if (fl >= fl_count)
+            return nullptr;
+        uint32_t sl_map = sl_bitmap_[fl] & (~0u << sl);
+        if (!sl_map) {
+            uint64_t fl_map = fl + 1 < 64 ? fl_bitmap_ & (~0ull << (fl + 1)) : 0;
+            if (!fl_map)
+                return nullptr;
+            fl = helper::ffs(fl_map);
+            sl_map = sl_bitmap_[fl];
+        }
+        sl = helper::ffs(sl_map);
+        return free_[fl][sl];
+    }
+
+    void insert_free(block* b) {
+        int fl, sl;
+        mapping(b->size(), fl, sl);
+        b->prev_free = nullptr;
+        b->next_free = free_[fl][sl];
+        if (b->next_free)
+            b->next_free->prev_free = b;
+        free_[fl][sl] = b;
+        fl_bitmap_ |= 1ull << fl;
+        sl_bitmap_[fl] |= 1u << sl;
+    }
+
+    void remove_free(block* b) {
+        int fl, sl;
+        mapping(b->size(), fl, sl);
+        if (b->prev_free)
+            b->prev_free->next_free = b->next_free;
+        else
+            free_[fl][sl] = b->next_free;
+        if (b->next_free)
+            b->next_free->prev_free = b->prev_free;
+        if (!free_[fl][sl]) {
+            sl_bitmap_[fl] &= ~(1u << sl);
+            if (!sl_bitmap_[fl])
+                fl_bitmap_ &= ~(1ull << fl);
+        }
+    }
+
+    // Give the tail of a free block back to the free lists if it is large enough
+    void split(block* b, size_t size) {
+        if (b->size() < size + block::header + align)
+            return;
+        block* rest = (block*)((unsigned char*)b->payload() + size);
+        rest->prev_phys = b;
+        rest->size_flags = (b->size() - size - block::header) | 1;
+        b->set_size(size);
+        rest->next_phys()->prev_phys = rest;
+        insert_free(rest);
+    }
+
+    block* merge(block* a, block* b) {
+        a->set_size(a->size() + block::header + b->size());
+        a->next_phys()->prev_phys = a;
+        return a;
+    }
+
+    void init(void* memory, size_t size) {
+        uintptr_t start = ((uintptr_t)memory + align - 1) & ~(uintptr_t)(align - 1);
+        size_t usable = size - (size_t)(start - (uintptr_t)memory);
+        usable &= ~(align - 1);
+        // one free block spanning the region, followed by a used zero-size sentinel
+        block* b = (block*)start;
+        b->prev_phys = nullptr;
+        b->size_flags = (usable - 2 * block::header) | 1;
+        block* sentinel = b->next_phys();
+        sentinel->prev_phys = b;
+        sentinel->size_flags = 0;
+        capacity_ = b->size();
+        insert_free(b);
+    }
+
+    std::unique_ptr<unsigned char[]> owned_;
+    uint64_t fl_bitmap_ = 0;
+    uint32_t sl_bitmap_[fl_count] = {};
+    block* free_[fl_count][sl_count] = {};
+    size_t used_ = 0;
+    size_t capacity_ = 0;
+};
+
+// Bump allocator for allocations that live until shutdown (e.g. sokol pools at setup).
+// free() is a no-op for arena memory; requests that do not fit fall back to malloc.
+class arena_allocator {
+public:
+    static constexpr size_t align = 16;
+
+    arena_allocator(void* memory, size_t size) : base_((unsigned char*)memory), size_(size) {}
+    explicit arena_allocator(size_t size) : owned_(new unsigned char[size]), base_(owned_.get()), size_(size) {}
+    arena_allocator(const arena_allocator&) = delete;
+    arena_allocator& operator=(const arena_allocator&) = delete;
+
+    static void* alloc(size_t size, void* user_data) { return ((arena_allocator*)user_data)->malloc(size); }
+    static void free(void* ptr, void* user_data) { ((arena_allocator*)user_data)->release(ptr); }
+    allocator get() { return {alloc, free, this}; }
+
+    void* malloc(size_t size) {
+        uintptr_t p = ((uintptr_t)(base_ + offset_) + align - 1) & ~(uintptr_t)(align - 1);
+        size_t end = (size_t)(p - (uintptr_t)base_) + size;
+        if (end > size_) {
+            fallbacks_++;
+            return ::malloc(size);
+        }
+        offset_ = end;
+        return (void*)p;
+    }
+
+    void release(void* ptr) {
+        if (ptr && !owns(ptr))
+            ::free(ptr);
+    }
+
+    bool owns(const void* ptr) const { return ptr >= base_ && ptr < base_ + size_; }
+    // Invalidates every arena allocation
+    void reset() { offset_ = 0; }
+    size_t used_bytes() const { return offset_; }
+    size_t capacity() const { return size_; }
+    size_t fallbacks() const { return fallbacks_; }
+
+private:
+    std::unique_ptr<unsigned char[]> owned_;
+    unsigned char* base_;
+    size_t size_;
+    size_t offset_ = 0;
+    size_t fallbacks_ = 0;
+};
+
+// Wraps another allocator (malloc by default) and counts live bytes, peak bytes
+// and allocations; use one per subsystem, e.g. tracking_allocator("sg").
+class tracking_allocator {
+public:
+    explicit tracking_allocator(const char* name, allocator parent = allocator()) : name_(name), parent_(parent) {}
+    tracking_allocator(const tracking_allocator&) = delete;
+    tracking_allocator& operator=(const tracking_allocator&) = delete;
+
+    static void* alloc(size_t size, void* user_data) { return ((tracking_allocator*)user_data)->malloc(size); }
+    static void free(void* ptr, void* user_data) { ((tracking_allocator*)user_data)->release(ptr); }
+    allocator get() { return {alloc, free, this}; }
+
+    void* malloc(size_t size) {
+        // the size is kept in front of the allocation so free() can account for it
+        unsigned char* p = (unsigned char*)parent_.alloc(size + header);
+        if (!p)
+            return nullptr;
+        *(size_t*)p = size;
+        size_t live = live_.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t peak = peak_.load(std::memory_order_relaxed);
+        while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            ;
+        allocs_.fetch_add(1, std::memory_order_relaxed);
+        return p + header;
+    }
+
+    void release(void* ptr) {
+        if (!ptr)
+            return;
+        unsigned char* p = (unsigned char*)ptr - header;
+        live_.fetch_sub(*(size_t*)p, std::memory_order_relaxed);
+        frees_.fetch_add(1, std::memory_order_relaxed);
+        parent_.free(p);
+    }
+
+    const char* name() const { return name_; }
+    size_t live_bytes() const { return live_.load(std::memory_order_relaxed); }
+    size_t peak_bytes() const { return peak_.load(std::memory_order_relaxed); }
+    uint64_t num_allocs() const { return allocs_.load(std::memory_order_relaxed); }
+    uint64_t num_frees() const { return frees_.load(std::memory_order_relaxed); }
+
+    void print(FILE* out = stdout) const {
+        fprintf(out, "%s: live %zu bytes, peak %zu bytes, %llu allocs, %llu frees\n", name_, live_bytes(), peak_bytes(),
+                (unsigned long long)num_allocs(), (unsigned long long)num_frees());
+    }
+
+private:
+    static constexpr size_t header = 16;  // keeps the payload 16-byte aligned
+
+    const char* name_;
+    allocator parent_;
+    std::atomic<size_t> live_{0};
+    std::atomic<size_t> peak_{0};
+    std::atomic<uint64_t> allocs_{0};
+    std::atomic<uint64_t> frees_{0};
+};
+} // namespace sokol
@@ -0,0 +1,556 @@
+/* sokol_app.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include "sokol_core.hpp"
+#include "sokol_queue.hpp"
+#include "sokol_time.hpp"
+
+// The C header must be included at global scope, sokol_app.inl is wrapped in a namespace
+#ifndef SOKOL_APP_INCLUDED
+#if __has_include("sokol_app.h")
+#include "sokol_app.h"
+#elif __has_include("sokol/sokol_app.h")
+#include "sokol/sokol_app.h"
+#endif
+#endif
+
+namespace gen {
+#include "sokol_app.inl"
+}
+
+#ifndef SOKOL_NO_SAPP
+namespace sapp {
+    using desc = gen::sapp::desc;
+    using win32_desc = gen::sapp::win32_desc;
+    using html5_desc = gen::sapp::html5_desc;
+    using ios_desc = gen::sapp::ios_desc;
+    using gl_desc = gen::sapp::gl_desc;
+    using icon_desc = gen::sapp::icon_desc;
+    using image_desc = gen::sapp::image_desc;
+
+// Coalesces sokol_app events into one immutable snapshot per frame. install() takes over
+// event_cb (events are still forwarded to a previously set event_cb/event_userdata_cb);
+// handle() records each event into the pending frame, folding every mouse move and touch
+// move into per-frame deltas, and update(), called once at the top of frame_cb, publishes
+// the pending frame and starts the next one. Keys and buttons are bitsets, touches are
+// stored as parallel arrays, and timestamps come from stm_now() (call stm_setup() first).
+class input {
+public:
+    static constexpr int max_keys = SAPP_MAX_KEYCODES;
+    static constexpr int max_buttons = SAPP_MAX_MOUSEBUTTONS;
+    static constexpr int max_touches = SAPP_MAX_TOUCHPOINTS;
+    static constexpr int max_chars = 32;
+
+    struct snapshot {
+        uint64_t frame = 0;        // update() count
+        uint64_t time = 0;         // stm ticks when published
+        uint64_t first_event = 0;  // stm ticks of the first and last event folded in, 0 if none
+        uint64_t last_event = 0;
+        uint32_t num_events = 0;   // raw events coalesced into this snapshot
+
+        // keys by sapp_keycode; pressed/released record every transition this frame, so a
+        // tap shorter than a frame shows up in both while down() is already false
+        std::bitset<max_keys> keys_down;
+        std::bitset<max_keys> keys_pressed;
+        std::bitset<max_keys> keys_released;
+        std::bitset<max_keys> keys_repeated;
+        uint32_t modifiers = 0;  // SAPP_MODIFIER_* of the last key or mouse event
+
+        std::bitset<max_buttons> buttons_down;
+        std::bitset<max_buttons> buttons_pressed;
+        std::bitset<max_buttons> buttons_released;
+        uint64_t button_time[max_buttons] = {};  // stm ticks of the last transition
+
+        float mouse_x = 0.0f, mouse_y = 0.0f;    // last position
+        float mouse_dx = 0.0f, mouse_dy = 0.0f;  // sum of all moves this frame
+        float scroll_x = 0.0f, scroll_y = 0.0f;
+        uint32_t mouse_moves = 0;
+        bool mouse_inside = false;
+
+        // text input, in arrival order; extra characters are counted but dropped
+        uint32_t chars[max_chars] = {};
+        int num_chars = 0;
+        int dropped_chars = 0;
+
+        // active touches as parallel arrays; ended touches stay for the frame they ended in
+        int num_touches = 0;
+        uintptr_t touch_id[max_touches] = {};
+        float touch_x[max_touches] = {};
+        float touch_y[max_touches] = {};
+        float touch_dx[max_touches] = {};
+        float touch_dy[max_touches] = {};
+        uint64_t touch_time[max_touches] = {};  // stm ticks of the touch's last event
+        uint8_t touch_began = 0;  // bit i: touch i began / ended this frame
+        uint8_t touch_ended = 0;
+
+        int window_width = 0, window_height = 0;
+        int framebuffer_width = 0, framebuffer_height = 0;
+        bool resized = false;
+        bool focused = true;
+        bool quit_requested = false;
+
+        bool down(sapp_keycode key) const { return valid_key(key) && keys_down[(size_t)key]; }
+        bool pressed(sapp_keycode key) const { return valid_key(key) && keys_pressed[(size_t)key]; }
+        bool released(sapp_keycode key) const { return valid_key(key) && keys_released[(size_t)key]; }
+        bool down(sapp_mousebutton b) const { return valid_button(b) && buttons_down[(size_t)b]; }
+        bool pressed(sapp_mousebutton b) const { return valid_button(b) && buttons_pressed[(size_t)b]; }
+        bool released(sapp_mousebutton b) const { return valid_button(b) && buttons_released[(size_t)b]; }
+        // Index of the touch with this identifier, -1 if it is not active
+        int find_touch(uintptr_t id) const {
+            for (int i = 0; i < num_touches; i++)
+                if (touch_id[i] == id)
+                    return i;
+            return -1;
+        }
+    };
+
+    input() = default;
+    input(const input&) = delete;
+    input& operator=(const input&) = delete;
+    ~input() {
+        if (instance() == this)
+            instance() = nullptr;
+    }
+
+    // Route the desc's events through this input; only one input can be installed at a time
+    desc& install(desc& d) {
+        const sapp_desc& c = d;
+        prev_cb_ = c.event_cb;
+        prev_userdata_cb_ = c.event_userdata_cb;
+        prev_user_data_ = c.user_data;
+        instance() = this;
+        d.event_cb([](const sapp_event* e) {
+            if (input* in = instance())
+                in->dispatch(*e);
+        });
+        return d;
+    }
+
+    // Fold one event into the pending frame
+    void handle(const sapp_event& e) {
+        const uint64_t now = timestamp();
+        snapshot& s = pending_;
+        if (!s.first_event)
+            s.first_event = now;
+        s.last_event = now;
+        s.num_events++;
+        switch (e.type) {
+            case SAPP_EVENTTYPE_KEY_DOWN:
+            case SAPP_EVENTTYPE_KEY_UP:
+                s.modifiers = e.modifiers;
+                if (!valid_key(e.key_code))
+                    break;
+                if (e.type == SAPP_EVENTTYPE_KEY_UP) {
+                    s.keys_down[(size_t)e.key_code] = false;
+                    s.keys_released[(size_t)e.key_code] = true;
+                } else if (e.key_repeat) {
+                    s.keys_repeated[(size_t)e.key_code] = true;
+                } else {
+                    s.keys_down[(size_t)e.key_code] = true;
+                    s.keys_pressed[(size_t)e.key_code] = true;
+                }
+                break;
+            case SAPP_EVENTTYPE_CHAR:
+                if (s.num_chars < max_chars)
+                    s.chars[s.num_chars++] = e.char_code;
+                else
+                    s.dropped_chars++;
+                break;
+            case SAPP_EVENTTYPE_MOUSE_DOWN:
+            case SAPP_EVENTTYPE_MOUSE_UP:
+                s.modifiers = e.modifiers;
+                move_mouse(e);
+                if (!valid_button(e.mouse_button))
+                    break;
+                s.buttons_down[(size_t)e.mouse_button] = e.type == SAPP_EVENTTYPE_MOUSE_DOWN;
+                (e.type == SAPP_EVENTTYPE_MOUSE_DOWN ? s.buttons_pressed : s.buttons_released)[(size_t)e.mouse_button] = true;
+                s.button_time[e.mouse_button] = now;
+                break;
+            case SAPP_EVENTTYPE_MOUSE_MOVE:
+                move_mouse(e);
+                s.mouse_dx += e.mouse_dx;
+                s.mouse_dy += e.mouse_dy;
+                s.mouse_moves++;
+                break;
+            case SAPP_EVENTTYPE_MOUSE_SCROLL:
+                s.scroll_x += e.scroll_x;
+                s.scroll_y += e.scroll_y;
+                break;
+            case SAPP_EVENTTYPE_MOUSE_ENTER:
+            case SAPP_EVENTTYPE_MOUSE_LEAVE:
+                s.mouse_inside = e.type == SAPP_EVENTTYPE_MOUSE_ENTER;
+                break;
+            case SAPP_EVENTTYPE_TOUCHES_BEGAN:
+            case SAPP_EVENTTYPE_TOUCHES_MOVED:
+            case SAPP_EVENTTYPE_TOUCHES_ENDED:
+            case SAPP_EVENTTYPE_TOUCHES_CANCELLED:
+                touch(e, now);
+                break;
+            case SAPP_EVENTTYPE_RESIZED:
+                s.resized = true;
+                break;
+            case SAPP_EVENTTYPE_FOCUSED:
+                s.focused = true;
+                break;
+            case SAPP_EVENTTYPE_UNFOCUSED:
+                // key and button ups are not delivered while unfocused
+                s.focused = false;
+                s.keys_released |= s.keys_down;
+                s.keys_down.reset();
+                s.buttons_released |= s.buttons_down;
+                s.buttons_down.reset();
+                break;
+            case SAPP_EVENTTYPE_QUIT_REQUESTED:
+                s.quit_requested = true;
+                break;
+            default:
+                break;
+        }
+        if (e.window_width > 0) {
+            s.window_width = e.window_width;
+            s.window_height = e.window_height;
+            s.framebuffer_width = e.framebuffer_width;
+            s.framebuffer_height = e.framebuffer_height;
+        }
+    }
+
+    // Publish everything since the last update() as the current snapshot; call once per frame
+    // before reading current()
+    const snapshot& update() {
+        pending_.frame = ++frames_;
+        pending_.time = timestamp();
+        current_ = pending_;
+        // carry the levels over, reset the per-frame edges and deltas
+        snapshot& s = pending_;
+        s.first_event = s.last_event = 0;
+        s.num_events = 0;
+        s.keys_pressed.reset();
+        s.keys_released.reset();
+        s.keys_repeated.reset();
+        s.buttons_pressed.reset();
+        s.buttons_released.reset();
+        s.mouse_dx = s.mouse_dy = 0.0f;
+        s.scroll_x = s.scroll_y = 0.0f;
+        s.mouse_moves = 0;
+        s.num_chars = 0;
+        s.dropped_chars = 0;
+        s.resized = false;
+        s.quit_requested = false;
+        int n = 0;
+        for (int i = 0; i < s.num_touches; i++) {
+            if (s.touch_ended & (1u << i))
+                continue;
+            s.touch_id[n] = s.touch_id[i];
+            s.touch_x[n] = s.touch_x[i];
+            s.touch_y[n] = s.touch_y[i];
+            s.touch_time[n] = s.touch_time[i];
+            s.touch_dx[n] = s.touch_dy[n] = 0.0f;
+            n++;
+        }
+        s.num_touches = n;
+        s.touch_began = s.touch_ended = 0;
+        return current_;
+    }
+
+    // The snapshot published by the last update(); unchanged until the next one
+    const snapshot& current() const { return current_; }
+
+private:
+    static input*& instance() {
+        static input* in = nullptr;
+        return in;
+    }
+
+    static bool valid_key(int key) { return key > 0 && key < max_keys; }
+    static bool valid_button(int b) { return b >= 0 && b < max_buttons; }
+
+    static uint64_t timestamp() {
+#ifndef SOKOL_NO_STM
+        return stm_now();
+#else
+        return 0;
+#endif
+    }
+
+    void dispatch(const sapp_event& e) {
+        handle(e);
+        if (prev_cb_)
+            prev_cb_(&e);
+        else if (prev_userdata_cb_)
+            prev_userdata_cb_(&e, prev_user_data_);
+    }
+
+    void move_mouse(const sapp_event& e) {
+        pending_.mouse_x = e.mouse_x;
+        pending_.mouse_y = e.mouse_y;
+    }
+
+    void touch(const sapp_event& e, uint64_t now) {
+        snapshot& s = pending_;
+        const bool ending = e.type == SAPP_EVENTTYPE_TOUCHES_ENDED || e.type == SAPP_EVENTTYPE_TOUCHES_CANCELLED;
+        for (int t = 0; t < e.num_touches && t < max_touches; t++) {
+            const sapp_touchpoint& p = e.touches[t];
+            if (!p.changed)
+                continue;
+            int i = s.find_touch(p.identifier);
+            if (i < 0) {
+                if (ending || s.num_touches == max_touches)
+                    continue;
+                i = s.num_touches++;
+                s.touch_id[i] = p.identifier;
+                s.touch_x[i] = p.pos_x;
+                s.touch_y[i] = p.pos_y;
+                s.touch_dx[i] = s.touch_dy[i] = 0.0f;
+                s.touch_began |= (uint8_t)(1u << i);
+            } else if (!ending && (s.touch_ended & (1u << i))) {
+                // lifted and touched again within one frame
+                s.touch_began |= (uint8_t)(1u << i);
+            }
+            if (!ending)
+                s.touch_ended &= (uint8_t)~(1u << i);
+            s.touch_dx[i] += p.pos_x - s.touch_x[i];
+            s.touch_dy[i] += p.pos_y - s.touch_y[i];
+            s.touch_x[i] = p.pos_x;
+            s.touch_y[i] = p.pos_y;
+            s.touch_time[i] = now;
+            if (ending)
+                s.touch_ended |= (uint8_t)(1u << i);
+        }
+    }
+
+    snapshot pending_;
+    snapshot current_;
+    uint64_t frames_ = 0;
+    void (*prev_cb_)(const sapp_event*) = nullptr;
+    void (*prev_userdata_cb_)(const sapp_event*, void*) = nullptr;
+    void* prev_user_data_ = nullptr;
+};
+
+// Runs a fixed-rate simulation on its own thread, decoupled from frame_cb. After every tick
+// the state is published through a wait-free triple buffer; render() in frame_cb picks up the
+// newest tick and interpolates between the last two, rendering one tick behind real time so
+// frames stay smooth whatever the frame rate. install() makes cleanup_cb stop and join the
+// thread before the app's own cleanup runs. State must be default-constructible and copyable.
+template <typename State>
+class simulation {
+public:
+    using tick_fn = std::function<void(State& state, double dt, uint64_t tick)>;
+
+    struct config {
+        double tick_hz = 60.0;
+        int max_catch_up = 5;  // ticks run back to back after a stall before time is dropped
+    };
+
+    // Sim thread and frame_cb timing; busy times are totals in milliseconds
+    struct stats {
+        uint64_t ticks = 0;
+        uint64_t dropped_ticks = 0;     // skipped after falling more than max_catch_up behind
+        double tick_mean_ms = 0.0;
+        double tick_max_ms = 0.0;
+        double sim_busy_ms = 0.0;
+        double sim_load = 0.0;          // busy fraction of the tick period
+        uint64_t frames = 0;
+        uint64_t frames_without_tick = 0;  // render() calls that found no new tick
+        double frame_mean_ms = 0.0;        // interval between render() calls
+        double overlap_ms_per_frame = 0.0; // sim time per frame no longer spent inside frame_cb
+    };
+
+    simulation() : simulation(config()) {}
+    explicit simulation(const config& cfg) : cfg_(cfg) {
+        cfg_.tick_hz = cfg_.tick_hz > 0.0 ? cfg_.tick_hz : 60.0;
+        cfg_.max_catch_up = std::max(cfg_.max_catch_up, 1);
+    }
+    simulation(const simulation&) = delete;
+    simulation& operator=(const simulation&) = delete;
+    ~simulation() {
+        stop();
+        if (instance() == this)
+            instance() = nullptr;
+    }
+
+    // Stop the thread in cleanup_cb, before any previously set cleanup callback runs
+    desc& install(desc& d) {
+        const sapp_desc& c = d;
+        prev_cleanup_cb_ = c.cleanup_cb;
+        prev_cleanup_userdata_cb_ = c.cleanup_userdata_cb;
+        prev_user_data_ = c.user_data;
+        instance() = this;
+        d.cleanup_cb([] {
+            if (simulation* sim = instance()) {
+                sim->stop();
+                if (sim->prev_cleanup_cb_)
+                    sim->prev_cleanup_cb_();
+                else if (sim->prev_cleanup_userdata_cb_)
+                    sim->prev_cleanup_userdata_cb_(sim->prev_user_data_);
+            }
+        });
+        return d;
+    }
+
+    // Start ticking from the given state
+    void start(const State& initial, tick_fn tick) {
+        stop();
+        state_ = initial;
+        tick_ = std::move(tick);
+        epoch_ = clock::now();
+        prev_ = {initial, 0, 0.0};
+        curr_ = prev_;
+        slot& s = buffer_.write_buffer();
+        s = curr_;
+        buffer_.publish();
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // frame_cb: take the newest tick and call fn(const State& prev, const State& curr, float alpha)
+    // to blend the two ticks around render time
+    template <typename F>
+    void render(F&& fn) {
+        const double now = seconds_since_epoch();
+        if (last_frame_ > 0.0)
+            frame_total_ += now - last_frame_;
+        last_frame_ = now;
+        frames_++;
+        if (buffer_.update()) {
+            // a stall may have skipped ticks, in which case blend from whatever came before
+            prev_ = curr_;
+            curr_ = buffer_.read_buffer();
+        } else {
+            frames_without_tick_++;
+        }
+        const double dt = 1.0 / cfg_.tick_hz;
+        const double render_time = now - dt;
+        const double span = curr_.time - prev_.time;
+        float alpha = span > 0.0 ? (float)((render_time - prev_.time) / span) : 1.0f;
+        alpha = std::min(std::max(alpha, 0.0f), 1.0f);
+        fn(prev_.state, curr_.state, alpha);
+    }
+
+    // The newest tick render() has picked up, and its number
+    const State& latest() const { return curr_.state; }
+    uint64_t latest_tick() const { return curr_.tick; }
+
+    // frame_cb side; the sim totals are read without stopping the thread
+    stats query_stats() const {
+        stats s;
+        s.ticks = ticks_.load(std::memory_order_relaxed);
+        s.dropped_ticks = dropped_.load(std::memory_order_relaxed);
+        const double busy = (double)busy_ns_.load(std::memory_order_relaxed) * 1e-6;
+        s.sim_busy_ms = busy;
+        s.tick_mean_ms = s.ticks ? busy / (double)s.ticks : 0.0;
+        s.tick_max_ms = (double)max_ns_.load(std::memory_order_relaxed) * 1e-6;
+        s.sim_load = s.tick_mean_ms * cfg_.tick_hz * 1e-3;
+        s.frames = frames_;
+        s.frames_without_tick = frames_without_tick_;
+        s.frame_mean_ms = frames_ > 1 ? frame_total_ * 1e3 / (double)(frames_ - 1) : 0.0;
+        s.overlap_ms_per_frame = frames_ ? busy / (double)frames_ : 0.0;
+        return s;
+    }
+
+    const config& get_config() const { return cfg_; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct slot {
+        State state{};
+        uint64_t tick = 0;
+        double time = 0.0;  // seconds since start() this tick represents
+    };
+
+    static simulation*& instance() {
+        static simulation* sim = nullptr;
+        return sim;
+    }
+
+    double seconds_since_epoch() const { return std::chrono::duration<double>(clock::now() - epoch_).count(); }
+
+    void run() {
+        const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / cfg_.tick_hz));
+        const double dt = 1.0 / cfg_.tick_hz;
+        uint64_t tick = 0;
+        auto next = epoch_ + period;
+        while (running_.load(std::memory_order_acquire)) {
+            auto now = clock::now();
+            if (now < next) {
+                std::this_thread::sleep_until(next);
+                continue;
+            }
+            for (int steps = 0; now >= next && steps < cfg_.max_catch_up; steps++) {
+                const auto start = clock::now();
+                tick_(state_, dt, ++tick);
+                const uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+                busy_ns_.fetch_add(ns, std::memory_order_relaxed);
+                if (ns > max_ns_.load(std::memory_order_relaxed))
+                    max_ns_.store(ns, std::memory_order_relaxed);
+                ticks_.fetch_add(1, std::memory_order_relaxed);
+                next += period;
+                now = clock::now();
+            }
+            if (now >= next) {
+                // too far behind: drop the backlog rather than spiral
+                const uint64_t behind = (uint64_t)((now - next) / period) + 1;
+                dropped_.fetch_add(behind, std::memory_order_relaxed);
+                next += period * (clock::duration::rep)behind;
+            }
+            slot& s = buffer_.write_buffer();
+            s.state = state_;
+            s.tick = tick;
+            s.time = std::chrono::duration<double>(next - period - epoch_).count();
+            buffer_.publish();
+        }
+    }
+
+    config cfg_;
+    tick_fn tick_;
+    State state_{};  // sim thread
+    sokol::triple_buffer<slot> buffer_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    clock::time_point epoch_;
+    std::atomic<uint64_t> ticks_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> busy_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+    // frame_cb
+    slot prev_;
+    slot curr_;
+    uint64_t frames_ = 0;
+    uint64_t frames_without_tick_ = 0;
+    double last_frame_ = 0.0;
+    double frame_total_ = 0.0;
+    void (*prev_cleanup_cb_)() = nullptr;
+    void (*prev_cleanup_userdata_cb_)(void*) = nullptr;
+    void* prev_user_data_ = nullptr;
+};
+} // namespace sapp
+#endif // SOKOL_NO_SAPP
@@ -0,0 +1,508 @@
+// Machine generated C++ wrapper for Sokol library.
+// https://github.com/takeiteasy/sokol.hpp
+//
+// Do not edit manually; regenerate using generate.py.
+
+#pragma once
+#include <utility>
+#include <memory>
+
+#ifndef SOKOL_APP_INCLUDED
+#if __has_include("sokol_app.h")
+#include "sokol_app.h"
+#elif __has_include("sokol/sokol_app.h")
+#include "sokol/sokol_app.h"
+#else
+#warning "Cannot find sokol_app.h, disabling!"
+#define SOKOL_NO_SAPP
+#endif
+#endif
+
+#ifndef SOKOL_NO_SAPP
+#ifdef SOKOL_HPP_EXTERN
+SOKOL_HPP_EXTERN template class sg::helper::desc<sapp_image_desc>;
+SOKOL_HPP_EXTERN template class sg::helper::desc<sapp_icon_desc>;
+SOKOL_HPP_EXTERN template class sg::helper::desc<sapp_gl_desc>;
+SOKOL_HPP_EXTERN template class sg::helper::desc<sapp_win32_desc>;
+SOKOL_HPP_EXTERN template class sg::helper::desc<sapp_html5_desc>;
+SOKOL_HPP_EXTERN template class sg::helper::desc<sapp_ios_desc>;
+SOKOL_HPP_EXTERN template class sg::helper::desc<sapp_desc>;
+#endif
+namespace sapp {
+namespace helper = sg::helper;
+// Builder API for sapp_image_desc
+class image_desc : public helper::desc<sapp_image_desc> {
+public:
+    image_desc() = default;
+
+    image_desc& width(int value) {
+        desc_.width = value;
+        return *this;
+    }
+
+    image_desc& height(int value) {
+        desc_.height = value;
+        return *this;
+    }
+
+    image_desc& cursor_hotspot_x(int value) {
+        desc_.cursor_hotspot_x = value;
+        return *this;
+    }
+
+    image_desc& cursor_hotspot_y(int value) {
+        desc_.cursor_hotspot_y = value;
+        return *this;
+    }
+
+    image_desc& pixels_ptr(const void* value) {
+        desc_.pixels.ptr = value;
+        return *this;
+    }
+
+    image_desc& pixels_size(size_t value) {
+        desc_.pixels.size = value;
+        return *this;
+    }
+
+};
+
+// Builder API for sapp_icon_desc
+class icon_desc : public helper::desc<sapp_icon_desc> {
+public:
+    icon_desc() = default;
+
+    icon_desc& sokol_default(bool value) {
+        desc_.sokol_default = value;
+        return *this;
+    }
+
+    icon_desc& image_width(int index, int value) {
+        desc_.images[index].width = value;
+        return *this;
+    }
+
+    icon_desc& image_height(int index, int value) {
+        desc_.images[index].height = value;
+        return *this;
+    }
+
+    icon_desc& image_cursor_hotspot_x(int index, int value) {
+        desc_.images[index].cursor_hotspot_x = value;
+        return *this;
+    }
+
+    icon_desc& image_cursor_hotspot_y(int index, int value) {
+        desc_.images[index].cursor_hotspot_y = value;
+        return *this;
+    }
+
+    icon_desc& image_pixels_ptr(int index, const void* value) {
+        desc_.images[index].pixels.ptr = value;
+        return *this;
+    }
+
+    icon_desc& image_pixels_size(int index, size_t value) {
+        desc_.images[index].pixels.size = value;
+        return *this;
+    }
+
+};
+
+// Builder API for sapp_gl_desc
+class gl_desc : public helper::desc<sapp_gl_desc> {
+public:
+    gl_desc() = default;
+
+    gl_desc& major_version(int value) {
+        desc_.major_version = value;
+        return *this;
+    }
+
+    gl_desc& minor_version(int value) {
+        desc_.minor_version = value;
+        return *this;
+    }
+
+};
+
+// Builder API for sapp_win32_desc
+class win32_desc : public helper::desc<sapp_win32_desc> {
+public:
+    win32_desc() = default;
+
+    win32_desc& console_utf8(bool value) {
+        desc_.console_utf8 = value;
+        return *this;
+    }
+
+    win32_desc& console_create(bool value) {
+        desc_.console_create = value;
+        return *this;
+    }
+
+    win32_desc& console_attach(bool value) {
+        desc_.console_attach = value;
+        return *this;
+    }
+
+};
+
+// Builder API for sapp_html5_desc
+class html5_desc : public helper::desc<sapp_html5_desc> {
+public:
+    html5_desc() = default;
+
+    html5_desc& canvas_selector(const char* value) {
+        desc_.canvas_selector = value;
+        return *this;
+    }
+
+    html5_desc& canvas_resize(bool value) {
+        desc_.canvas_resize = value;
+        return *this;
+    }
+
+    html5_desc& preserve_drawing_buffer(bool value) {
+        desc_.preserve_drawing_buffer = value;
+        return *this;
+    }
+
+    html5_desc& premultiplied_alpha(bool value) {
+        desc_.premultiplied_alpha = value;
+        return *this;
+    }
+
+    html5_desc& ask_leave_site(bool value) {
+        desc_.ask_leave_site = value;
+        return *this;
+    }
+
+    html5_desc& update_document_title(bool value) {
+        desc_.update_document_title = value;
+        return *this;
+    }
+
+    html5_desc& bubble_mouse_events(bool value) {
+        desc_.bubble_mouse_events = value;
+        return *this;
+    }
+
+    html5_desc& bubble_touch_events(bool value) {
+        desc_.bubble_touch_events = value;
+        return *this;
+    }
+
+    html5_desc& bubble_wheel_events(bool value) {
+        desc_.bubble_wheel_events = value;
+        return *this;
+    }
+
+    html5_desc& bubble_key_events(bool value) {
+        desc_.bubble_key_events = value;
+        return *this;
+    }
+
+    html5_desc& bubble_char_events(bool value) {
+        desc_.bubble_char_events = value;
+        return *this;
+    }
+
+    html5_desc& use_emsc_set_main_loop(bool value) {
+        desc_.use_emsc_set_main_loop = value;
+        return *this;
+    }
+
+    html5_desc& emsc_set_main_loop_simulate_infinite_loop(bool value) {
+        desc_.emsc_set_main_loop_simulate_infinite_loop = value;
+        return *this;
+    }
+
+};
+
+// Builder API for sapp_ios_desc
+class ios_desc : public helper::desc<sapp_ios_desc> {
+public:
+    ios_desc() = default;
+
+    ios_desc& keyboard_resizes_canvas(bool value) {
+        desc_.keyboard_resizes_canvas = value;
+        return *this;
+    }
+
+};
+
+// Builder API for sapp_desc
+class desc : public helper::desc<sapp_desc> {
+public:
+    desc() = default;
+
+    desc& init_cb(void (*value)(void)) {
+        desc_.init_cb = value;
+        return *this;
+    }
+
+    desc& frame_cb(void (*value)(void)) {
+        desc_.frame_cb = value;
+        return *this;
+    }
+
+    desc& cleanup_cb(void (*value)(void)) {
+        desc_.cleanup_cb = value;
+        return *this;
+    }
+
+    desc& event_cb(void (*value)(const sapp_event *)) {
+        desc_.event_cb = value;
+        return *this;
+    }
+
+    desc& user_data(void* value) {
+        desc_.user_data = value;
+        return *this;
+    }
+
+    desc& init_userdata_cb(void (*value)(void *)) {
+        desc_.init_userdata_cb = value;
+        return *this;
+    }
+
+    desc& frame_userdata_cb(void (*value)(void *)) {
+        desc_.frame_userdata_cb = value;
+        return *this;
+    }
+
+    desc& cleanup_userdata_cb(void (*value)(void *)) {
+        desc_.cleanup_userdata_cb = value;
+        return *this;
+    }
+
+    desc& event_userdata_cb(void (*value)(const sapp_event *, void *)) {
+        desc_.event_userdata_cb = value;
+        return *this;
+    }
+
+    desc& width(int value) {
+        desc_.width = value;
+        return *this;
+    }
+
+    desc& height(int value) {
+        desc_.height = value;
+        return *this;
+    }
+
+    desc& sample_count(int value) {
+        desc_.sample_count = value;
+        return *this;
+    }
+
+    desc& swap_interval(int value) {
+        desc_.swap_interval = value;
+        return *this;
+    }
+
+    desc& high_dpi(bool value) {
+        desc_.high_dpi = value;
+        return *this;
+    }
+
+    desc& fullscreen(bool value) {
+        desc_.fullscreen = value;
+        return *this;
+    }
+
+    desc& alpha(bool value) {
+        desc_.alpha = value;
+        return *this;
+    }
+
+    desc& window_title(const char* value) {
+        desc_.window_title = value;
+        return *this;
+    }
+
+    desc& enable_clipboard(bool value) {
+        desc_.enable_clipboard = value;
+        return *this;
+    }
+
+    desc& clipboard_size(int value) {
+        desc_.clipboard_size = value;
+        return *this;
+    }
+
+    desc& enable_dragndrop(bool value) {
+        desc_.enable_dragndrop = value;
+        return *this;
+    }
+
+    desc& max_dropped_files(int value) {
+        desc_.max_dropped_files = value;
+        return *this;
+    }
+
+    desc& max_dropped_file_path_length(int value) {
+        desc_.max_dropped_file_path_length = value;
+        return *this;
+    }
+
+    desc& icon_sokol_default(bool value) {
+        desc_.icon.sokol_default = value;
+        return *this;
+    }
+
+    desc& icon_image_width(int index, int value) {
+        desc_.icon.images[index].width = value;
+        return *this;
+    }
+
+    desc& icon_image_height(int index, int value) {
+        desc_.icon.images[index].height = value;
+        return *this;
+    }
+
+    desc& icon_image_cursor_hotspot_x(int index, int value) {
+        desc_.icon.images[index].cursor_hotspot_x = value;
+        return *this;
+    }
+
+    desc& icon_image_cursor_hotspot_y(int index, int value) {
+        desc_.icon.images[index].cursor_hotspot_y = value;
+        return *this;
+    }
+
+    desc& icon_image_pixels_ptr(int index, const void* value) {
+        desc_.icon.images[index].pixels.ptr = value;
+        return *this;
+    }
+
+    desc& icon_image_pixels_size(int index, size_t value) {
+        desc_.icon.images[index].pixels.size = value;
+        return *this;
+    }
+
+    desc& allocator_alloc_fn(void *(*value)(size_t, void *)) {
+        desc_.allocator.alloc_fn = value;
+        return *this;
+    }
+
+    desc& allocator_free_fn(void (*value)(void *, void *)) {
+        desc_.allocator.free_fn = value;
+        return *this;
+    }
+
+    desc& allocator_user_data(void* value) {
+        desc_.allocator.user_data = value;
+        return *this;
+    }
+
+    desc& logger_func(void (*value)(const char *, uint32_t, uint32_t, const char *, uint32_t, const char *, void *)) {
+        desc_.logger.func = value;
+        return *this;
+    }
+
+    desc& logger_user_data(void* value) {
+        desc_.logger.user_data = value;
+        return *this;
+    }
+
+    desc& gl_major_version(int value) {
+        desc_.gl.major_version = value;
+        return *this;
+    }
+
+    desc& gl_minor_version(int value) {
+        desc_.gl.minor_version = value;
+        return *this;
+    }
+
+    desc& win32_console_utf8(bool value) {
+        desc_.win32.console_utf8 = value;
+        return *this;
+    }
+
+    desc& win32_console_create(bool value) {
+        desc_.win32.console_create = value;
+        return *this;
+    }
+
+    desc& win32_console_attach(bool value) {
+        desc_.win32.console_attach = value;
+        return *this;
+    }
+
+    desc& html5_canvas_selector(const char* value) {
+        desc_.html5.canvas_selector = value;
+        return *this;
+    }
+
+    desc& html5_canvas_resize(bool value) {
+        desc_.html5.canvas_resize = value;
+        return *this;
+    }
+
+    desc& html5_preserve_drawing_buffer(bool value) {
+        desc_.html5.preserve_drawing_buffer = value;
+        return *this;
+    }
+
+    desc& html5_premultiplied_alpha(bool value) {
+        desc_.html5.premultiplied_alpha = value;
+        return *this;
+    }
+
+    desc& html5_ask_leave_site(bool value) {
+        desc_.html5.ask_leave_site = value;
+        return *this;
+    }
+
+    desc& html5_update_document_title(bool value) {
+        desc_.html5.update_document_title = value;
+        return *this;
+    }
+
+    desc& html5_bubble_mouse_events(bool value) {
+        desc_.html5.bubble_mouse_events = value;
+        return *this;
+    }
+
+    desc& html5_bubble_touch_events(bool value) {
+        desc_.html5.bubble_touch_events = value;
+        return *this;
+    }
+
+    desc& html5_bubble_wheel_events(bool value) {
+        desc_.html5.bubble_wheel_events = value;
+        return *this;
+    }
+
+    desc& html5_bubble_key_events(bool value) {
+        desc_.html5.bubble_key_events = value;
+        return *this;
+    }
+
+    desc& html5_bubble_char_events(bool value) {
+        desc_.html5.bubble_char_events = value;
+        return *this;
+    }
+
+    desc& html5_use_emsc_set_main_loop(bool value) {
+        desc_.html5.use_emsc_set_main_loop = value;
+        return *this;
+    }
+
+    desc& html5_emsc_set_main_loop_simulate_infinite_loop(bool value) {
+        desc_.html5.emsc_set_main_loop_simulate_infinite_loop = value;
+        return *this;
+    }
+
+    desc& ios_keyboard_resizes_canvas(bool value) {
+        desc_.ios.keyboard_resizes_canvas = value;
+        return *this;
+    }
+
+};
+
+} // namespace sapp
+#endif // SOKOL_NO_SAPP
@@ -0,0 +1,2653 @@
+/* sokol_audio.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "sokol_core.hpp"
+#include "sokol_queue.hpp"
+#include "sokol_simd.hpp"
+#include "sokol_time.hpp"
+#ifndef SOKOL_NO_SAUDIO
+// saudio::mapped_file only
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+// The C header must be included at global scope, sokol_audio.inl is wrapped in a namespace
+#ifndef SOKOL_AUDIO_INCLUDED
+#if __has_include("sokol_audio.h")
+#include "sokol_audio.h"
+#elif __has_include("sokol/sokol_audio.h")
+#include "sokol/sokol_audio.h"
+#endif
+#endif
+
+namespace gen {
+#include "sokol_audio.inl"
+}
+
+#ifndef SOKOL_NO_SAUDIO
+namespace saudio {
+    using desc = gen::saudio::desc;
+    using n3ds_desc = gen::saudio::n3ds_desc;
+
+// Installs a stream_userdata_cb that calls fn(float* buffer, int num_frames, int num_channels)
+// directly; the callable is not type-erased and must outlive the audio stream
+template <typename F>
+desc& bind(desc& d, F& fn) {
+    d.stream_userdata_cb([](float* buffer, int num_frames, int num_channels, void* user_data) {
+        (*static_cast<F*>(user_data))(buffer, num_frames, num_channels);
+    });
+    d.user_data(&fn);
+    return d;
+}
+
+namespace helper {
+// Stream parameters of the offline_renderer currently running, if any
+inline std::atomic<const saudio_desc*>& offline_desc() {
+    static std::atomic<const saudio_desc*> d{nullptr};
+    return d;
+}
+} // namespace helper
+
+// saudio_sample_rate() and saudio_buffer_frames() that also answer from inside an
+// offline_renderer run; 0 when no stream is running
+inline int sample_rate() {
+    if (const saudio_desc* d = helper::offline_desc().load(std::memory_order_acquire))
+        return d->sample_rate;
+    return saudio_isvalid() ? saudio_sample_rate() : 0;
+}
+
+inline int buffer_frames() {
+    if (const saudio_desc* d = helper::offline_desc().load(std::memory_order_acquire))
+        return d->buffer_frames;
+    return saudio_isvalid() ? saudio_buffer_frames() : 0;
+}
+
+// Wait-free single-producer/single-consumer ring of interleaved float samples. The game
+// thread pushes whole frames, the audio thread pops them; neither side ever blocks.
+class spsc_ring {
+public:
+    spsc_ring() = default;
+    spsc_ring(size_t capacity_frames, int num_channels) { reset(capacity_frames, num_channels); }
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    // Not thread-safe, call before the stream starts
+    void reset(size_t capacity_frames, int num_channels) {
+        channels_ = num_channels > 0 ? num_channels : 1;
+        size_t cap = 2;
+        while (cap < capacity_frames * (size_t)channels_)
+            cap <<= 1;
+        samples_ = std::unique_ptr<float[]>(new float[cap]());
+        mask_ = cap - 1;
+        // only whole frames fit, so the capacity in samples stays a multiple of the channel count
+        capacity_ = cap - cap % (size_t)channels_;
+        write_.store(0, std::memory_order_relaxed);
+        read_.store(0, std::memory_order_relaxed);
+        underruns_.store(0, std::memory_order_relaxed);
+        underrun_frames_.store(0, std::memory_order_relaxed);
+        overruns_.store(0, std::memory_order_relaxed);
+        overrun_frames_.store(0, std::memory_order_relaxed);
+    }
+
+    // Producer: copy up to num_frames frames, returns the number written; the rest is dropped
+    // and counted as an overrun
+    int push(const float* frames, int num_frames) {
+        const uint64_t w = write_.load(std::memory_order_relaxed);
+        const uint64_t r = read_.load(std::memory_order_acquire);
+        const int space = (int)((capacity_ - (size_t)(w - r)) / (size_t)channels_);
+        const int n = std::min(num_frames, space);
+        if (n > 0) {
+            copy_in(w, frames, (size_t)n * (size_t)channels_);
+            write_.store(w + (uint64_t)n * (uint64_t)channels_, std::memory_order_release);
+        }
+        if (n < num_frames) {
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+            overrun_frames_.fetch_add((uint64_t)(num_frames - n), std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // Consumer: fill num_frames frames, zero-filling and counting an underrun if the ring runs dry
+    int pop(float* frames, int num_frames) {
+        const uint64_t r = read_.load(std::memory_order_relaxed);
+        const uint64_t w = write_.load(std::memory_order_acquire);
+        const int avail = (int)((size_t)(w - r) / (size_t)channels_);
+        const int n = std::min(num_frames, avail);
+        if (n > 0) {
+            copy_out(r, frames, (size_t)n * (size_t)channels_);
+            read_.store(r + (uint64_t)n * (uint64_t)channels_, std::memory_order_release);
+        }
+        if (n < num_frames) {
+            memset(frames + (size_t)n * (size_t)channels_, 0, (size_t)(num_frames - n) * (size_t)channels_ * sizeof(float));
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+            underrun_frames_.fetch_add((uint64_t)(num_frames - n), std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // Frames the producer can push without overrunning (the saudio_expect() equivalent)
+    int expect() const {
+        const uint64_t w = write_.load(std::memory_order_relaxed);
+        const uint64_t r = read_.load(std::memory_order_acquire);
+        return (int)((capacity_ - (size_t)(w - r)) / (size_t)channels_);
+    }
+
+    // Frames queued for the consumer
+    int available() const {
+        const uint64_t r = read_.load(std::memory_order_relaxed);
+        const uint64_t w = write_.load(std::memory_order_acquire);
+        return (int)((size_t)(w - r) / (size_t)channels_);
+    }
+
+    int capacity() const { return (int)(capacity_ / (size_t)channels_); }
+    int channels() const { return channels_; }
+    uint64_t underruns() const { return underruns_.load(std::memory_order_relaxed); }
+    uint64_t underrun_frames() const { return underrun_frames_.load(std::memory_order_relaxed); }
+    uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+    uint64_t overrun_frames() const { return overrun_frames_.load(std::memory_order_relaxed); }
+
+private:
+    void copy_in(uint64_t pos, const float* src, size_t count) {
+        const size_t start = (size_t)pos & mask_;
+        const size_t first = std::min(count, mask_ + 1 - start);
+        memcpy(samples_.get() + start, src, first * sizeof(float));
+        memcpy(samples_.get(), src + first, (count - first) * sizeof(float));
+    }
+
+    void copy_out(uint64_t pos, float* dst, size_t count) const {
+        const size_t start = (size_t)pos & mask_;
+        const size_t first = std::min(count, mask_ + 1 - start);
+        memcpy(dst, samples_.get() + start, first * sizeof(float));
+        memcpy(dst + first, samples_.get(), (count - first) * sizeof(float));
+    }
+
+    std::unique_ptr<float[]> samples_;
+    size_t mask_ = 0;
+    size_t capacity_ = 0;
+    int channels_ = 1;
+    alignas(64) std::atomic<uint64_t> write_{0};
+    alignas(64) std::atomic<uint64_t> read_{0};
+    alignas(64) std::atomic<uint64_t> underruns_{0};
+    std::atomic<uint64_t> underrun_frames_{0};
+    alignas(64) std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> overrun_frames_{0};
+};
+
+// Lock-free replacement for saudio_push(): the game thread pushes into an spsc_ring which
+// the audio thread drains from a stream_userdata_cb trampoline
+class push_stream {
+public:
+    push_stream(int capacity_frames = 4096, int num_channels = 2) : ring_((size_t)capacity_frames, num_channels) {}
+    push_stream(const push_stream&) = delete;
+    push_stream& operator=(const push_stream&) = delete;
+
+    // Route the desc's stream callback through this stream
+    desc& install(desc& d) {
+        d.num_channels(ring_.channels());
+        return bind(d, *this);
+    }
+
+    // Configure d and saudio_setup() it; false if the stream did not start with the ring's
+    // channel count, in which case it plays silence
+    bool setup(desc& d) {
+        saudio_setup(&install(d));
+        return saudio_isvalid() && saudio_channels() == ring_.channels();
+    }
+
+    int push(const float* frames, int num_frames) { return ring_.push(frames, num_frames); }
+    int expect() const { return ring_.expect(); }
+
+    // Audio thread entry point
+    void operator()(float* buffer, int num_frames, int num_channels) {
+        if (num_channels == ring_.channels())
+            ring_.pop(buffer, num_frames);
+        else
+            memset(buffer, 0, (size_t)num_frames * (size_t)num_channels * sizeof(float));
+    }
+
+    spsc_ring& ring() { return ring_; }
+    const spsc_ring& ring() const { return ring_; }
+
+private:
+    spsc_ring ring_;
+};
+
+// Caller-owned interleaved float samples played by mixer voices
+struct sound {
+    const float* samples = nullptr;
+    int frames = 0;
+    int channels = 1;
+};
+
+// Multi-voice mixer for the stream callback. Voices are started and controlled from one
+// game thread through a wait-free command queue and mixed on the audio thread in blocks of
+// packet_frames with SIMD gain/pan/fade kernels. Voices below the audibility threshold, or
+// beyond max_audible, are virtualized: they keep their position but are not mixed.
+// The *_at variants take effect on an exact frame of the mixer's output (see position()),
+// splitting the block there; sample_clock/scheduler map stm timestamps to those frames.
+class mixer {
+public:
+    struct config {
+        int max_voices = 1024;            // at most 65535
+        int max_audible = 0;              // voices mixed per block, the quietest beyond it are virtualized; 0 = no limit
+        int channels = 2;
+        int block_frames = 128;           // install() takes packet_frames from the desc
+        float virtual_threshold = 1e-4f;  // -80 dB
+        int command_capacity = 4096;
+    };
+
+    struct voice_params {
+        float gain = 1.0f;
+        float pan = 0.0f;         // -1 left .. 1 right
+        int fade_in_frames = 0;
+        int start_frame = 0;
+        bool loop = false;
+        int loop_start = 0;
+        int loop_end = 0;         // 0 = end of the sound
+    };
+
+    // Generation-checked voice handle; operations on finished voices are ignored
+    struct voice {
+        uint32_t id = 0;
+        bool valid() const { return id != 0; }
+    };
+
+    struct stats {
+        int active = 0;
+        int mixed = 0;
+        int virtualized = 0;
+        uint64_t dropped_commands = 0;
+        uint64_t late_commands = 0;  // scheduled for a frame that had already been mixed
+    };
+
+    mixer() : mixer(config()) {}
+    explicit mixer(const config& cfg)
+        : cfg_(cfg), commands_((size_t)std::max(cfg.command_capacity, 16)), free_((size_t)std::max(cfg.max_voices, 1)) {
+        cfg_.max_voices = std::min(std::max(cfg_.max_voices, 1), 65535);
+        cfg_.block_frames = std::max(cfg_.block_frames, 1);
+        slots_.resize((size_t)cfg_.max_voices);
+        generations_.resize((size_t)cfg_.max_voices, 0);
+        live_.reserve((size_t)cfg_.max_voices);
+        audible_.reserve((size_t)cfg_.max_voices);
+        scheduled_.reserve(commands_.capacity());
+        for (int i = 0; i < cfg_.max_voices; i++)
+            free_.push((uint16_t)i);
+    }
+    mixer(const mixer&) = delete;
+    mixer& operator=(const mixer&) = delete;
+
+    // Route the desc's stream callback into this mixer
+    desc& install(desc& d) {
+        const saudio_desc& c = d;
+        if (c.packet_frames > 0)
+            cfg_.block_frames = c.packet_frames;
+        d.num_channels(cfg_.channels);
+        return bind(d, *this);
+    }
+
+    // Game thread: start a voice, invalid if all voices are busy or the command queue is full
+    voice play(const sound& snd) { return play_at(0, snd, voice_params()); }
+    voice play(const sound& snd, const voice_params& params) { return play_at(0, snd, params); }
+
+    void stop(voice v, int fade_frames = 0) { send(command::stop, 0, v, 0.0f, fade_frames); }
+    void set_gain(voice v, float gain, int fade_frames = 0) { send(command::gain, 0, v, gain, fade_frames); }
+    void set_pan(voice v, float pan) { send(command::pan, 0, v, pan, 0); }
+
+    // Game thread: the same commands applied on output frame `frame`; commands aimed at a
+    // voice only take effect once its start has been applied
+    voice play_at(uint64_t frame, const sound& snd) { return play_at(frame, snd, voice_params()); }
+    voice play_at(uint64_t frame, const sound& snd, const voice_params& params) {
+        uint16_t index;
+        if (!snd.samples || snd.frames <= 0 || commands_.free_space() == 0 || !free_.pop(index)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        uint16_t gen = ++generations_[index];
+        if (!gen)
+            gen = ++generations_[index];
+        command cmd = {};
+        cmd.type = command::start;
+        cmd.frame = frame;
+        cmd.index = index;
+        cmd.generation = gen;
+        cmd.snd = snd;
+        cmd.params = params;
+        commands_.push(cmd);
+        return {((uint32_t)gen << 16) | index};
+    }
+
+    void stop_at(uint64_t frame, voice v, int fade_frames = 0) { send(command::stop, frame, v, 0.0f, fade_frames); }
+    void set_gain_at(uint64_t frame, voice v, float gain, int fade_frames = 0) { send(command::gain, frame, v, gain, fade_frames); }
+    void set_pan_at(uint64_t frame, voice v, float pan) { send(command::pan, frame, v, pan, 0); }
+
+    void set_master_gain(float gain) { master_.store(gain, std::memory_order_relaxed); }
+    float master_gain() const { return master_.load(std::memory_order_relaxed); }
+
+    stats query_stats() const {
+        stats s;
+        s.active = active_count_.load(std::memory_order_relaxed);
+        s.mixed = mixed_count_.load(std::memory_order_relaxed);
+        s.virtualized = virtual_count_.load(std::memory_order_relaxed);
+        s.dropped_commands = dropped_.load(std::memory_order_relaxed);
+        s.late_commands = late_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    // Frames mixed so far, the timeline used by the *_at commands
+    uint64_t position() const { return position_.load(std::memory_order_acquire); }
+
+    // Audio thread entry point
+    void operator()(float* buffer, int num_frames, int num_channels) { mix(buffer, num_frames, num_channels); }
+
+    void mix(float* buffer, int num_frames, int num_channels) {
+        memset(buffer, 0, (size_t)num_frames * (size_t)num_channels * sizeof(float));
+        for (int done = 0; done < num_frames;) {
+            apply_commands();
+            // end the block early at the next scheduled command
+            int n = std::min(cfg_.block_frames, num_frames - done);
+            if (!scheduled_.empty())
+                n = (int)std::min((uint64_t)n, scheduled_.back().frame - clock_);
+            mix_block(buffer + (size_t)done * (size_t)num_channels, n, num_channels);
+            done += n;
+            clock_ += (uint64_t)n;
+        }
+        position_.store(clock_, std::memory_order_release);
+    }
+
+    const config& get_config() const { return cfg_; }
+
+private:
+    struct command {
+        enum kind : uint8_t { start, stop, gain, pan } type;
+        uint64_t frame;  // 0 = as soon as possible
+        uint16_t index;
+        uint16_t generation;
+        float value;
+        int frames;
+        sound snd;
+        voice_params params;
+    };
+
+    struct slot {
+        sound snd;
+        int pos = 0;
+        int loop_start = 0;
+        int loop_end = 0;        // > loop_start when looping
+        float gain = 0.0f;
+        float target = 0.0f;
+        float step = 0.0f;
+        int fade_left = 0;
+        float pan_l = 1.0f;
+        float pan_r = 1.0f;
+        uint16_t generation = 0;
+        bool active = false;
+        bool stopping = false;
+        float loudness = 0.0f;
+    };
+
+    void send(command::kind type, uint64_t frame, voice v, float value, int frames) {
+        command cmd = {};
+        cmd.type = type;
+        cmd.frame = frame;
+        cmd.index = (uint16_t)(v.id & 0xffff);
+        cmd.generation = (uint16_t)(v.id >> 16);
+        cmd.value = value;
+        cmd.frames = frames;
+        if (!v.valid() || !commands_.push(cmd))
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Mono sources use equal-power panning, multichannel sources a balance control
+    static void set_pan(slot& s, float pan) {
+        pan = std::min(std::max(pan, -1.0f), 1.0f);
+        if (s.snd.channels == 1) {
+            const float theta = (pan + 1.0f) * 0.785398163f;
+            s.pan_l = std::cos(theta);
+            s.pan_r = std::sin(theta);
+        } else {
+            s.pan_l = std::min(1.0f, 1.0f - pan);
+            s.pan_r = std::min(1.0f, 1.0f + pan);
+        }
+    }
+
+    static void fade_to(slot& s, float target, int frames) {
+        s.target = target;
+        if (frames > 0) {
+            s.fade_left = frames;
+            s.step = (target - s.gain) / (float)frames;
+        } else {
+            s.fade_left = 0;
+            s.gain = target;
+            s.step = 0.0f;
+        }
+    }
+
+    // Apply queued commands that are due and park future ones in scheduled_, which is kept
+    // sorted latest-first so the next one is at the back. While scheduled_ is full the rest
+    // stay queued, in order, until frames pass; the game thread's pushes then fail and are
+    // counted as dropped instead of future commands being applied early
+    void apply_commands() {
+        command cmd;
+        while (scheduled_.size() < scheduled_.capacity() && commands_.pop(cmd)) {
+            if (cmd.frame > clock_) {
+                auto later = [](const command& a, const command& b) { return a.frame > b.frame; };
+                scheduled_.insert(std::upper_bound(scheduled_.begin(), scheduled_.end(), cmd, later), cmd);
+                continue;
+            }
+            apply(cmd);
+        }
+        while (!scheduled_.empty() && scheduled_.back().frame <= clock_) {
+            apply(scheduled_.back());
+            scheduled_.pop_back();
+        }
+    }
+
+    void apply(const command& cmd) {
+        if (cmd.frame && cmd.frame < clock_)
+            late_.fetch_add(1, std::memory_order_relaxed);
+        slot& s = slots_[cmd.index];
+        if (cmd.type == command::start) {
+            const voice_params& p = cmd.params;
+            s = slot();
+            s.snd = cmd.snd;
+            s.snd.channels = std::max(s.snd.channels, 1);
+            s.generation = cmd.generation;
+            s.active = true;
+            s.pos = std::min(std::max(p.start_frame, 0), s.snd.frames);
+            if (p.loop) {
+                s.loop_start = std::min(std::max(p.loop_start, 0), s.snd.frames);
+                s.loop_end = p.loop_end > 0 ? std::min(p.loop_end, s.snd.frames) : s.snd.frames;
+                if (s.loop_end <= s.loop_start)
+                    s.loop_end = s.loop_start = 0;
+            }
+            set_pan(s, p.pan);
+            s.gain = p.fade_in_frames > 0 ? 0.0f : p.gain;
+            fade_to(s, p.gain, p.fade_in_frames);
+            live_.push_back(cmd.index);
+            return;
+        }
+        if (!s.active || s.generation != cmd.generation || s.stopping)
+            return;
+        switch (cmd.type) {
+            case command::stop:
+                s.stopping = true;
+                fade_to(s, 0.0f, cmd.frames);
+                break;
+            case command::gain: fade_to(s, cmd.value, cmd.frames); break;
+            case command::pan: set_pan(s, cmd.value); break;
+            default: break;
+        }
+    }
+
+    void mix_block(float* out, int frames, int channels) {
+        const float master = master_.load(std::memory_order_relaxed);
+        audible_.clear();
+        for (uint16_t index : live_) {
+            slot& s = slots_[index];
+            s.loudness = std::max(std::abs(s.gain), std::abs(s.target)) * std::max(s.pan_l, s.pan_r) * std::abs(master);
+            if (s.loudness >= cfg_.virtual_threshold)
+                audible_.push_back(index);
+        }
+        if (cfg_.max_audible > 0 && (int)audible_.size() > cfg_.max_audible) {
+            std::nth_element(audible_.begin(), audible_.begin() + cfg_.max_audible, audible_.end(),
+                             [this](uint16_t a, uint16_t b) { return slots_[a].loudness > slots_[b].loudness; });
+            audible_.resize((size_t)cfg_.max_audible);
+        }
+        for (uint16_t index : audible_)
+            slots_[index].loudness = -1.0f;  // marks the voice as mixed this block
+        const int active = (int)live_.size();
+        for (uint16_t index : live_) {
+            slot& s = slots_[index];
+            advance(s, s.loudness < 0.0f ? out : nullptr, frames, channels, master);
+        }
+        // retire finished voices
+        size_t n = 0;
+        for (uint16_t index : live_) {
+            if (slots_[index].active)
+                live_[n++] = index;
+            else
+                free_.push(index);
+        }
+        live_.resize(n);
+        active_count_.store(active, std::memory_order_relaxed);
+        mixed_count_.store((int)audible_.size(), std::memory_order_relaxed);
+        virtual_count_.store(active - (int)audible_.size(), std::memory_order_relaxed);
+    }
+
+    // Move a voice forward by frames, mixing into out unless it is virtual
+    static void advance(slot& s, float* out, int frames, int channels, float master) {
+        const bool looping = s.loop_end > s.loop_start;
+        while (frames > 0 && s.active) {
+            if (s.stopping && s.fade_left == 0) {
+                s.active = false;
+                break;
+            }
+            const int end = looping ? s.loop_end : s.snd.frames;
+            if (s.pos >= end) {
+                if (!looping) {
+                    s.active = false;
+                    break;
+                }
+                s.pos = s.loop_start;
+            }
+            int run = std::min(frames, end - s.pos);
+            if (s.fade_left > 0)
+                run = std::min(run, s.fade_left);
+            if (out) {
+                const float* src = s.snd.samples + (size_t)s.pos * (size_t)s.snd.channels;
+                mix_run(out, channels, src, s.snd.channels, run, s.gain * master, s.fade_left > 0 ? s.step * master : 0.0f, s.pan_l, s.pan_r);
+                out += (size_t)run * (size_t)channels;
+            }
+            s.pos += run;
+            frames -= run;
+            if (s.fade_left > 0) {
+                s.fade_left -= run;
+                s.gain = s.fade_left > 0 ? s.gain + s.step * (float)run : s.target;
+            }
+        }
+    }
+
+    // out[i][c] += src[i][*] * (g0 + step * i) * pan[c]
+    static void mix_run(float* out, int out_ch, const float* src, int src_ch, int n, float g0, float step, float pan_l, float pan_r) {
+        using namespace sokol::simd;
+        int i = 0;
+        if (out_ch == 2 && src_ch == 1) {
+            f32x4 g = set(g0, g0 + step, g0 + 2.0f * step, g0 + 3.0f * step);
+            const f32x4 g_step = splat(4.0f * step), l = splat(pan_l), r = splat(pan_r);
+            for (; i + 4 <= n; i += 4) {
+                const f32x4 a = load(src + i) * g;
+                const f32x4 al = a * l, ar = a * r;
+                store(out + 2 * i, load(out + 2 * i) + zip_lo(al, ar));
+                store(out + 2 * i + 4, load(out + 2 * i + 4) + zip_hi(al, ar));
+                g = g + g_step;
+            }
+        } else if (out_ch == 2 && src_ch == 2) {
+            f32x4 g = set(g0 * pan_l, g0 * pan_r, (g0 + step) * pan_l, (g0 + step) * pan_r);
+            const f32x4 g_step = set(2.0f * step * pan_l, 2.0f * step * pan_r, 2.0f * step * pan_l, 2.0f * step * pan_r);
+            for (; i + 2 <= n; i += 2) {
+                store(out + 2 * i, load(out + 2 * i) + load(src + 2 * i) * g);
+                g = g + g_step;
+            }
+        } else if (out_ch == 1 && src_ch == 1) {
+            f32x4 g = set(g0, g0 + step, g0 + 2.0f * step, g0 + 3.0f * step);
+            const f32x4 g_step = splat(4.0f * step);
+            for (; i + 4 <= n; i += 4) {
+                store(out + i, load(out + i) + load(src + i) * g);
+                g = g + g_step;
+            }
+        }
+        for (; i < n; i++) {
+            const float g = g0 + step * (float)i;
+            const float* in = src + (size_t)i * (size_t)src_ch;
+            float* o = out + (size_t)i * (size_t)out_ch;
+            if (out_ch == 1) {
+                float sum = 0.0f;
+                for (int c = 0; c < src_ch; c++)
+                    sum += in[c];
+                o[0] += sum * g / (float)src_ch;
+                continue;
+            }
+            o[0] += in[0] * g * pan_l;
+            o[1] += in[src_ch > 1 ? 1 : 0] * g * pan_r;
+            if (src_ch == out_ch)
+                for (int c = 2; c < out_ch; c++)
+                    o[c] += in[c] * g;
+        }
+    }
+
+    config cfg_;
+    std::vector<slot> slots_;
+    std::vector<uint16_t> generations_;  // game thread
+    std::vector<uint16_t> live_;         // audio thread
+    std::vector<uint16_t> audible_;      // audio thread
+    std::vector<command> scheduled_;     // audio thread
+    uint64_t clock_ = 0;                 // audio thread
+    sokol::spsc_queue<command> commands_;
+    sokol::spsc_queue<uint16_t> free_;
+    std::atomic<float> master_{1.0f};
+    std::atomic<int> active_count_{0};
+    std::atomic<int> mixed_count_{0};
+    std::atomic<int> virtual_count_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> position_{0};
+};
+
+// Streaming polyphase FIR resampler for interleaved float audio with any channel count.
+// Kaiser-windowed sinc phases are interpolated linearly, the dot products run 4-wide.
+// set_pitch() rescales the rate per instance (one per voice) without redesigning the
+// filter; the cutoff leaves room for pitches up to max_pitch.
+class resampler {
+public:
+    enum class quality {
+        fast,      // 8 taps, 32 phases
+        balanced,  // 16 taps, 64 phases
+        high,      // 32 taps, 256 phases
+        best,      // 64 taps, 512 phases
+    };
+
+    struct result {
+        int consumed = 0;  // input frames taken
+        int produced = 0;  // output frames written
+    };
+
+    resampler() = default;
+    resampler(int channels, double in_rate, double out_rate, quality q = quality::balanced, float max_pitch = 1.0f, int max_block_frames = 1024) {
+        reset(channels, in_rate, out_rate, q, max_pitch, max_block_frames);
+    }
+
+    // Allocates; call before the audio thread uses the resampler
+    void reset(int channels, double in_rate, double out_rate, quality q = quality::balanced, float max_pitch = 1.0f, int max_block_frames = 1024) {
+        static const int taps_of[] = {8, 16, 32, 64};
+        static const int phases_of[] = {32, 64, 256, 512};
+        static const double beta_of[] = {5.0, 6.5, 8.5, 10.5};
+        static const double rolloff_of[] = {0.85, 0.9, 0.94, 0.97};
+        channels_ = std::max(channels, 1);
+        taps_ = taps_of[(int)q];
+        phases_ = phases_of[(int)q];
+        quality_ = q;
+        base_step_ = in_rate / out_rate;
+        step_ = base_step_ * pitch_.load(std::memory_order_relaxed);
+        cap_ = taps_ + std::max(max_block_frames, 16);
+        history_.assign((size_t)channels_ * (size_t)cap_, 0.0f);
+        scratch_.assign((size_t)channels_ * (size_t)cap_, 0.0f);
+        design(std::min(1.0, 1.0 / (base_step_ * std::max(max_pitch, 1.0f))) * rolloff_of[(int)q], beta_of[(int)q]);
+        clear();
+    }
+
+    // Drop buffered input and start over with silence
+    void clear() {
+        std::fill(history_.begin(), history_.end(), 0.0f);
+        len_ = taps_ / 2 - 1;
+        pos_ = 0.0;
+    }
+
+    // Playback speed factor; safe to call from another thread
+    void set_pitch(float pitch) { pitch_.store(pitch, std::memory_order_relaxed); }
+    float pitch() const { return pitch_.load(std::memory_order_relaxed); }
+
+    int channels() const { return channels_; }
+    int taps() const { return taps_; }
+    quality get_quality() const { return quality_; }
+    double ratio() const { return 1.0 / base_step_; }
+    // Input frames the filter looks ahead of the current output position
+    int latency() const { return taps_ / 2; }
+
+    // Consume interleaved input and write interleaved output until either side runs out
+    result process(const float* in, int in_frames, float* out, int out_frames) {
+        result r;
+        step_ = base_step_ * (double)pitch_.load(std::memory_order_relaxed);
+        for (;;) {
+            r.produced += produce(out + (size_t)r.produced * (size_t)channels_, out_frames - r.produced);
+            if (r.consumed == in_frames || r.produced == out_frames)
+                break;
+            const int n = std::min(in_frames - r.consumed, cap_ - len_);
+            append(in + (size_t)r.consumed * (size_t)channels_, n);
+            r.consumed += n;
+        }
+        return r;
+    }
+
+    // Fill out_frames output frames, pulling input on demand from source(float* frames, int num_frames)
+    template <typename F>
+    int pull(float* out, int out_frames, F&& source) {
+        step_ = base_step_ * (double)pitch_.load(std::memory_order_relaxed);
+        int produced = 0;
+        for (;;) {
+            produced += produce(out + (size_t)produced * (size_t)channels_, out_frames - produced);
+            if (produced == out_frames)
+                break;
+            const int need = (int)std::ceil(pos_ + (double)(out_frames - produced) * step_) + taps_ - len_;
+            const int n = std::min(std::max(need, 1), cap_ - len_);
+            source(scratch_.data(), n);
+            append(scratch_.data(), n);
+        }
+        return produced;
+    }
+
+private:
+    static double bessel_i0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 64; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12)
+                break;
+        }
+        return sum;
+    }
+
+    // phases + 1 rows of taps coefficients, each followed by its difference to the next row
+    void design(double cutoff, double beta) {
+        const int half = taps_ / 2;
+        coeffs_.assign((size_t)(phases_ + 1) * (size_t)taps_ * 2, 0.0f);
+        std::vector<double> row((size_t)taps_);
+        std::vector<float> rows((size_t)(phases_ + 1) * (size_t)taps_);
+        const double i0_beta = bessel_i0(beta);
+        for (int p = 0; p <= phases_; p++) {
+            const double frac = (double)p / (double)phases_;
+            double sum = 0.0;
+            for (int k = 0; k < taps_; k++) {
+                const double x = (double)(k - half + 1) - frac;
+                const double t = x / (double)half;
+                const double w = std::fabs(t) < 1.0 ? bessel_i0(beta * std::sqrt(1.0 - t * t)) / i0_beta : 0.0;
+                const double a = 3.14159265358979323846 * cutoff * x;
+                row[(size_t)k] = cutoff * (std::fabs(a) < 1e-9 ? 1.0 : std::sin(a) / a) * w;
+                sum += row[(size_t)k];
+            }
+            for (int k = 0; k < taps_; k++)
+                rows[(size_t)p * (size_t)taps_ + (size_t)k] = (float)(row[(size_t)k] / sum);
+        }
+        for (int p = 0; p <= phases_; p++) {
+            float* dst = coeffs_.data() + (size_t)p * (size_t)taps_ * 2;
+            const float* c0 = rows.data() + (size_t)p * (size_t)taps_;
+            const float* c1 = p < phases_ ? c0 + taps_ : c0;
+            for (int k = 0; k < taps_; k++) {
+                dst[k] = c0[k];
+                dst[taps_ + k] = c1[k] - c0[k];
+            }
+        }
+    }
+
+    // Deinterleave into the per-channel history
+    void append(const float* in, int frames) {
+        for (int c = 0; c < channels_; c++) {
+            float* dst = history_.data() + (size_t)c * (size_t)cap_ + (size_t)len_;
+            for (int i = 0; i < frames; i++)
+                dst[i] = in[(size_t)i * (size_t)channels_ + (size_t)c];
+        }
+        len_ += frames;
+    }
+
+    int produce(float* out, int max_frames) {
+        using namespace sokol::simd;
+        int n = 0;
+        while (n < max_frames) {
+            const int i = (int)pos_;
+            if (i + taps_ > len_)
+                break;
+            const double phase = (pos_ - (double)i) * (double)phases_;
+            const int p = (int)phase;
+            const f32x4 f = splat((float)(phase - (double)p));
+            const float* c = coeffs_.data() + (size_t)p * (size_t)taps_ * 2;
+            const float* d = c + taps_;
+            for (int ch = 0; ch < channels_; ch++) {
+                const float* x = history_.data() + (size_t)ch * (size_t)cap_ + (size_t)i;
+                f32x4 acc = splat(0.0f);
+                for (int k = 0; k < taps_; k += 4)
+                    acc = acc + load(x + k) * (load(c + k) + f * load(d + k));
+                out[(size_t)n * (size_t)channels_ + (size_t)ch] = hsum(acc);
+            }
+            pos_ += step_;
+            n++;
+        }
+        // keep only the history still needed
+        const int drop = std::min((int)pos_, len_);
+        if (drop > 0) {
+            for (int ch = 0; ch < channels_; ch++) {
+                float* h = history_.data() + (size_t)ch * (size_t)cap_;
+                memmove(h, h + drop, (size_t)(len_ - drop) * sizeof(float));
+            }
+            len_ -= drop;
+            pos_ -= (double)drop;
+        }
+        return n;
+    }
+
+    int channels_ = 1;
+    int taps_ = 16;
+    int phases_ = 64;
+    quality quality_ = quality::balanced;
+    int cap_ = 0;
+    int len_ = 0;      // buffered input frames per channel
+    double pos_ = 0.0; // next output position in history frames
+    double base_step_ = 1.0;
+    double step_ = 1.0;
+    std::atomic<float> pitch_{1.0f};
+    std::vector<float> history_;  // channels_ rows of cap_ frames
+    std::vector<float> scratch_;
+    std::vector<float> coeffs_;
+};
+
+// Stream callback that resamples a source running at source_rate to the rate saudio
+// negotiated. The filter is (re)designed on the audio thread the first time the device
+// rate is seen, so that one callback allocates.
+template <typename F>
+class resample_stream {
+public:
+    resample_stream(F& source, int source_rate, resampler::quality q = resampler::quality::balanced, float max_pitch = 1.0f)
+        : source_(source), source_rate_(source_rate), quality_(q), max_pitch_(max_pitch) {}
+    resample_stream(const resample_stream&) = delete;
+    resample_stream& operator=(const resample_stream&) = delete;
+
+    desc& install(desc& d) {
+        d.sample_rate(source_rate_);
+        return bind(d, *this);
+    }
+
+    void set_pitch(float pitch) { rs_.set_pitch(pitch); }
+    resampler& get() { return rs_; }
+
+    void operator()(float* buffer, int num_frames, int num_channels) {
+        const int rate = saudio::sample_rate();
+        if (rate != device_rate_ || num_channels != rs_.channels()) {
+            device_rate_ = rate;
+            rs_.reset(num_channels, (double)source_rate_, (double)rate, quality_, max_pitch_, num_frames);
+        }
+        rs_.pull(buffer, num_frames, [this, num_channels](float* frames, int n) { source_(frames, n, num_channels); });
+    }
+
+private:
+    F& source_;
+    int source_rate_;
+    resampler::quality quality_;
+    float max_pitch_;
+    int device_rate_ = 0;
+    resampler rs_;
+};
+
+// Read-only memory mapping of a whole file
+class mapped_file {
+public:
+    mapped_file() = default;
+    explicit mapped_file(const char* path) { open(path); }
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file(mapped_file&& other) noexcept { *this = std::move(other); }
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = other.data_;
+            size_ = other.size_;
+#if defined(_WIN32)
+            mapping_ = other.mapping_;
+            other.mapping_ = nullptr;
+#endif
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+    ~mapped_file() { close(); }
+
+    bool open(const char* path) {
+        close();
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+            mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping_)
+            return false;
+        data_ = (const uint8_t*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (!data_) {
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+            return false;
+        }
+        size_ = (size_t)size.QuadPart;
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+            p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return false;
+        data_ = (const uint8_t*)p;
+        size_ = (size_t)st.st_size;
+#endif
+        return true;
+    }
+
+    void close() {
+        if (!data_)
+            return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+#else
+        munmap((void*)data_, size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    // Hint that a range will be read soon
+    void prefetch(size_t offset, size_t size) const {
+#if !defined(_WIN32)
+        if (!data_ || offset >= size_)
+            return;
+        const size_t page = 4096;
+        const size_t begin = offset & ~(page - 1);
+        const size_t end = std::min(offset + size, size_);
+        madvise((void*)(data_ + begin), end - begin, MADV_WILLNEED);
+#else
+        (void)offset;
+        (void)size;
+#endif
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool is_open() const { return data_ != nullptr; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+// Layout of little-endian interleaved PCM data
+struct pcm_format {
+    enum class encoding { s16, s24, s32, f32 };
+
+    encoding enc = encoding::s16;
+    int channels = 2;
+    int sample_rate = 44100;
+    size_t data_offset = 0;
+    int64_t frames = 0;  // derived from the data size when 0
+
+    int bytes_per_sample() const {
+        switch (enc) {
+            case encoding::s16: return 2;
+            case encoding::s24: return 3;
+            default: return 4;
+        }
+    }
+    int bytes_per_frame() const { return bytes_per_sample() * channels; }
+
+    // Read the fmt and data chunks of a RIFF/WAVE file (PCM 16/24/32-bit, IEEE float 32-bit,
+    // plain or WAVE_FORMAT_EXTENSIBLE)
+    static bool parse_wav(const uint8_t* data, size_t size, pcm_format& out) {
+        auto u16 = [](const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8); };
+        auto u32 = [](const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); };
+        if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+            return false;
+        bool have_fmt = false;
+        size_t pos = 12;
+        while (pos + 8 <= size) {
+            const uint8_t* chunk = data + pos;
+            const size_t chunk_size = u32(chunk + 4);
+            const uint8_t* body = chunk + 8;
+            if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && pos + 8 + 16 <= size) {
+                uint32_t tag = u16(body);
+                if (tag == 0xfffe && chunk_size >= 40 && pos + 8 + 26 <= size)
+                    tag = u16(body + 24);  // sub-format GUID of WAVE_FORMAT_EXTENSIBLE
+                const uint32_t bits = u16(body + 14);
+                out.channels = (int)u16(body + 2);
+                out.sample_rate = (int)u32(body + 4);
+                if (tag == 1 && bits == 16)
+                    out.enc = encoding::s16;
+                else if (tag == 1 && bits == 24)
+                    out.enc = encoding::s24;
+                else if (tag == 1 && bits == 32)
+                    out.enc = encoding::s32;
+                else if (tag == 3 && bits == 32)
+                    out.enc = encoding::f32;
+                else
+                    return false;
+                have_fmt = out.channels > 0;
+            } else if (memcmp(chunk, "data", 4) == 0 && have_fmt) {
+                out.data_offset = pos + 8;
+                const size_t avail = std::min(chunk_size, size - out.data_offset);
+                out.frames = (int64_t)(avail / (size_t)out.bytes_per_frame());
+                return true;
+            }
+            pos += 8 + chunk_size + (chunk_size & 1);
+        }
+        return false;
+    }
+};
+
+// Convert little-endian integer or float samples to float in [-1, 1)
+inline void pcm_to_float(pcm_format::encoding enc, const uint8_t* src, float* dst, size_t samples) {
+    size_t i = 0;
+    switch (enc) {
+        case pcm_format::encoding::s16: {
+            const float scale = 1.0f / 32768.0f;
+#if defined(SOKOL_SIMD_SSE2)
+            const __m128 s = _mm_set1_ps(scale);
+            for (; i + 8 <= samples; i += 8) {
+                const __m128i x = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+                const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+                const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), s));
+                _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), s));
+            }
+#elif defined(SOKOL_SIMD_NEON)
+            for (; i + 8 <= samples; i += 8) {
+                const int16x8_t x = vreinterpretq_s16_u8(vld1q_u8(src + 2 * i));
+                vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), scale));
+                vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), scale));
+            }
+#endif
+            for (; i < samples; i++)
+                dst[i] = (float)(int16_t)(src[2 * i] | (src[2 * i + 1] << 8)) * scale;
+            break;
+        }
+        case pcm_format::encoding::s24: {
+            // samples are placed in the top 24 bits of an int32
+            const float scale = 1.0f / 2147483648.0f;
+#if defined(SOKOL_SIMD_SSE2) && defined(__SSSE3__)
+            const __m128i shuffle = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            const __m128 s = _mm_set1_ps(scale);
+            for (; i + 6 <= samples; i += 4) {
+                const __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + 3 * i)), shuffle);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(x), s));
+            }
+#elif defined(SOKOL_SIMD_NEON)
+            for (; i + 8 <= samples; i += 8) {
+                const uint8x8x3_t b = vld3_u8(src + 3 * i);
+                const uint16x8_t lo = vshll_n_u8(b.val[0], 8);
+                const uint16x8_t hi = vorrq_u16(vmovl_u8(b.val[1]), vshll_n_u8(b.val[2], 8));
+                const int32x4_t a = vreinterpretq_s32_u32(vorrq_u32(vmovl_u16(vget_low_u16(lo)), vshll_n_u16(vget_low_u16(hi), 16)));
+                const int32x4_t c = vreinterpretq_s32_u32(vorrq_u32(vmovl_u16(vget_high_u16(lo)), vshll_n_u16(vget_high_u16(hi), 16)));
+                vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(a), scale));
+                vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(c), scale));
+            }
+#elif defined(SOKOL_SIMD_SSE2)
+            const __m128 s = _mm_set1_ps(scale);
+            for (; i + 4 <= samples; i += 4) {
+                const uint8_t* p = src + 3 * i;
+                const __m128i x = _mm_setr_epi32((int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)),
+                                                 (int32_t)(((uint32_t)p[3] << 8) | ((uint32_t)p[4] << 16) | ((uint32_t)p[5] << 24)),
+                                                 (int32_t)(((uint32_t)p[6] << 8) | ((uint32_t)p[7] << 16) | ((uint32_t)p[8] << 24)),
+                                                 (int32_t)(((uint32_t)p[9] << 8) | ((uint32_t)p[10] << 16) | ((uint32_t)p[11] << 24)));
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(x), s));
+            }
+#endif
+            for (; i < samples; i++) {
+                const uint8_t* p = src + 3 * i;
+                dst[i] = (float)(int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) * scale;
+            }
+            break;
+        }
+        case pcm_format::encoding::s32: {
+            const float scale = 1.0f / 2147483648.0f;
+#if defined(SOKOL_SIMD_SSE2)
+            const __m128 s = _mm_set1_ps(scale);
+            for (; i + 4 <= samples; i += 4)
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(src + 4 * i))), s));
+#elif defined(SOKOL_SIMD_NEON)
+            for (; i + 4 <= samples; i += 4)
+                vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u8(vld1q_u8(src + 4 * i))), scale));
+#endif
+            for (; i < samples; i++) {
+                int32_t v;
+                memcpy(&v, src + 4 * i, 4);
+                dst[i] = (float)v * scale;
+            }
+            break;
+        }
+        case pcm_format::encoding::f32:
+            memcpy(dst, src, samples * sizeof(float));
+            break;
+    }
+}
+
+// Streams a memory-mapped WAV or raw PCM file into the stream callback. A prefetch thread
+// converts fixed-size blocks into a wait-free ring ahead of the audio thread, so the audio
+// thread never touches the file mapping. Seeks are sample-accurate: blocks decoded before
+// a seek are discarded by the consumer and decoding restarts at the exact frame.
+// The ring is allocated once by the constructor, so files can be closed and opened while
+// the callback is installed; blocks of the previous file are discarded the same way.
+class file_stream {
+public:
+    struct config {
+        int block_frames = 4096;
+        int num_blocks = 8;        // blocks decoded ahead of the callback
+        int max_channels = 2;      // files with more channels are rejected
+        bool loop = false;
+        int poll_interval_ms = 2;  // how often the prefetch thread checks a full ring
+    };
+
+    file_stream() : file_stream(config()) {}
+    explicit file_stream(const config& cfg) : cfg_(cfg) {
+        cfg_.block_frames = std::max(cfg_.block_frames, 64);
+        cfg_.num_blocks = std::max(cfg_.num_blocks, 2);
+        cfg_.max_channels = std::max(cfg_.max_channels, 1);
+        blocks_.resize((size_t)cfg_.num_blocks);
+        for (auto& b : blocks_)
+            b.samples.resize((size_t)cfg_.block_frames * (size_t)cfg_.max_channels);
+        remap_.resize((size_t)cfg_.block_frames * (size_t)cfg_.max_channels);
+    }
+    file_stream(const file_stream&) = delete;
+    file_stream& operator=(const file_stream&) = delete;
+    ~file_stream() { close(); }
+
+    bool open_wav(const char* path) {
+        close();
+        pcm_format fmt;
+        if (!file_.open(path) || !pcm_format::parse_wav(file_.data(), file_.size(), fmt) || fmt.channels > cfg_.max_channels) {
+            file_.close();
+            return false;
+        }
+        return start(fmt);
+    }
+
+    // Headerless PCM; fmt.frames of 0 means up to the end of the file
+    bool open_raw(const char* path, const pcm_format& fmt) {
+        close();
+        if (!file_.open(path) || fmt.channels <= 0 || fmt.channels > cfg_.max_channels || fmt.data_offset > file_.size()) {
+            file_.close();
+            return false;
+        }
+        pcm_format f = fmt;
+        const int64_t avail = (int64_t)((file_.size() - f.data_offset) / (size_t)f.bytes_per_frame());
+        f.frames = f.frames > 0 ? std::min(f.frames, avail) : avail;
+        return start(f);
+    }
+
+    // Safe while the stream callback is installed: the blocks still in the ring are
+    // discarded like after a seek, so the callback drains to silence
+    void close() {
+        if (thread_.joinable()) {
+            running_.store(false, std::memory_order_release);
+            thread_.join();
+        }
+        const uint32_t epoch = epoch_.fetch_add(1, std::memory_order_relaxed) + 1;
+        eof_epoch_.store(epoch, std::memory_order_release);
+        file_.close();
+    }
+
+    // Set the desc's rate and channel count to the file's and route the stream callback here
+    desc& install(desc& d) {
+        d.sample_rate(fmt_.sample_rate).num_channels(fmt_.channels);
+        return bind(d, *this);
+    }
+
+    // Any non-audio thread
+    void seek(int64_t frame) {
+        seek_frame_.store(std::min(std::max(frame, (int64_t)0), fmt_.frames), std::memory_order_relaxed);
+        epoch_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Audio thread: read frames interleaved in the file's channel layout, zero-filling past
+    // the end or on underrun; returns the frames that came from the file
+    int read(float* out, int frames) {
+        const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+        return read(out, frames, epoch, channels_.load(std::memory_order_relaxed));
+    }
+
+    // Audio thread entry point; mono files are copied to every output channel, and a mono
+    // output gets the average of the file's channels
+    void operator()(float* buffer, int num_frames, int num_channels) {
+        // the epoch is loaded first, start() publishes the channel count before bumping it
+        const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+        const int ch = channels_.load(std::memory_order_relaxed);
+        if (num_channels == ch || ch == 0) {
+            if (num_channels == ch)
+                read(buffer, num_frames, epoch, ch);
+            else
+                memset(buffer, 0, (size_t)num_frames * (size_t)num_channels * sizeof(float));
+            return;
+        }
+        float* tmp = remap_.data();
+        const int chunk = (int)(remap_.size() / (size_t)ch);
+        for (int done = 0; done < num_frames; done += chunk) {
+            const int n = std::min(chunk, num_frames - done);
+            read(tmp, n, epoch, ch);
+            float* out = buffer + (size_t)done * (size_t)num_channels;
+            for (int i = 0; i < n; i++) {
+                const float* in = tmp + (size_t)i * (size_t)ch;
+                if (num_channels == 1) {
+                    float sum = 0.0f;
+                    for (int c = 0; c < ch; c++)
+                        sum += in[c];
+                    out[i] = sum / (float)ch;
+                } else {
+                    for (int c = 0; c < num_channels; c++)
+                        out[(size_t)i * (size_t)num_channels + (size_t)c] = c < ch ? in[c] : (ch == 1 ? in[0] : 0.0f);
+                }
+            }
+        }
+    }
+
+    const pcm_format& format() const { return fmt_; }
+    int64_t length() const { return fmt_.frames; }
+    // Frame the audio thread has played up to
+    int64_t position() const { return position_.load(std::memory_order_relaxed); }
+    bool finished() const {
+        const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+        return eof_epoch_.load(std::memory_order_acquire) == epoch && read_.load(std::memory_order_acquire) == write_.load(std::memory_order_acquire);
+    }
+    uint64_t underruns() const { return underruns_.load(std::memory_order_relaxed); }
+    bool is_open() const { return file_.is_open(); }
+
+private:
+    struct block {
+        std::vector<float> samples;
+        int64_t start = 0;
+        int frames = 0;
+        uint32_t epoch = 0;
+    };
+
+    int read(float* out, int frames, uint32_t epoch, int ch) {
+        int done = 0;
+        while (done < frames) {
+            const uint64_t r = read_.load(std::memory_order_relaxed);
+            if (r == write_.load(std::memory_order_acquire)) {
+                if (eof_epoch_.load(std::memory_order_acquire) != epoch)
+                    underruns_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            const block& b = blocks_[r % blocks_.size()];
+            // a block from a newer epoch than this callback's is left for the next one
+            if ((int32_t)(b.epoch - epoch) > 0)
+                break;
+            if (b.epoch != epoch) {
+                read_.store(r + 1, std::memory_order_release);
+                offset_ = 0;
+                continue;
+            }
+            const int n = std::min(frames - done, b.frames - offset_);
+            memcpy(out + (size_t)done * (size_t)ch, b.samples.data() + (size_t)offset_ * (size_t)ch, (size_t)n * (size_t)ch * sizeof(float));
+            done += n;
+            offset_ += n;
+            position_.store(b.start + offset_, std::memory_order_relaxed);
+            if (offset_ == b.frames) {
+                read_.store(r + 1, std::memory_order_release);
+                offset_ = 0;
+            }
+        }
+        memset(out + (size_t)done * (size_t)ch, 0, (size_t)(frames - done) * (size_t)ch * sizeof(float));
+        return done;
+    }
+
+    // The ring indices and the audio thread's offset_ are left alone; the new epoch makes
+    // the callback skip whatever close() left in the ring
+    bool start(const pcm_format& fmt) {
+        fmt_ = fmt;
+        position_.store(0, std::memory_order_relaxed);
+        underruns_.store(0, std::memory_order_relaxed);
+        seek_frame_.store(0, std::memory_order_relaxed);
+        channels_.store(fmt_.channels, std::memory_order_relaxed);
+        epoch_.fetch_add(1, std::memory_order_release);
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread([this] { prefetch(); });
+        return true;
+    }
+
+    void prefetch() {
+        const size_t frame_bytes = (size_t)fmt_.bytes_per_frame();
+        const uint8_t* base = file_.data() + fmt_.data_offset;
+        uint32_t epoch = UINT32_MAX;
+        int64_t cursor = 0;
+        while (running_.load(std::memory_order_acquire)) {
+            const uint32_t e = epoch_.load(std::memory_order_acquire);
+            if (e != epoch) {
+                epoch = e;
+                cursor = seek_frame_.load(std::memory_order_relaxed);
+            }
+            const uint64_t w = write_.load(std::memory_order_relaxed);
+            const bool full = w - read_.load(std::memory_order_acquire) >= blocks_.size();
+            if (cursor >= fmt_.frames && cfg_.loop && fmt_.frames > 0)
+                cursor = 0;
+            if (full || cursor >= fmt_.frames) {
+                if (cursor >= fmt_.frames)
+                    eof_epoch_.store(epoch, std::memory_order_release);
+                std::this_thread::sleep_for(std::chrono::milliseconds(cfg_.poll_interval_ms));
+                continue;
+            }
+            block& b = blocks_[w % blocks_.size()];
+            b.start = cursor;
+            b.frames = (int)std::min((int64_t)cfg_.block_frames, fmt_.frames - cursor);
+            b.epoch = epoch;
+            pcm_to_float(fmt_.enc, base + (size_t)cursor * frame_bytes, b.samples.data(), (size_t)b.frames * (size_t)fmt_.channels);
+            write_.store(w + 1, std::memory_order_release);
+            cursor += b.frames;
+            file_.prefetch(fmt_.data_offset + (size_t)cursor * frame_bytes, (size_t)cfg_.block_frames * frame_bytes * 2);
+        }
+    }
+
+    mapped_file file_;
+    pcm_format fmt_;
+    config cfg_;
+    std::vector<block> blocks_;
+    std::vector<float> remap_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    int offset_ = 0;  // audio thread, frames consumed from the current block
+    alignas(64) std::atomic<uint64_t> write_{0};
+    alignas(64) std::atomic<uint64_t> read_{0};
+    std::atomic<int64_t> position_{0};
+    std::atomic<uint64_t> underruns_{0};
+    alignas(64) std::atomic<uint32_t> epoch_{0};
+    std::atomic<int> channels_{0};  // fmt_.channels for the audio thread, 0 before the first open
+    std::atomic<int64_t> seek_frame_{0};
+    std::atomic<uint32_t> eof_epoch_{0};
+};
+
+#ifndef SOKOL_NO_STM
+// Wraps a stream callable and timestamps every callback with stm_now(). The audio thread
+// only pushes fixed-size records into a wait-free queue; collect() on any other thread
+// drains them into a bounded history and running statistics for export. Call stm_setup()
+// before the stream starts.
+template <typename F>
+class monitor {
+public:
+    struct record {
+        uint64_t start = 0;     // stm_now() on entry
+        uint64_t duration = 0;  // ticks spent in the callback
+        uint64_t interval = 0;  // ticks since the previous entry, 0 for the first
+        int frames = 0;
+        int channels = 0;
+        int fill = -1;          // watched ring frames queued on entry, -1 without one
+        uint64_t underruns = 0; // watched ring underruns after the callback
+    };
+
+    struct stats {
+        uint64_t callbacks = 0;
+        uint64_t late = 0;           // callbacks that took longer than one buffer period
+        uint64_t underruns = 0;
+        uint64_t dropped_records = 0;
+        double buffer_period_ms = 0; // buffer_frames / sample_rate
+        double mean_ms = 0;
+        double p99_ms = 0;
+        double max_ms = 0;
+        double load = 0;             // mean duration over mean callback period
+        double jitter_ms = 0;        // standard deviation of the interval between callbacks
+        int min_fill = -1;
+    };
+
+    explicit monitor(F& fn, size_t capacity = 4096) : fn_(fn), records_(capacity), history_(capacity ? capacity : 1) {}
+    monitor(const monitor&) = delete;
+    monitor& operator=(const monitor&) = delete;
+
+    // Route the desc's stream callback through the monitor into fn
+    desc& install(desc& d) { return bind(d, *this); }
+
+    // Sample fill level and underruns of a ring the callback drains
+    void watch(const spsc_ring* ring) { ring_.store(ring, std::memory_order_release); }
+
+    // Audio thread entry point
+    void operator()(float* buffer, int num_frames, int num_channels) {
+        record r;
+        r.start = stm_now();
+        r.interval = last_start_ ? r.start - last_start_ : 0;
+        last_start_ = r.start;
+        r.frames = num_frames;
+        r.channels = num_channels;
+        const spsc_ring* ring = ring_.load(std::memory_order_acquire);
+        if (ring)
+            r.fill = ring->available();
+        fn_(buffer, num_frames, num_channels);
+        if (ring)
+            r.underruns = ring->underruns();
+        r.duration = stm_diff(stm_now(), r.start);
+        if (!records_.push(r))
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Reader thread: move pending records into the history and statistics; fn(const record&)
+    // sees each one
+    template <typename Fn>
+    size_t collect(Fn&& fn) {
+        if (!sample_rate_)
+            sample_rate_ = saudio::sample_rate();
+        if (!buffer_frames_)
+            buffer_frames_ = saudio::buffer_frames();
+        size_t n = 0;
+        record r;
+        while (records_.pop(r)) {
+            add(r);
+            fn(r);
+            n++;
+        }
+        return n;
+    }
+    size_t collect() {
+        return collect([](const record&) {});
+    }
+
+    stats query_stats() const {
+        stats s;
+        s.callbacks = callbacks_;
+        s.late = late_;
+        s.underruns = underruns_;
+        s.dropped_records = dropped_.load(std::memory_order_relaxed);
+        s.buffer_period_ms = sample_rate_ ? 1000.0 * (double)buffer_frames_ / (double)sample_rate_ : 0.0;
+        s.mean_ms = callbacks_ ? stm_ms(duration_sum_) / (double)callbacks_ : 0.0;
+        s.p99_ms = stm_ms(std::min(durations_.percentile(99.0), max_duration_));
+        s.max_ms = stm_ms(max_duration_);
+        s.load = interval_sum_ ? (double)duration_sum_ * (double)intervals_ / ((double)interval_sum_ * (double)callbacks_) : 0.0;
+        if (intervals_ > 1) {
+            const double mean = interval_ms_sum_ / (double)intervals_;
+            s.jitter_ms = std::sqrt(std::max(interval_ms_sq_sum_ / (double)intervals_ - mean * mean, 0.0));
+        }
+        s.min_fill = min_fill_;
+        return s;
+    }
+
+    // Oldest first
+    size_t size() const { return count_; }
+    const record& at(size_t i) const { return history_[(next_ + history_.size() - count_ + i) % history_.size()]; }
+
+    void write_csv(FILE* out) const {
+        fprintf(out, "start_ms,duration_ms,interval_ms,budget_ms,frames,fill,underruns\n");
+        for (size_t i = 0; i < count_; i++) {
+            const record& r = at(i);
+            fprintf(out, "%.6f,%.6f,%.6f,%.6f,%d,%d,%llu\n", stm_ms(r.start), stm_ms(r.duration), stm_ms(r.interval),
+                    budget_ms(r), r.frames, r.fill, (unsigned long long)r.underruns);
+        }
+    }
+
+    void write_json(FILE* out) const {
+        const stats s = query_stats();
+        fprintf(out, "{\n  \"callbacks\": %llu, \"late\": %llu, \"underruns\": %llu, \"dropped_records\": %llu,\n",
+                (unsigned long long)s.callbacks, (unsigned long long)s.late, (unsigned long long)s.underruns, (unsigned long long)s.dropped_records);
+        fprintf(out, "  \"buffer_period_ms\": %.10g, \"mean_ms\": %.10g, \"p99_ms\": %.10g, \"max_ms\": %.10g, \"load\": %.10g, \"jitter_ms\": %.10g, \"min_fill\": %d,\n",
+                s.buffer_period_ms, s.mean_ms, s.p99_ms, s.max_ms, s.load, s.jitter_ms, s.min_fill);
+        fprintf(out, "  \"records\": [\n");
+        for (size_t i = 0; i < count_; i++) {
+            const record& r = at(i);
+            fprintf(out, "    {\"start_ms\": %.10g, \"duration_ms\": %.10g, \"interval_ms\": %.10g, \"frames\": %d, \"fill\": %d, \"underruns\": %llu}%s\n",
+                    stm_ms(r.start), stm_ms(r.duration), stm_ms(r.interval), r.frames, r.fill, (unsigned long long)r.underruns,
+                    i + 1 < count_ ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+
+private:
+    // Deadline of one callback: the buffer period (buffer_frames / sample_rate), or the audio
+    // the callback produced while buffer_frames is unknown
+    double budget_ms(const record& r) const {
+        const int frames = buffer_frames_ ? buffer_frames_ : r.frames;
+        return sample_rate_ ? 1000.0 * (double)frames / (double)sample_rate_ : 0.0;
+    }
+
+    void add(const record& r) {
+        history_[next_] = r;
+        next_ = (next_ + 1) % history_.size();
+        if (count_ < history_.size())
+            count_++;
+        callbacks_++;
+        duration_sum_ += r.duration;
+        max_duration_ = std::max(max_duration_, r.duration);
+        durations_.add(r.duration);
+        if (sample_rate_ && stm_ms(r.duration) > budget_ms(r))
+            late_++;
+        if (r.interval) {
+            const double ms = stm_ms(r.interval);
+            interval_sum_ += r.interval;
+            interval_ms_sum_ += ms;
+            interval_ms_sq_sum_ += ms * ms;
+            intervals_++;
+        }
+        if (r.fill >= 0)
+            min_fill_ = min_fill_ < 0 ? r.fill : std::min(min_fill_, r.fill);
+        underruns_ = std::max(underruns_, r.underruns);
+    }
+
+    F& fn_;
+    sokol::spsc_queue<record> records_;
+    std::atomic<const spsc_ring*> ring_{nullptr};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t last_start_ = 0;  // audio thread
+    // reader thread
+    std::vector<record> history_;
+    size_t next_ = 0;
+    size_t count_ = 0;
+    int sample_rate_ = 0;
+    int buffer_frames_ = 0;
+    uint64_t callbacks_ = 0;
+    uint64_t late_ = 0;
+    uint64_t underruns_ = 0;
+    uint64_t duration_sum_ = 0;
+    uint64_t max_duration_ = 0;
+    uint64_t interval_sum_ = 0;
+    uint64_t intervals_ = 0;
+    double interval_ms_sum_ = 0.0;
+    double interval_ms_sq_sum_ = 0.0;
+    int min_fill_ = -1;
+    stm::histogram durations_;
+};
+#endif // SOKOL_NO_STM
+
+// Block-based DSP graph. Nodes are created and wired on the game thread; commit() sorts the
+// nodes feeding the output topologically, assigns scratch buffers by lifetime so only a few
+// blocks stay hot in cache, and publishes the compiled plan to the audio thread with an atomic
+// swap. Nodes whose inputs have been silent for longer than their tail, and bypassed nodes,
+// are skipped. Node parameters are atomics so they can be changed from any thread.
+class graph {
+public:
+    class node {
+    public:
+        virtual ~node() = default;
+
+        // Called once by graph::add() before the node is used
+        virtual void prepare(int sample_rate, int block_frames, int channels) {
+            (void)sample_rate;
+            (void)block_frames;
+            (void)channels;
+        }
+        // Input ports; each port receives the sum of everything connected to it
+        virtual int num_inputs() const { return 1; }
+        // Frames the node keeps producing sound after its inputs fall silent
+        virtual int tail_frames() const { return 0; }
+        // Write one block of interleaved output; return false if it is silent
+        virtual bool process(const float* const* inputs, float* output, int frames, int channels) = 0;
+
+        void set_bypass(bool bypass) { bypass_.store(bypass, std::memory_order_relaxed); }
+        bool bypassed() const { return bypass_.load(std::memory_order_relaxed); }
+
+        void set_name(const char* name) { name_ = name ? name : ""; }
+        const char* name() const { return name_.c_str(); }
+
+        // Time spent in process(), and blocks processed or skipped
+        uint64_t cost_ticks() const { return cost_ticks_.load(std::memory_order_relaxed); }
+        uint64_t processed_blocks() const { return processed_.load(std::memory_order_relaxed); }
+        uint64_t skipped_blocks() const { return skipped_.load(std::memory_order_relaxed); }
+        void reset_cost() {
+            cost_ticks_.store(0, std::memory_order_relaxed);
+            processed_.store(0, std::memory_order_relaxed);
+            skipped_.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        friend class graph;
+        std::string name_ = "node";
+        std::atomic<bool> bypass_{false};
+        std::atomic<uint64_t> cost_ticks_{0};
+        std::atomic<uint64_t> processed_{0};
+        std::atomic<uint64_t> skipped_{0};
+        int silent_frames_ = 0;  // audio thread
+    };
+
+    struct config {
+        int block_frames = 128;
+        int channels = 2;
+        int sample_rate = 48000;  // install() takes it from the desc
+        bool measure_cost = true; // time every node with stm_now()
+    };
+
+    graph() : graph(config()) {}
+    explicit graph(const config& cfg) : cfg_(cfg), retired_(64) {
+        cfg_.block_frames = std::max(cfg_.block_frames, 1);
+        cfg_.channels = std::max(cfg_.channels, 1);
+    }
+    graph(const graph&) = delete;
+    graph& operator=(const graph&) = delete;
+    ~graph() {
+        collect_garbage();
+        delete pending_.exchange(nullptr);
+        delete current_;
+    }
+
+    // Set the desc's rate and channel count, then route its stream callback through the graph;
+    // call before adding nodes so they are prepared for the right rate
+    desc& install(desc& d) {
+        const saudio_desc& c = d;
+        if (c.sample_rate > 0)
+            cfg_.sample_rate = c.sample_rate;
+        if (c.packet_frames > 0)
+            cfg_.block_frames = c.packet_frames;
+        d.num_channels(cfg_.channels);
+        return bind(d, *this);
+    }
+
+    // Game thread: create a node owned by the graph
+    template <typename T, typename... Args>
+    T* add(Args&&... args) {
+        auto n = std::make_shared<T>(std::forward<Args>(args)...);
+        n->prepare(cfg_.sample_rate, cfg_.block_frames, cfg_.channels);
+        nodes_.push_back(n);
+        return n.get();
+    }
+
+    // The node stays alive until the audio thread stops using it
+    void remove(node* n) {
+        edges_.erase(std::remove_if(edges_.begin(), edges_.end(), [n](const edge& e) { return e.from == n || e.to == n; }), edges_.end());
+        nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(), [n](const std::shared_ptr<node>& p) { return p.get() == n; }), nodes_.end());
+        if (output_ == n)
+            output_ = nullptr;
+    }
+
+    bool connect(node* from, node* to, int port = 0) {
+        if (!from || !to || from == to || port < 0 || port >= to->num_inputs())
+            return false;
+        edges_.push_back({from, to, port});
+        return true;
+    }
+
+    void disconnect(node* from, node* to) {
+        edges_.erase(std::remove_if(edges_.begin(), edges_.end(), [=](const edge& e) { return e.from == from && e.to == to; }), edges_.end());
+    }
+
+    void set_output(node* n) { output_ = n; }
+
+    // Compile the current wiring and hand it to the audio thread; false if it has a cycle
+    bool commit() {
+        collect_garbage();
+        plan* p = compile();
+        if (!p)
+            return false;
+        delete pending_.exchange(p, std::memory_order_acq_rel);
+        return true;
+    }
+
+    // Free plans the audio thread has switched away from (commit() does this too)
+    void collect_garbage() {
+        plan* p;
+        while (retired_.pop(p))
+            delete p;
+    }
+
+    template <typename F>
+    void for_each_node(F&& fn) const {
+        for (auto& n : nodes_)
+            fn(*n);
+    }
+
+    void print_costs(FILE* out = stdout) const {
+        fprintf(out, "%-24s %12s %10s %10s\n", "node", "us/block", "blocks", "skipped");
+        for (auto& n : nodes_) {
+            const uint64_t blocks = n->processed_blocks();
+#ifndef SOKOL_NO_STM
+            const double us = blocks ? stm_us(n->cost_ticks()) / (double)blocks : 0.0;
+#else
+            const double us = 0.0;
+#endif
+            fprintf(out, "%-24s %12.3f %10llu %10llu\n", n->name(), us, (unsigned long long)blocks, (unsigned long long)n->skipped_blocks());
+        }
+    }
+
+    // Buffers the current plan needs, an indicator of the working set
+    int scratch_buffers() const { return compiled_buffers_; }
+    const config& get_config() const { return cfg_; }
+
+    // Audio thread entry point
+    void operator()(float* buffer, int num_frames, int num_channels) { process(buffer, num_frames, num_channels); }
+
+    void process(float* out, int frames, int channels) {
+        if (retired_.free_space() > 0) {
+            if (plan* p = pending_.exchange(nullptr, std::memory_order_acq_rel)) {
+                if (current_)
+                    retired_.push(current_);
+                current_ = p;
+            }
+        }
+        if (!current_ || channels != cfg_.channels || current_->output < 0) {
+            memset(out, 0, (size_t)frames * (size_t)channels * sizeof(float));
+            return;
+        }
+        for (int done = 0; done < frames; done += cfg_.block_frames) {
+            const int n = std::min(cfg_.block_frames, frames - done);
+            run(*current_, n);
+            float* dst = out + (size_t)done * (size_t)channels;
+            if (current_->silent[(size_t)current_->output])
+                memset(dst, 0, (size_t)n * (size_t)channels * sizeof(float));
+            else
+                memcpy(dst, current_->buffer(current_->output), (size_t)n * (size_t)channels * sizeof(float));
+        }
+    }
+
+private:
+    struct edge {
+        node* from;
+        node* to;
+        int port;
+    };
+
+    struct port {
+        int first_source = 0;  // into plan::sources
+        int num_sources = 0;
+        int sum = -1;          // scratch buffer when several sources are summed
+    };
+
+    struct step {
+        node* n;
+        int output;
+        int first_port;  // into plan::ports
+        int num_ports;
+    };
+
+    struct plan {
+        std::vector<std::shared_ptr<node>> keep_alive;
+        std::vector<step> steps;
+        std::vector<port> ports;
+        std::vector<int> sources;
+        std::vector<const float*> inputs;  // per-step scratch
+        std::vector<float> memory;
+        std::vector<uint8_t> silent;
+        size_t stride = 0;
+        int zero = -1;  // always-silent buffer for unconnected ports
+        int output = -1;
+
+        float* buffer(int i) { return memory.data() + (size_t)i * stride; }
+    };
+
+    plan* compile() {
+        plan* p = new plan();
+        if (!output_) {
+            p->output = -1;
+            compiled_buffers_ = 0;
+            return p;
+        }
+        // nodes feeding the output, then Kahn's algorithm over that subgraph
+        std::vector<node*> needed{output_};
+        for (size_t i = 0; i < needed.size(); i++)
+            for (const edge& e : edges_)
+                if (e.to == needed[i] && std::find(needed.begin(), needed.end(), e.from) == needed.end())
+                    needed.push_back(e.from);
+        std::unordered_map<node*, int> indegree;
+        for (node* n : needed)
+            indegree[n] = 0;
+        for (const edge& e : edges_)
+            if (indegree.count(e.to) && indegree.count(e.from))
+                indegree[e.to]++;
+        std::vector<node*> order;
+        for (node* n : needed)
+            if (!indegree[n])
+                order.push_back(n);
+        for (size_t i = 0; i < order.size(); i++)
+            for (const edge& e : edges_)
+                if (e.from == order[i] && indegree.count(e.to) && --indegree[e.to] == 0)
+                    order.push_back(e.to);
+        if (order.size() != needed.size()) {
+            delete p;
+            return nullptr;
+        }
+
+        // assign buffers: a node's output lives until its last consumer has run
+        std::unordered_map<node*, int> step_of;
+        for (size_t i = 0; i < order.size(); i++)
+            step_of[order[i]] = (int)i;
+        std::vector<int> last_use(order.size(), 0);
+        for (const edge& e : edges_)
+            if (step_of.count(e.from) && step_of.count(e.to))
+                last_use[(size_t)step_of[e.from]] = std::max(last_use[(size_t)step_of[e.from]], step_of[e.to]);
+        last_use[(size_t)step_of[output_]] = (int)order.size();
+        int num_buffers = 1;
+        p->zero = 0;
+        std::vector<int> free_list;
+        auto acquire = [&]() {
+            if (free_list.empty())
+                return num_buffers++;
+            int b = free_list.back();
+            free_list.pop_back();
+            return b;
+        };
+        std::vector<int> out_buffer(order.size(), -1);
+        for (size_t i = 0; i < order.size(); i++) {
+            node* n = order[i];
+            step s = {n, -1, (int)p->ports.size(), n->num_inputs()};
+            std::vector<int> temps;
+            for (int pi = 0; pi < s.num_ports; pi++) {
+                port pt;
+                pt.first_source = (int)p->sources.size();
+                for (const edge& e : edges_)
+                    if (e.to == n && e.port == pi && step_of.count(e.from))
+                        p->sources.push_back(out_buffer[(size_t)step_of[e.from]]);
+                pt.num_sources = (int)p->sources.size() - pt.first_source;
+                if (pt.num_sources > 1) {
+                    pt.sum = acquire();
+                    temps.push_back(pt.sum);
+                }
+                p->ports.push_back(pt);
+            }
+            s.output = acquire();
+            out_buffer[i] = s.output;
+            p->steps.push_back(s);
+            for (int b : temps)
+                free_list.push_back(b);
+            for (size_t j = 0; j < i; j++)
+                if (last_use[j] == (int)i)
+                    free_list.push_back(out_buffer[j]);
+        }
+        p->output = out_buffer[(size_t)step_of[output_]];
+        p->stride = (size_t)cfg_.block_frames * (size_t)cfg_.channels;
+        p->memory.assign(p->stride * (size_t)num_buffers, 0.0f);
+        p->silent.assign((size_t)num_buffers, 1);
+        size_t max_ports = 1;
+        for (const step& s : p->steps)
+            max_ports = std::max(max_ports, (size_t)s.num_ports);
+        p->inputs.resize(max_ports);
+        for (auto& n : nodes_)
+            if (step_of.count(n.get()))
+                p->keep_alive.push_back(n);
+        compiled_buffers_ = num_buffers;
+        return p;
+    }
+
+    void run(plan& p, int frames) {
+        using namespace sokol::simd;
+        const size_t count = (size_t)frames * (size_t)cfg_.channels;
+        for (const step& s : p.steps) {
+            node& n = *s.n;
+            bool inputs_silent = true;
+            for (int pi = 0; pi < s.num_ports; pi++) {
+                const port& pt = p.ports[(size_t)(s.first_port + pi)];
+                int b = p.zero;
+                if (pt.num_sources == 1) {
+                    b = p.sources[(size_t)pt.first_source];
+                } else if (pt.num_sources > 1) {
+                    b = pt.sum;
+                    float* sum = p.buffer(b);
+                    bool any = false;
+                    for (int k = 0; k < pt.num_sources; k++) {
+                        const int src = p.sources[(size_t)(pt.first_source + k)];
+                        if (p.silent[(size_t)src])
+                            continue;
+                        const float* in = p.buffer(src);
+                        if (!any) {
+                            memcpy(sum, in, count * sizeof(float));
+                            any = true;
+                            continue;
+                        }
+                        size_t i = 0;
+                        for (; i + 4 <= count; i += 4)
+                            store(sum + i, load(sum + i) + load(in + i));
+                        for (; i < count; i++)
+                            sum[i] += in[i];
+                    }
+                    p.silent[(size_t)b] = !any;
+                }
+                // silent buffers hold whatever the last step that wrote them left behind, a node
+                // still in its tail must read real zeros
+                if (p.silent[(size_t)b])
+                    b = p.zero;
+                else
+                    inputs_silent = false;
+                p.inputs[(size_t)pi] = p.buffer(b);
+            }
+            float* out = p.buffer(s.output);
+            if (n.bypassed()) {
+                const bool pass = s.num_ports > 0 && !inputs_silent;
+                if (pass)
+                    memcpy(out, p.inputs[0], count * sizeof(float));
+                p.silent[(size_t)s.output] = !pass;
+                n.skipped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (s.num_ports > 0 && inputs_silent && n.silent_frames_ >= n.tail_frames()) {
+                p.silent[(size_t)s.output] = 1;
+                n.skipped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            n.silent_frames_ = inputs_silent ? std::min(n.silent_frames_ + frames, INT32_MAX / 2) : 0;
+#ifndef SOKOL_NO_STM
+            const uint64_t start = cfg_.measure_cost ? stm_now() : 0;
+#endif
+            const bool audible = n.process(p.inputs.data(), out, frames, cfg_.channels);
+#ifndef SOKOL_NO_STM
+            if (cfg_.measure_cost)
+                n.cost_ticks_.fetch_add(stm_diff(stm_now(), start), std::memory_order_relaxed);
+#endif
+            n.processed_.fetch_add(1, std::memory_order_relaxed);
+            p.silent[(size_t)s.output] = !audible;
+        }
+    }
+
+    config cfg_;
+    std::vector<std::shared_ptr<node>> nodes_;
+    std::vector<edge> edges_;
+    node* output_ = nullptr;
+    int compiled_buffers_ = 0;
+    std::atomic<plan*> pending_{nullptr};
+    plan* current_ = nullptr;  // audio thread
+    sokol::spsc_queue<plan*> retired_;
+};
+
+// Wraps a stream callable (a mixer, file_stream, ...) as a graph source
+template <typename F>
+class source_node : public graph::node {
+public:
+    explicit source_node(F& fn) : fn_(fn) {}
+    int num_inputs() const override { return 0; }
+    bool process(const float* const*, float* output, int frames, int channels) override {
+        fn_(output, frames, channels);
+        // report all-zero blocks as silent so downstream nodes can be skipped
+        const size_t count = (size_t)frames * (size_t)channels;
+        for (size_t i = 0; i < count; i++)
+            if (output[i] != 0.0f)
+                return true;
+        return false;
+    }
+
+private:
+    F& fn_;
+};
+
+// Sums its inputs with a gain ramped over one block, for buses and sends
+class gain_node : public graph::node {
+public:
+    explicit gain_node(float gain = 1.0f) : gain_(gain), current_(gain) {}
+    void set_gain(float gain) { gain_.store(gain, std::memory_order_relaxed); }
+    float gain() const { return gain_.load(std::memory_order_relaxed); }
+
+    bool process(const float* const* inputs, float* output, int frames, int channels) override {
+        using namespace sokol::simd;
+        const float target = gain_.load(std::memory_order_relaxed);
+        const float prev = current_;
+        const size_t count = (size_t)frames * (size_t)channels;
+        const float step = (target - prev) / (float)frames;
+        if (step == 0.0f) {
+            const f32x4 g = splat(target);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+                store(output + i, load(inputs[0] + i) * g);
+            for (; i < count; i++)
+                output[i] = inputs[0][i] * target;
+        } else {
+            for (int f = 0; f < frames; f++) {
+                const float g = current_ + step * (float)f;
+                for (int c = 0; c < channels; c++)
+                    output[(size_t)f * (size_t)channels + (size_t)c] = inputs[0][(size_t)f * (size_t)channels + (size_t)c] * g;
+            }
+        }
+        current_ = target;
+        // a ramp down to zero still carries signal
+        return prev != 0.0f || target != 0.0f;
+    }
+
+private:
+    std::atomic<float> gain_;
+    float current_;
+};
+
+// RBJ cookbook biquad, one state per channel
+class biquad_node : public graph::node {
+public:
+    enum class type { lowpass, highpass, bandpass, notch };
+
+    biquad_node(type t = type::lowpass, float cutoff_hz = 1000.0f, float q = 0.7071f) : type_((int)t), cutoff_(cutoff_hz), q_(q) {}
+    void set(type t, float cutoff_hz, float q) {
+        type_.store((int)t, std::memory_order_relaxed);
+        cutoff_.store(cutoff_hz, std::memory_order_relaxed);
+        q_.store(q, std::memory_order_relaxed);
+    }
+
+    void prepare(int sample_rate, int, int channels) override {
+        sample_rate_ = (float)sample_rate;
+        state_.assign((size_t)channels * 2, 0.0f);
+    }
+    int tail_frames() const override { return (int)sample_rate_ / 20; }
+
+    bool process(const float* const* inputs, float* output, int frames, int channels) override {
+        update();
+        const float* in = inputs[0];
+        for (int c = 0; c < channels; c++) {
+            float z1 = state_[(size_t)c * 2], z2 = state_[(size_t)c * 2 + 1];
+            for (int f = 0; f < frames; f++) {
+                const size_t i = (size_t)f * (size_t)channels + (size_t)c;
+                const float x = in[i];
+                const float y = b0_ * x + z1;
+                z1 = b1_ * x - a1_ * y + z2;
+                z2 = b2_ * x - a2_ * y;
+                output[i] = y;
+            }
+            // flush denormals once the tail has died out
+            state_[(size_t)c * 2] = std::abs(z1) < 1e-15f ? 0.0f : z1;
+            state_[(size_t)c * 2 + 1] = std::abs(z2) < 1e-15f ? 0.0f : z2;
+        }
+        return true;
+    }
+
+private:
+    void update() {
+        const int t = type_.load(std::memory_order_relaxed);
+        const float cutoff = cutoff_.load(std::memory_order_relaxed);
+        const float q = q_.load(std::memory_order_relaxed);
+        if (t == cached_type_ && cutoff == cached_cutoff_ && q == cached_q_)
+            return;
+        cached_type_ = t;
+        cached_cutoff_ = cutoff;
+        cached_q_ = q;
+        const double w0 = 6.28318530717958647692 * std::min((double)cutoff, sample_rate_ * 0.49) / sample_rate_;
+        const double alpha = std::sin(w0) / (2.0 * std::max((double)q, 1e-3));
+        const double cw = std::cos(w0);
+        double b0, b1, b2;
+        switch ((type)t) {
+            case type::highpass: b0 = (1 + cw) / 2; b1 = -(1 + cw); b2 = (1 + cw) / 2; break;
+            case type::bandpass: b0 = alpha; b1 = 0; b2 = -alpha; break;
+            case type::notch: b0 = 1; b1 = -2 * cw; b2 = 1; break;
+            default: b0 = (1 - cw) / 2; b1 = 1 - cw; b2 = (1 - cw) / 2; break;
+        }
+        const double a0 = 1 + alpha;
+        b0_ = (float)(b0 / a0);
+        b1_ = (float)(b1 / a0);
+        b2_ = (float)(b2 / a0);
+        a1_ = (float)(-2 * cw / a0);
+        a2_ = (float)((1 - alpha) / a0);
+    }
+
+    std::atomic<int> type_;
+    std::atomic<float> cutoff_;
+    std::atomic<float> q_;
+    float sample_rate_ = 48000.0f;
+    int cached_type_ = -1;
+    float cached_cutoff_ = 0.0f;
+    float cached_q_ = 0.0f;
+    float b0_ = 1, b1_ = 0, b2_ = 0, a1_ = 0, a2_ = 0;
+    std::vector<float> state_;
+};
+
+// Feedback delay with dry/wet mix
+class delay_node : public graph::node {
+public:
+    explicit delay_node(float max_seconds = 2.0f, float seconds = 0.25f, float feedback = 0.4f, float wet = 0.5f)
+        : max_seconds_(max_seconds), seconds_(seconds), feedback_(feedback), wet_(wet) {}
+    void set(float seconds, float feedback, float wet) {
+        seconds_.store(seconds, std::memory_order_relaxed);
+        feedback_.store(feedback, std::memory_order_relaxed);
+        wet_.store(wet, std::memory_order_relaxed);
+    }
+
+    void prepare(int sample_rate, int, int channels) override {
+        sample_rate_ = sample_rate;
+        length_ = std::max((int)(max_seconds_ * (float)sample_rate), 1);
+        line_.assign((size_t)length_ * (size_t)channels, 0.0f);
+    }
+    // Until the echoes decay below -80 dB
+    int tail_frames() const override {
+        const float fb = std::min(std::abs(feedback_.load(std::memory_order_relaxed)), 0.999f);
+        const float repeats = fb > 0.0f ? 1.0f + std::log(1e-4f) / std::log(fb) : 1.0f;
+        return (int)std::min((float)(INT32_MAX / 4), delay_frames() * repeats);
+    }
+
+    bool process(const float* const* inputs, float* output, int frames, int channels) override {
+        const int d = std::min(std::max(delay_frames(), 1), length_);
+        const float fb = feedback_.load(std::memory_order_relaxed);
+        const float wet = wet_.load(std::memory_order_relaxed);
+        const float* in = inputs[0];
+        for (int f = 0; f < frames; f++) {
+            const int read = (pos_ + length_ - d) % length_;
+            for (int c = 0; c < channels; c++) {
+                const size_t i = (size_t)f * (size_t)channels + (size_t)c;
+                const float delayed = line_[(size_t)read * (size_t)channels + (size_t)c];
+                line_[(size_t)pos_ * (size_t)channels + (size_t)c] = in[i] + delayed * fb;
+                output[i] = in[i] * (1.0f - wet) + delayed * wet;
+            }
+            pos_ = pos_ + 1 == length_ ? 0 : pos_ + 1;
+        }
+        return true;
+    }
+
+private:
+    int delay_frames() const { return (int)(seconds_.load(std::memory_order_relaxed) * (float)sample_rate_); }
+
+    float max_seconds_;
+    std::atomic<float> seconds_;
+    std::atomic<float> feedback_;
+    std::atomic<float> wet_;
+    int sample_rate_ = 48000;
+    int length_ = 1;
+    int pos_ = 0;
+    std::vector<float> line_;
+};
+
+// Feed-forward peak compressor linked across channels
+class compressor_node : public graph::node {
+public:
+    compressor_node(float threshold_db = -18.0f, float ratio = 4.0f, float attack_ms = 5.0f, float release_ms = 120.0f, float makeup_db = 0.0f)
+        : threshold_db_(threshold_db), ratio_(ratio), attack_ms_(attack_ms), release_ms_(release_ms), makeup_db_(makeup_db) {}
+    void set(float threshold_db, float ratio, float attack_ms, float release_ms, float makeup_db) {
+        threshold_db_.store(threshold_db, std::memory_order_relaxed);
+        ratio_.store(ratio, std::memory_order_relaxed);
+        attack_ms_.store(attack_ms, std::memory_order_relaxed);
+        release_ms_.store(release_ms, std::memory_order_relaxed);
+        makeup_db_.store(makeup_db, std::memory_order_relaxed);
+    }
+
+    void prepare(int sample_rate, int, int) override { sample_rate_ = (float)sample_rate; }
+
+    // Gain reduction currently applied, in dB
+    float reduction_db() const { return reduction_db_.load(std::memory_order_relaxed); }
+
+    bool process(const float* const* inputs, float* output, int frames, int channels) override {
+        const float threshold = threshold_db_.load(std::memory_order_relaxed);
+        const float slope = 1.0f - 1.0f / std::max(ratio_.load(std::memory_order_relaxed), 1.0f);
+        const float attack = std::exp(-1.0f / (0.001f * std::max(attack_ms_.load(std::memory_order_relaxed), 0.01f) * sample_rate_));
+        const float release = std::exp(-1.0f / (0.001f * std::max(release_ms_.load(std::memory_order_relaxed), 0.01f) * sample_rate_));
+        const float makeup_db = makeup_db_.load(std::memory_order_relaxed);
+        const float makeup = std::pow(10.0f, makeup_db * 0.05f);
+        const float threshold_lin = std::pow(10.0f, threshold * 0.05f);
+        const float* in = inputs[0];
+        float reduction = 0.0f;
+        for (int f = 0; f < frames; f++) {
+            const float* x = in + (size_t)f * (size_t)channels;
+            float peak = 0.0f;
+            for (int c = 0; c < channels; c++)
+                peak = std::max(peak, std::abs(x[c]));
+            const float coeff = peak > env_ ? attack : release;
+            env_ = peak + coeff * (env_ - peak);
+            // below the threshold the gain is just the makeup, no log/pow needed
+            float g = makeup;
+            reduction = 0.0f;
+            if (env_ > threshold_lin) {
+                reduction = (20.0f * std::log10(env_) - threshold) * slope;
+                g = std::pow(10.0f, (makeup_db - reduction) * 0.05f);
+            }
+            for (int c = 0; c < channels; c++)
+                output[(size_t)f * (size_t)channels + (size_t)c] = x[c] * g;
+        }
+        reduction_db_.store(reduction, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<float> threshold_db_;
+    std::atomic<float> ratio_;
+    std::atomic<float> attack_ms_;
+    std::atomic<float> release_ms_;
+    std::atomic<float> makeup_db_;
+    std::atomic<float> reduction_db_{0.0f};
+    float sample_rate_ = 48000.0f;
+    float env_ = 0.0f;
+};
+
+#ifndef SOKOL_NO_STM
+// Maps stm time to the stream's sample clock. The audio thread calls update() at the start
+// of every callback; a second-order delay-locked loop filters the callback jitter out of the
+// timestamps and tracks the device clock's drift against stm, so the game thread can turn a
+// timestamp into a frame and read a smooth, drift-corrected stream time.
+class sample_clock {
+public:
+    explicit sample_clock(int sample_rate = 0, double bandwidth_hz = 0.5) { reset(sample_rate, bandwidth_hz); }
+
+    // Not thread-safe, call before the stream starts. The rate is only a fallback, the first
+    // callback takes the rate the device was actually opened with from saudio::sample_rate()
+    void reset(int sample_rate, double bandwidth_hz = 0.5) {
+        requested_rate_ = sample_rate;
+        rate_ = 0;
+        bandwidth_ = bandwidth_hz;
+        primed_ = false;
+        last_seconds_ = 0.0;
+        seq_.store(0, std::memory_order_relaxed);
+        valid_.store(false, std::memory_order_relaxed);
+    }
+
+    // Audio thread: `frame` is the stream position of the first frame of this callback
+    void update(uint64_t frame, int frames) {
+        if (rate_ <= 0)
+            rate_ = saudio::sample_rate() > 0 ? saudio::sample_rate() : (requested_rate_ > 0 ? requested_rate_ : 44100);
+        const double now = stm_sec(stm_now());
+        // restart the loop on the first callback and after a stall of more than 100 ms
+        if (!primed_ || frame != expected_frame_ || std::abs(now - t1_) > 0.1) {
+            period_ = 1.0 / (double)rate_;
+            t0_ = now;
+            primed_ = true;
+        } else {
+            const double omega = 6.28318530717958647692 * bandwidth_ * (double)frames * period_;
+            const double e = now - t1_;
+            t0_ = t1_ + std::sqrt(2.0) * omega * e;
+            period_ += omega * omega * e / (double)std::max(frames, 1);
+        }
+        t1_ = t0_ + (double)frames * period_;
+        expected_frame_ = frame + (uint64_t)frames;
+        publish(frame);
+    }
+
+    // Stream frame being rendered at the given stm time (extrapolated from the last callback)
+    uint64_t frame_at(uint64_t ticks) const {
+        const snapshot s = load();
+        if (!s.valid)
+            return 0;
+        const double f = (double)s.frame + (stm_sec(ticks) - s.time) / s.period;
+        return f > 0.0 ? (uint64_t)f : 0;
+    }
+
+    // stm time at which the given stream frame is rendered
+    uint64_t ticks_at(uint64_t frame) const {
+        const snapshot s = load();
+        const double t = s.time + ((double)frame - (double)s.frame) * s.period;
+        return t > 0.0 ? (uint64_t)(t * 1e9) : 0;
+    }
+
+    uint64_t frames_now() const { return frame_at(stm_now()); }
+
+    // Drift-corrected stream time in seconds for gameplay code; never runs backwards
+    double seconds() {
+        const snapshot s = load();
+        if (!s.valid)
+            return last_seconds_;
+        const double t = ((double)s.frame + (stm_sec(stm_now()) - s.time) / s.period) / (double)s.rate;
+        last_seconds_ = std::max(last_seconds_, t);
+        return last_seconds_;
+    }
+
+    // How much faster the device clock runs than stm, in parts per million
+    double drift_ppm() const {
+        const snapshot s = load();
+        return s.valid ? (1.0 / (s.period * (double)s.rate) - 1.0) * 1e6 : 0.0;
+    }
+
+    bool valid() const { return valid_.load(std::memory_order_acquire); }
+    // The stream's rate once the first callback has run, the rate passed to reset() before
+    int sample_rate() const {
+        const snapshot s = load();
+        return s.valid ? s.rate : requested_rate_;
+    }
+
+private:
+    struct snapshot {
+        uint64_t frame;
+        double time;
+        double period;
+        int rate;
+        bool valid;
+    };
+
+    // Seqlock: readers retry while the audio thread is in the middle of an update
+    void publish(uint64_t frame) {
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        frame_.store(frame, std::memory_order_relaxed);
+        time_.store(t0_, std::memory_order_relaxed);
+        period_pub_.store(period_, std::memory_order_relaxed);
+        rate_pub_.store(rate_, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+        valid_.store(true, std::memory_order_release);
+    }
+
+    snapshot load() const {
+        snapshot s;
+        for (;;) {
+            const uint32_t seq = seq_.load(std::memory_order_acquire);
+            s.frame = frame_.load(std::memory_order_relaxed);
+            s.time = time_.load(std::memory_order_relaxed);
+            s.period = period_pub_.load(std::memory_order_relaxed);
+            s.rate = rate_pub_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!(seq & 1) && seq == seq_.load(std::memory_order_relaxed))
+                break;
+            std::this_thread::yield();
+        }
+        s.valid = valid_.load(std::memory_order_acquire) && s.period > 0.0 && s.rate > 0;
+        return s;
+    }
+
+    int requested_rate_ = 0;
+    double bandwidth_ = 0.5;
+    // audio thread
+    int rate_ = 0;
+    bool primed_ = false;
+    uint64_t expected_frame_ = 0;
+    double t0_ = 0.0, t1_ = 0.0;
+    double period_ = 0.0;  // seconds per frame
+    // published
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint64_t> frame_{0};
+    std::atomic<double> time_{0.0};
+    std::atomic<double> period_pub_{0.0};
+    std::atomic<int> rate_pub_{0};
+    std::atomic<bool> valid_{false};
+    double last_seconds_ = 0.0;  // game thread
+};
+
+// Wraps a stream callable and runs events on exact frames of its output. Events are queued
+// wait-free from one game thread, sorted on the audio thread, and the wrapped callable is
+// invoked in pieces split at each event, so anything it reads at the start of a call (graph
+// node parameters, atomics) changes on that frame. Mixer voices have their own frame-accurate
+// *_at commands; use frame_at() to aim both at the same stm time.
+template <typename F>
+class scheduler {
+public:
+    // Runs on the audio thread; keep it short and allocation-free
+    using event_fn = void (*)(void* user, float value);
+
+    explicit scheduler(F& fn, size_t capacity = 1024) : fn_(fn), events_(capacity) {
+        pending_.reserve(events_.capacity());
+    }
+    scheduler(const scheduler&) = delete;
+    scheduler& operator=(const scheduler&) = delete;
+
+    // Take the buffer size from the desc and route its stream callback here; the requested
+    // sample rate is only the clock's fallback until the first callback
+    desc& install(desc& d) {
+        const saudio_desc& c = d;
+        clock_.reset(c.sample_rate > 0 ? c.sample_rate : 0);
+        if (latency_ < 0 && c.buffer_frames > 0)
+            latency_ = c.buffer_frames;
+        return bind(d, *this);
+    }
+
+    // Frames added by frame_at() so events aimed at "now" still land in a future callback,
+    // with a constant delay instead of callback-boundary jitter; defaults to buffer_frames
+    void set_latency(int frames) { latency_ = frames; }
+    int latency() const { return latency_ < 0 ? (saudio::buffer_frames() > 0 ? saudio::buffer_frames() : 2048) : latency_; }
+
+    // Game thread: the frame to schedule at for something meant to happen at stm time `ticks`
+    uint64_t frame_at(uint64_t ticks) const { return clock_.frame_at(ticks) + (uint64_t)latency(); }
+    uint64_t frame_now() const { return frame_at(stm_now()); }
+
+    // Game thread: run fn(user, value) on the audio thread just before output frame `frame`
+    bool at(uint64_t frame, event_fn fn, void* user, float value = 0.0f) {
+        if (!fn || !events_.push(event{frame, fn, user, value})) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    // Game thread: store value into a parameter on output frame `frame`
+    bool set_at(uint64_t frame, std::atomic<float>& param, float value) {
+        return at(frame, [](void* user, float v) { static_cast<std::atomic<float>*>(user)->store(v, std::memory_order_relaxed); }, &param, value);
+    }
+
+    // Audio thread entry point
+    void operator()(float* buffer, int num_frames, int num_channels) {
+        clock_.update(frame_, num_frames);
+        // while pending_ is full, events stay queued until frames pass; at() then counts the
+        // overflow as dropped instead of running future events early
+        event e;
+        while (pending_.size() < pending_.capacity() && events_.pop(e)) {
+            auto later = [](const event& a, const event& b) { return a.frame > b.frame; };
+            pending_.insert(std::upper_bound(pending_.begin(), pending_.end(), e, later), e);
+        }
+        for (int done = 0; done < num_frames;) {
+            const uint64_t now = frame_ + (uint64_t)done;
+            while (!pending_.empty() && pending_.back().frame <= now) {
+                run(pending_.back());
+                pending_.pop_back();
+            }
+            int n = num_frames - done;
+            if (!pending_.empty())
+                n = (int)std::min((uint64_t)n, pending_.back().frame - now);
+            fn_(buffer + (size_t)done * (size_t)num_channels, n, num_channels);
+            done += n;
+        }
+        frame_ += (uint64_t)num_frames;
+        position_.store(frame_, std::memory_order_release);
+    }
+
+    // Frames rendered so far
+    uint64_t position() const { return position_.load(std::memory_order_acquire); }
+    uint64_t late_events() const { return late_.load(std::memory_order_relaxed); }
+    uint64_t dropped_events() const { return dropped_.load(std::memory_order_relaxed); }
+    sample_clock& clock() { return clock_; }
+    const sample_clock& clock() const { return clock_; }
+
+private:
+    struct event {
+        uint64_t frame;
+        event_fn fn;
+        void* user;
+        float value;
+    };
+
+    void run(const event& e) {
+        if (e.frame < frame_)
+            late_.fetch_add(1, std::memory_order_relaxed);
+        e.fn(e.user, e.value);
+    }
+
+    F& fn_;
+    sokol::spsc_queue<event> events_;
+    std::vector<event> pending_;  // audio thread, latest first
+    uint64_t frame_ = 0;          // audio thread
+    sample_clock clock_;
+    int latency_ = -1;
+    std::atomic<uint64_t> position_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+#endif // SOKOL_NO_STM
+
+// Writes interleaved float samples to a 32-bit IEEE float WAV file; the header sizes are
+// patched in close()
+class wav_writer {
+public:
+    wav_writer() = default;
+    wav_writer(const char* path, int num_channels, int sample_rate) { open(path, num_channels, sample_rate); }
+    wav_writer(const wav_writer&) = delete;
+    wav_writer& operator=(const wav_writer&) = delete;
+    ~wav_writer() { close(); }
+
+    bool open(const char* path, int num_channels, int sample_rate) {
+        close();
+        file_ = fopen(path, "wb");
+        if (!file_)
+            return false;
+        channels_ = std::max(num_channels, 1);
+        rate_ = sample_rate;
+        frames_ = 0;
+        return write_header();
+    }
+
+    bool write(const float* samples, size_t num_frames) {
+        if (!file_)
+            return false;
+        const size_t count = num_frames * (size_t)channels_;
+        bool ok = true;
+        uint8_t bytes[256];
+        for (size_t i = 0; i < count && ok;) {
+            // little-endian regardless of the host
+            size_t n = std::min(count - i, sizeof(bytes) / 4);
+            for (size_t k = 0; k < n; k++) {
+                uint32_t bits;
+                memcpy(&bits, samples + i + k, 4);
+                put_u32(bytes + 4 * k, bits);
+            }
+            ok = fwrite(bytes, 4, n, file_) == n;
+            i += n;
+        }
+        frames_ += num_frames;
+        return ok;
+    }
+
+    bool close() {
+        if (!file_)
+            return true;
+        const bool ok = fseek(file_, 0, SEEK_SET) == 0 && write_header();
+        fclose(file_);
+        file_ = nullptr;
+        return ok;
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+    size_t frames() const { return frames_; }
+
+private:
+    static void put_u16(uint8_t* p, uint32_t v) {
+        p[0] = (uint8_t)v;
+        p[1] = (uint8_t)(v >> 8);
+    }
+    static void put_u32(uint8_t* p, uint32_t v) {
+        put_u16(p, v & 0xffff);
+        put_u16(p + 2, v >> 16);
+    }
+
+    // RIFF, fmt (WAVE_FORMAT_IEEE_FLOAT), fact and data chunk headers
+    bool write_header() {
+        const uint32_t data_bytes = (uint32_t)std::min<size_t>(frames_ * (size_t)channels_ * 4, 0xffffffffu - 58);
+        uint8_t h[58];
+        memcpy(h, "RIFF", 4);
+        put_u32(h + 4, 50 + data_bytes);
+        memcpy(h + 8, "WAVEfmt ", 8);
+        put_u32(h + 16, 18);
+        put_u16(h + 20, 3);
+        put_u16(h + 22, (uint32_t)channels_);
+        put_u32(h + 24, (uint32_t)rate_);
+        put_u32(h + 28, (uint32_t)rate_ * (uint32_t)channels_ * 4);
+        put_u16(h + 32, (uint32_t)channels_ * 4);
+        put_u16(h + 34, 32);
+        put_u16(h + 36, 0);
+        memcpy(h + 38, "fact", 4);
+        put_u32(h + 42, 4);
+        put_u32(h + 46, (uint32_t)frames_);
+        memcpy(h + 50, "data", 4);
+        put_u32(h + 54, data_bytes);
+        return fwrite(h, 1, sizeof(h), file_) == sizeof(h);
+    }
+
+    FILE* file_ = nullptr;
+    int channels_ = 1;
+    int rate_ = 0;
+    size_t frames_ = 0;
+};
+
+// Runs a desc's stream callback without an audio device, as fast as possible. The callback
+// is called with the desc's num_channels, packet_frames and sample_rate (sokol_audio's
+// defaults where they are 0), and saudio::sample_rate()/buffer_frames() answer with them
+// during render(), so the same mixer/graph/resampler setup renders identically offline.
+// Output can be kept in memory, streamed to a float WAV, or both; hash() identifies a run for
+// golden-output comparisons, and random() is a seeded generator for deterministic content.
+class offline_renderer {
+public:
+    // splitmix64, seeded per run
+    struct rng {
+        uint64_t state = 0;
+        uint64_t next() {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+        // uniform in [0, 1)
+        float uniform() { return (float)(next() >> 40) * (1.0f / 16777216.0f); }
+    };
+
+    explicit offline_renderer(const saudio_desc& d, uint64_t seed = 0) : desc_(d) {
+        if (desc_.sample_rate <= 0)
+            desc_.sample_rate = 44100;
+        if (desc_.num_channels <= 0)
+            desc_.num_channels = 1;
+        if (desc_.buffer_frames <= 0)
+            desc_.buffer_frames = 2048;
+        if (desc_.packet_frames <= 0)
+            desc_.packet_frames = 128;
+        packet_.resize((size_t)desc_.packet_frames * (size_t)desc_.num_channels);
+        reset(seed);
+    }
+    offline_renderer(const offline_renderer&) = delete;
+    offline_renderer& operator=(const offline_renderer&) = delete;
+
+    // Start a new run: rewind the frame counter, reseed random() and drop captured output
+    void reset(uint64_t seed) {
+        seed_ = seed;
+        rng_.state = seed;
+        frames_ = 0;
+        elapsed_ = 0.0;
+        hash_ = 0xcbf29ce484222325ull;
+        samples_.clear();
+    }
+
+    // Keep rendered samples in memory (on by default)
+    void set_capture(bool capture) { capture_ = capture; }
+    // Also stream rendered samples to this writer; nullptr to stop
+    void set_output(wav_writer* out) { out_ = out; }
+
+    // Render num_frames in packet_frames steps; fn(uint64_t frame) runs before each packet so
+    // a script can drive game-thread calls at fixed points
+    template <typename Fn>
+    void render(uint64_t num_frames, Fn&& before_packet) {
+        const int channels = desc_.num_channels;
+        const saudio_desc* prev = helper::offline_desc().exchange(&desc_, std::memory_order_acq_rel);
+        for (uint64_t done = 0; done < num_frames;) {
+            const int n = (int)std::min<uint64_t>((uint64_t)desc_.packet_frames, num_frames - done);
+            before_packet(frames_);
+            memset(packet_.data(), 0, packet_.size() * sizeof(float));
+            const auto start = std::chrono::steady_clock::now();
+            if (desc_.stream_userdata_cb)
+                desc_.stream_userdata_cb(packet_.data(), n, channels, desc_.user_data);
+            else if (desc_.stream_cb)
+                desc_.stream_cb(packet_.data(), n, channels);
+            elapsed_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const size_t count = (size_t)n * (size_t)channels;
+            add_hash(packet_.data(), count);
+            if (capture_)
+                samples_.insert(samples_.end(), packet_.begin(), packet_.begin() + (ptrdiff_t)count);
+            if (out_)
+                out_->write(packet_.data(), (size_t)n);
+            done += (uint64_t)n;
+            frames_ += (uint64_t)n;
+        }
+        helper::offline_desc().store(prev, std::memory_order_release);
+    }
+
+    void render(uint64_t num_frames) {
+        render(num_frames, [](uint64_t) {});
+    }
+
+    void render_seconds(double seconds) { render((uint64_t)(seconds * (double)desc_.sample_rate)); }
+
+    // Write the captured samples to a float WAV file
+    bool write_wav(const char* path) const {
+        wav_writer w;
+        return w.open(path, desc_.num_channels, desc_.sample_rate) &&
+               w.write(samples_.data(), samples_.size() / (size_t)desc_.num_channels) && w.close();
+    }
+
+    // Seconds of audio rendered per second spent in the callback
+    double realtime_factor() const { return elapsed_ > 0.0 ? seconds_rendered() / elapsed_ : 0.0; }
+    double seconds_rendered() const { return (double)frames_ / (double)desc_.sample_rate; }
+    double callback_seconds() const { return elapsed_; }
+    uint64_t frames() const { return frames_; }
+    // FNV-1a over the bits of every rendered sample since reset()
+    uint64_t hash() const { return hash_; }
+    uint64_t seed() const { return seed_; }
+    rng& random() { return rng_; }
+
+    const std::vector<float>& samples() const { return samples_; }
+    const saudio_desc& get_desc() const { return desc_; }
+
+private:
+    void add_hash(const float* samples, size_t count) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(samples);
+        for (size_t i = 0; i < count * sizeof(float); i++)
+            hash_ = (hash_ ^ p[i]) * 0x100000001b3ull;
+    }
+
+    saudio_desc desc_;
+    std::vector<float> packet_;
+    std::vector<float> samples_;
+    wav_writer* out_ = nullptr;
+    bool capture_ = true;
+    uint64_t seed_ = 0;
+    rng rng_;
+    uint64_t frames_ = 0;
+    uint64_t hash_ = 0;
+    double elapsed_ = 0.0;
+};
+}
+#endif // SOKOL_NO_SAUDIO
@@ -0,0 +1,138 @@
+// Machine generated C++ wrapper for Sokol library.
+// https://github.com/takeiteasy/sokol.hpp
+//
+// Do not edit manually; regenerate using generate.py.
+
+#pragma once
+#include <utility>
+#include <memory>
+
+#ifndef SOKOL_AUDIO_INCLUDED
+#if __has_include("sokol_audio.h")
+#include "sokol_audio.h"
+#elif __has_include("sokol/sokol_audio.h")
+#include "sokol/sokol_audio.h"
+#else
+#warning "Cannot find sokol_audio.h, disabling!"
+#define SOKOL_NO_SAUDIO
+#endif
+#endif
+
+#ifndef SOKOL_NO_SAUDIO
+#ifdef SOKOL_HPP_EXTERN
+SOKOL_HPP_EXTERN template class sg::helper::desc<saudio_n3ds_desc>;
+SOKOL_HPP_EXTERN template class sg::helper::desc<saudio_desc>;
+#endif
+namespace saudio {
+namespace helper = sg::helper;
+// Builder API for saudio_n3ds_desc
+class n3ds_desc : public helper::desc<saudio_n3ds_desc> {
+public:
+    n3ds_desc() = default;
+
+    n3ds_desc& queue_count(int value) {
+        desc_.queue_count = value;
+        return *this;
+    }
+
+    n3ds_desc& interpolation_type(saudio_n3ds_ndspinterptype value) {
+        desc_.interpolation_type = value;
+        return *this;
+    }
+
+    n3ds_desc& channel_id(int value) {
+        desc_.channel_id = value;
+        return *this;
+    }
+
+};
+
+// Builder API for saudio_desc
+class desc : public helper::desc<saudio_desc> {
+public:
+    desc() = default;
+
+    desc& sample_rate(int value) {
+        desc_.sample_rate = value;
+        return *this;
+    }
+
+    desc& num_channels(int value) {
+        desc_.num_channels = value;
+        return *this;
+    }
+
+    desc& buffer_frames(int value) {
+        desc_.buffer_frames = value;
+        return *this;
+    }
+
+    desc& packet_frames(int value) {
+        desc_.packet_frames = value;
+        return *this;
+    }
+
+    desc& num_packets(int value) {
+        desc_.num_packets = value;
+        return *this;
+    }
+
+    desc& stream_cb(void (*value)(float *, int, int)) {
+        desc_.stream_cb = value;
+        return *this;
+    }
+
+    desc& stream_userdata_cb(void (*value)(float *, int, int, void *)) {
+        desc_.stream_userdata_cb = value;
+        return *this;
+    }
+
+    desc& user_data(void* value) {
+        desc_.user_data = value;
+        return *this;
+    }
+
+    desc& n3ds_queue_count(int value) {
+        desc_.n3ds.queue_count = value;
+        return *this;
+    }
+
+    desc& n3ds_interpolation_type(saudio_n3ds_ndspinterptype value) {
+        desc_.n3ds.interpolation_type = value;
+        return *this;
+    }
+
+    desc& n3ds_channel_id(int value) {
+        desc_.n3ds.channel_id = value;
+        return *this;
+    }
+
+    desc& allocator_alloc_fn(void *(*value)(size_t, void *)) {
+        desc_.allocator.alloc_fn = value;
+        return *this;
+    }
+
+    desc& allocator_free_fn(void (*value)(void *, void *)) {
+        desc_.allocator.free_fn = value;
+        return *this;
+    }
+
+    desc& allocator_user_data(void* value) {
+        desc_.allocator.user_data = value;
+        return *this;
+    }
+
+    desc& logger_func(void (*value)(const char *, uint32_t, uint32_t, const char *, uint32_t, const char *, void *)) {
+        desc_.logger.func = value;
+        return *this;
+    }
+
+    desc& logger_user_data(void* value) {
+        desc_.logger.user_data = value;
+        return *this;
+    }
+
+};
+
+} // namespace saudio
+#endif // SOKOL_NO_SAUDIO
@@ -0,0 +1,30 @@
+/* sokol_core.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+// Shared by every sokol_<module>.hpp: helper::desc<T> and the extern template switch of the
+// generated builders. The runtime utilities live in their own opt-in headers: sokol_simd.hpp,
+// sokol_queue.hpp, sokol_alloc.hpp and sokol_jobs.hpp
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace gen {
+#include "sokol_core.inl"
+}
@@ -0,0 +1,39 @@
+// Machine generated C++ wrapper for Sokol library.
+// https://github.com/takeiteasy/sokol.hpp
+//
+// Do not edit manually; regenerate using generate.py.
+
+#pragma once
+#include <utility>
+#include <memory>
+
+#if defined(SOKOL_HPP_INSTANTIATE)
+#define SOKOL_HPP_EXTERN
+#elif defined(SOKOL_HPP_EXTERN_TEMPLATES)
+#define SOKOL_HPP_EXTERN extern
+#endif
+
+namespace sg {
+namespace helper {
+template<typename T>
+class desc {
+protected:
+    T desc_ = {};
+    
+public:
+    desc() = default;
+    
+    // Conversion operator - allows implicit conversion to the C struct
+    operator const T&() const { return desc_; }
+    operator T&() { return desc_; }
+    
+    // Explicit pointer access
+    const T* operator&() const { return &desc_; }
+    T* operator&() { return &desc_; }
+    
+    // Access to underlying descriptor
+    const T& get() const { return desc_; }
+    T& get() { return desc_; }
+};
+} // namespace helper
+} // namespace sg
@@ -0,0 +1,1330 @@
+/* sokol_gfx.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "sokol_core.hpp"
+
+// The C header must be included at global scope, sokol_gfx.inl is wrapped in a namespace
+#ifndef SOKOL_GFX_INCLUDED
+#if __has_include("sokol_gfx.h")
+#include "sokol_gfx.h"
+#elif __has_include("sokol/sokol_gfx.h")
+#include "sokol/sokol_gfx.h"
+#endif
+#endif
+
+#if defined(SOKOL_GFX_INCLUDED) && !defined(SOKOL_NO_SG)
+namespace sg {
+namespace helper {
+// Receivers of the lifetime hooks below: sokol_gfx_debug.hpp's memory_tracker watches buffers
+// and images, its pipeline_checker shaders and pipelines
+class memory_hooks {
+public:
+    virtual void on_make(const sg_buffer_desc&, sg_buffer) = 0;
+    virtual void on_make(const sg_image_desc&, sg_image) = 0;
+    virtual void on_destroy(sg_buffer) = 0;
+    virtual void on_destroy(sg_image) = 0;
+
+protected:
+    virtual ~memory_hooks() = default;
+};
+
+class pipeline_hooks {
+public:
+    virtual void on_make(const sg_shader_desc&, sg_shader) = 0;
+    virtual void on_make(const sg_pipeline_desc&, sg_pipeline) = 0;
+    virtual void on_destroy(sg_shader) = 0;
+    virtual void on_destroy(sg_pipeline) = 0;
+
+protected:
+    virtual ~pipeline_hooks() = default;
+};
+
+// Where the hooks are currently forwarded to, if anywhere
+inline memory_hooks* memory_observer = nullptr;
+inline pipeline_hooks* pipeline_observer = nullptr;
+
+// Lifetime hooks reported by sg_type_traits, the generated builders' build() and helper::ptr
+template <typename Desc, typename Handle> inline void on_make(const Desc*, Handle) {}
+template <typename Handle> inline void on_destroy(Handle) {}
+inline void on_make(const sg_buffer_desc* desc, sg_buffer buf) {
+    if (memory_observer)
+        memory_observer->on_make(*desc, buf);
+}
+inline void on_make(const sg_image_desc* desc, sg_image img) {
+    if (memory_observer)
+        memory_observer->on_make(*desc, img);
+}
+inline void on_make(const sg_shader_desc* desc, sg_shader shd) {
+    if (pipeline_observer)
+        pipeline_observer->on_make(*desc, shd);
+}
+inline void on_make(const sg_pipeline_desc* desc, sg_pipeline pip) {
+    if (pipeline_observer)
+        pipeline_observer->on_make(*desc, pip);
+}
+inline void on_destroy(sg_buffer buf) {
+    if (memory_observer)
+        memory_observer->on_destroy(buf);
+}
+inline void on_destroy(sg_image img) {
+    if (memory_observer)
+        memory_observer->on_destroy(img);
+}
+inline void on_destroy(sg_shader shd) {
+    if (pipeline_observer)
+        pipeline_observer->on_destroy(shd);
+}
+inline void on_destroy(sg_pipeline pip) {
+    if (pipeline_observer)
+        pipeline_observer->on_destroy(pip);
+}
+} // namespace helper
+} // namespace sg
+#endif
+
+namespace gen {
+#include "sokol_gfx.inl"
+}
+
+#ifndef SOKOL_NO_SG
+namespace sg {
+template<typename T> struct sg_type_traits;
+#define DEFINE_SG_TRAITS(desc_type, handle_type, prefix) \
+template<> \
+struct sg_type_traits<desc_type> { \
+    using handle = handle_type; \
+    static inline handle make(const desc_type* desc) { \
+        handle h = sg_make_##prefix(desc); \
+        helper::on_make(desc, h); \
+        return h; \
+    } \
+    static inline void destroy(handle h) { helper::on_destroy(h); sg_destroy_##prefix(h); } \
+    static inline desc_type query_desc(handle h) { return sg_query_##prefix##_desc(h); } \
+    static inline desc_type query_defaults(const desc_type* desc) { return sg_query_##prefix##_defaults(desc); } \
+    static inline sg_resource_state query_state(handle h) { return sg_query_##prefix##_state(h); } \
+    static inline void dealloc(handle h) { sg_dealloc_##prefix(h); } \
+    static inline void init(handle h, const desc_type* desc) { sg_init_##prefix(h, desc); helper::on_make(desc, h); } \
+    static inline void uninit(handle h) { helper::on_destroy(h); sg_uninit_##prefix(h); } \
+    static inline void fail(handle h) { sg_fail_##prefix(h); } \
+};
+
+DEFINE_SG_TRAITS(sg_buffer_desc, sg_buffer, buffer)
+DEFINE_SG_TRAITS(sg_image_desc, sg_image, image)
+DEFINE_SG_TRAITS(sg_view_desc, sg_view, view)
+DEFINE_SG_TRAITS(sg_sampler_desc, sg_sampler, sampler)
+DEFINE_SG_TRAITS(sg_shader_desc, sg_shader, shader)
+DEFINE_SG_TRAITS(sg_pipeline_desc, sg_pipeline, pipeline)
+
+using buffer = gen::sg::buffer;
+using image = gen::sg::image;
+using sampler = gen::sg::sampler;
+using shader = gen::sg::shader;
+using pipeline = gen::sg::pipeline;
+using view = gen::sg::view;
+
+class buffer_desc : public gen::sg::buffer_desc {
+public:
+    buffer_desc() = default;
+
+    static buffer_desc make_vertex(size_t size, bool immutable = true) {
+        buffer_desc desc;
+        desc.size(size).usage_vertex_buffer(true).usage_immutable(immutable);
+        return desc;
+    }
+
+    static buffer_desc make_index(size_t size, bool immutable = true) {
+        buffer_desc desc;
+        desc.size(size).usage_index_buffer(true).usage_immutable(immutable);
+        return desc;
+    }
+
+    static buffer_desc make_vertex_with_data(const void* data, size_t size) {
+        buffer_desc desc;
+        desc.size(size)
+            .usage_vertex_buffer(true)
+            .usage_immutable(true)
+            .data_ptr(data)
+            .data_size(size);
+        return desc;
+    }
+
+    static buffer_desc make_index_with_data(const void* data, size_t size) {
+        buffer_desc desc;
+        desc.size(size)
+            .usage_index_buffer(true)
+            .usage_immutable(true)
+            .data_ptr(data)
+            .data_size(size);
+        return desc;
+    }
+};
+
+class image_desc : public gen::sg::image_desc {
+public:
+    image_desc() = default;
+
+    static image_desc make_texture_2d(int w, int h, sg_pixel_format fmt = SG_PIXELFORMAT_RGBA8) {
+        image_desc desc;
+        desc.type(SG_IMAGETYPE_2D)
+            .width(w)
+            .height(h)
+            .pixel_format(fmt);
+        return desc;
+    }
+
+    static image_desc make_render_target(int w, int h, sg_pixel_format fmt = SG_PIXELFORMAT_RGBA8, int samples = 1) {
+        image_desc desc;
+        desc.type(SG_IMAGETYPE_2D)
+            .width(w)
+            .height(h)
+            .pixel_format(fmt)
+            .sample_count(samples)
+            .usage_color_attachment(true);
+        return desc;
+    }
+
+    static image_desc make_depth_stencil(int w, int h, sg_pixel_format fmt = SG_PIXELFORMAT_DEPTH_STENCIL, int samples = 1) {
+        image_desc desc;
+        desc.type(SG_IMAGETYPE_2D)
+            .width(w)
+            .height(h)
+            .pixel_format(fmt)
+            .sample_count(samples)
+            .usage_depth_stencil_attachment(true);
+        return desc;
+    }
+};
+
+class sampler_desc : public gen::sg::sampler_desc {
+public:
+    sampler_desc() = default;
+
+    static sampler_desc make_linear() {
+        sampler_desc desc;
+        desc.min_filter(SG_FILTER_LINEAR)
+            .mag_filter(SG_FILTER_LINEAR);
+        return desc;
+    }
+
+    static sampler_desc make_nearest() {
+        sampler_desc desc;
+        desc.min_filter(SG_FILTER_NEAREST)
+            .mag_filter(SG_FILTER_NEAREST);
+        return desc;
+    }
+
+    static sampler_desc make_linear_clamp() {
+        sampler_desc desc;
+        desc.min_filter(SG_FILTER_LINEAR)
+            .mag_filter(SG_FILTER_LINEAR)
+            .wrap_u(SG_WRAP_CLAMP_TO_EDGE)
+            .wrap_v(SG_WRAP_CLAMP_TO_EDGE);
+        return desc;
+    }
+};
+
+using pipeline_desc = gen::sg::pipeline_desc;
+using shader_desc = gen::sg::shader_desc;
+using view_desc = gen::sg::view_desc;
+using buffer_view_desc = gen::sg::buffer_view_desc;
+using image_view_desc = gen::sg::image_view_desc;
+using texture_view_desc = gen::sg::texture_view_desc;
+using desc = gen::sg::desc;
+
+// Compile-time pipeline/shader checking, for builds that ship with disable_validation(true).
+// shader_interface and pipeline_layout are literal types describing the reflection half of
+// sg_shader_desc and the layout half of sg_pipeline_desc; validate() compares them and
+// require() turns a failure into a compile error naming the problem:
+//
+//   constexpr auto shd = sg::shader_interface()
+//       .attr(0, SG_SHADERATTRBASETYPE_FLOAT)
+//       .uniform_block(0, SG_SHADERSTAGE_VERTEX, sizeof(vs_params_t))
+//       .texture(0, SG_SHADERSTAGE_FRAGMENT)
+//       .sampler(0, SG_SHADERSTAGE_FRAGMENT)
+//       .texture_sampler_pair(0, SG_SHADERSTAGE_FRAGMENT, 0, 0);
+//   constexpr auto pip = sg::pipeline_layout()
+//       .attr(0, SG_VERTEXFORMAT_FLOAT3)
+//       .uniforms(0, sizeof(vs_params_t))
+//       .color(0, SG_PIXELFORMAT_RGBA8);
+//   static_assert(sg::require(sg::validate(shd, pip)));
+//
+// apply() writes the same data into the runtime descs. Descs that only exist at runtime
+// (e.g. sokol-shdc output) are checked once at creation by pipeline_checker, in
+// sokol_gfx_debug.hpp.
+#define SG_VALIDATION_ERRORS(X) \
+    X(attr_missing, "shader vertex attribute has no format in the pipeline layout") \
+    X(attr_format_mismatch, "vertex format base type does not match the shader attribute") \
+    X(attr_buffer_out_of_range, "vertex attribute buffer index is out of range") \
+    X(attr_exceeds_stride, "vertex attribute does not fit in the buffer stride") \
+    X(buffer_stride_unaligned, "vertex buffer stride is not a multiple of 4") \
+    X(uniform_block_missing, "uniform data has no matching shader uniform block") \
+    X(uniform_block_size_mismatch, "uniform data size does not match the shader uniform block") \
+    X(uniform_block_stage_mismatch, "uniform data stage does not match the shader uniform block") \
+    X(uniform_block_size_zero, "shader uniform block has size 0") \
+    X(pair_view_not_texture, "texture-sampler pair does not reference a texture view") \
+    X(pair_sampler_missing, "texture-sampler pair does not reference a sampler") \
+    X(pair_stage_mismatch, "texture-sampler pair stage differs from its view or sampler") \
+    X(pair_sample_type_mismatch, "texture sample type is incompatible with the sampler type") \
+    X(color_count_out_of_range, "color attachment count is out of range") \
+    X(color_count_mismatch, "color attachment count does not match the pass") \
+    X(color_format_mismatch, "color attachment format does not match the pass") \
+    X(depth_format_mismatch, "depth attachment format does not match the pass") \
+    X(sample_count_mismatch, "sample count does not match the pass")
+
+struct validation {
+#define SG_VALIDATION_ENUM(name, msg) name,
+    enum error { ok, SG_VALIDATION_ERRORS(SG_VALIDATION_ENUM) };
+#undef SG_VALIDATION_ENUM
+
+    error err = ok;
+    int slot = -1;
+
+    constexpr explicit operator bool() const { return err == ok; }
+
+    constexpr const char* message() const {
+        switch (err) {
+#define SG_VALIDATION_MESSAGE(name, msg) case name: return msg;
+            SG_VALIDATION_ERRORS(SG_VALIDATION_MESSAGE)
+#undef SG_VALIDATION_MESSAGE
+        default:
+            return "ok";
+        }
+    }
+};
+
+namespace helper {
+// Deliberately not constexpr: reaching one while evaluating require() fails compilation with
+// the function name as the diagnostic
+#define SG_VALIDATION_FAIL(name, msg) inline void pipeline_validation_failed_##name(int) {}
+SG_VALIDATION_ERRORS(SG_VALIDATION_FAIL)
+#undef SG_VALIDATION_FAIL
+
+constexpr sg_shader_attr_base_type vertex_format_base_type(sg_vertex_format fmt) {
+    switch (fmt) {
+    case SG_VERTEXFORMAT_INT: case SG_VERTEXFORMAT_INT2: case SG_VERTEXFORMAT_INT3: case SG_VERTEXFORMAT_INT4:
+    case SG_VERTEXFORMAT_BYTE4: case SG_VERTEXFORMAT_SHORT2: case SG_VERTEXFORMAT_SHORT4:
+        return SG_SHADERATTRBASETYPE_SINT;
+    case SG_VERTEXFORMAT_UINT: case SG_VERTEXFORMAT_UINT2: case SG_VERTEXFORMAT_UINT3: case SG_VERTEXFORMAT_UINT4:
+    case SG_VERTEXFORMAT_UBYTE4: case SG_VERTEXFORMAT_USHORT2: case SG_VERTEXFORMAT_USHORT4:
+        return SG_SHADERATTRBASETYPE_UINT;
+    case SG_VERTEXFORMAT_INVALID:
+        return SG_SHADERATTRBASETYPE_UNDEFINED;
+    default:
+        return SG_SHADERATTRBASETYPE_FLOAT;
+    }
+}
+
+constexpr int vertex_format_bytes(sg_vertex_format fmt) {
+    switch (fmt) {
+    case SG_VERTEXFORMAT_FLOAT2: case SG_VERTEXFORMAT_INT2: case SG_VERTEXFORMAT_UINT2:
+    case SG_VERTEXFORMAT_SHORT4: case SG_VERTEXFORMAT_SHORT4N: case SG_VERTEXFORMAT_USHORT4:
+    case SG_VERTEXFORMAT_USHORT4N: case SG_VERTEXFORMAT_HALF4:
+        return 8;
+    case SG_VERTEXFORMAT_FLOAT3: case SG_VERTEXFORMAT_INT3: case SG_VERTEXFORMAT_UINT3:
+        return 12;
+    case SG_VERTEXFORMAT_FLOAT4: case SG_VERTEXFORMAT_INT4: case SG_VERTEXFORMAT_UINT4:
+        return 16;
+    case SG_VERTEXFORMAT_INVALID:
+        return 0;
+    default:
+        return 4;
+    }
+}
+
+// Defaulted formats and sample counts are resolved from the environment at runtime only
+constexpr bool same_format(sg_pixel_format a, sg_pixel_format b) {
+    return a == b || a == _SG_PIXELFORMAT_DEFAULT || b == _SG_PIXELFORMAT_DEFAULT;
+}
+} // namespace helper
+
+// Reflection half of sg_shader_desc: attribute base types, uniform block stages and sizes,
+// view and sampler bindings and texture-sampler pairs
+struct shader_interface {
+    enum class view_kind { none, texture, storage_buffer, storage_image };
+
+    struct view_slot {
+        view_kind kind = view_kind::none;
+        sg_shader_stage stage = SG_SHADERSTAGE_NONE;
+        sg_image_type image_type = _SG_IMAGETYPE_DEFAULT;
+        sg_image_sample_type sample_type = _SG_IMAGESAMPLETYPE_DEFAULT;
+        bool multisampled = false;
+    };
+
+    struct sampler_slot {
+        sg_shader_stage stage = SG_SHADERSTAGE_NONE;
+        sg_sampler_type sampler_type = _SG_SAMPLERTYPE_DEFAULT;
+    };
+
+    struct uniform_block_slot {
+        sg_shader_stage stage = SG_SHADERSTAGE_NONE;
+        uint32_t size = 0;
+    };
+
+    struct pair_slot {
+        sg_shader_stage stage = SG_SHADERSTAGE_NONE;
+        int view_slot = 0;
+        int sampler_slot = 0;
+    };
+
+    sg_shader_attr_base_type attrs[SG_MAX_VERTEX_ATTRIBUTES] = {};
+    uniform_block_slot uniform_blocks[SG_MAX_UNIFORMBLOCK_BINDSLOTS] = {};
+    view_slot views[SG_MAX_VIEW_BINDSLOTS] = {};
+    sampler_slot samplers[SG_MAX_SAMPLER_BINDSLOTS] = {};
+    pair_slot pairs[SG_MAX_TEXTURE_SAMPLER_PAIRS] = {};
+
+    constexpr shader_interface& attr(int slot, sg_shader_attr_base_type base_type) {
+        attrs[slot] = base_type;
+        return *this;
+    }
+
+    constexpr shader_interface& uniform_block(int slot, sg_shader_stage stage, uint32_t size) {
+        uniform_blocks[slot] = {stage, size};
+        return *this;
+    }
+
+    constexpr shader_interface& texture(int slot, sg_shader_stage stage, sg_image_type image_type = SG_IMAGETYPE_2D,
+                                        sg_image_sample_type sample_type = SG_IMAGESAMPLETYPE_FLOAT, bool multisampled = false) {
+        views[slot] = {view_kind::texture, stage, image_type, sample_type, multisampled};
+        return *this;
+    }
+
+    constexpr shader_interface& storage_buffer(int slot, sg_shader_stage stage) {
+        views[slot] = {view_kind::storage_buffer, stage};
+        return *this;
+    }
+
+    constexpr shader_interface& storage_image(int slot, sg_shader_stage stage, sg_image_type image_type = SG_IMAGETYPE_2D) {
+        views[slot] = {view_kind::storage_image, stage, image_type};
+        return *this;
+    }
+
+    constexpr shader_interface& sampler(int slot, sg_shader_stage stage, sg_sampler_type sampler_type = SG_SAMPLERTYPE_FILTERING) {
+        samplers[slot] = {stage, sampler_type};
+        return *this;
+    }
+
+    constexpr shader_interface& texture_sampler_pair(int slot, sg_shader_stage stage, int view, int smp) {
+        pairs[slot] = {stage, view, smp};
+        return *this;
+    }
+
+    constexpr static shader_interface from(const sg_shader_desc& desc) {
+        shader_interface s;
+        for (int i = 0; i < SG_MAX_VERTEX_ATTRIBUTES; i++)
+            s.attrs[i] = desc.attrs[i].base_type;
+        for (int i = 0; i < SG_MAX_UNIFORMBLOCK_BINDSLOTS; i++)
+            s.uniform_blocks[i] = {desc.uniform_blocks[i].stage, desc.uniform_blocks[i].size};
+        for (int i = 0; i < SG_MAX_VIEW_BINDSLOTS; i++) {
+            const auto& v = desc.views[i];
+            if (v.texture.stage != SG_SHADERSTAGE_NONE)
+                s.views[i] = {view_kind::texture, v.texture.stage, v.texture.image_type, v.texture.sample_type, v.texture.multisampled};
+            else if (v.storage_buffer.stage != SG_SHADERSTAGE_NONE)
+                s.views[i] = {view_kind::storage_buffer, v.storage_buffer.stage};
+            else if (v.storage_image.stage != SG_SHADERSTAGE_NONE)
+                s.views[i] = {view_kind::storage_image, v.storage_image.stage, v.storage_image.image_type};
+        }
+        for (int i = 0; i < SG_MAX_SAMPLER_BINDSLOTS; i++)
+            s.samplers[i] = {desc.samplers[i].stage, desc.samplers[i].sampler_type};
+        for (int i = 0; i < SG_MAX_TEXTURE_SAMPLER_PAIRS; i++) {
+            const auto& p = desc.texture_sampler_pairs[i];
+            s.pairs[i] = {p.stage, p.view_slot, p.sampler_slot};
+        }
+        return s;
+    }
+
+    // Write the reflection fields; backend specifics (sources, bytecode, binding numbers) are left alone
+    void apply(sg_shader_desc& desc) const {
+        for (int i = 0; i < SG_MAX_VERTEX_ATTRIBUTES; i++)
+            desc.attrs[i].base_type = attrs[i];
+        for (int i = 0; i < SG_MAX_UNIFORMBLOCK_BINDSLOTS; i++) {
+            desc.uniform_blocks[i].stage = uniform_blocks[i].stage;
+            desc.uniform_blocks[i].size = uniform_blocks[i].size;
+        }
+        for (int i = 0; i < SG_MAX_VIEW_BINDSLOTS; i++) {
+            auto& v = desc.views[i];
+            v.texture.stage = v.storage_buffer.stage = v.storage_image.stage = SG_SHADERSTAGE_NONE;
+            if (views[i].kind == view_kind::texture) {
+                v.texture.stage = views[i].stage;
+                v.texture.image_type = views[i].image_type;
+                v.texture.sample_type = views[i].sample_type;
+                v.texture.multisampled = views[i].multisampled;
+            } else if (views[i].kind == view_kind::storage_buffer) {
+                v.storage_buffer.stage = views[i].stage;
+            } else if (views[i].kind == view_kind::storage_image) {
+                v.storage_image.stage = views[i].stage;
+                v.storage_image.image_type = views[i].image_type;
+            }
+        }
+        for (int i = 0; i < SG_MAX_SAMPLER_BINDSLOTS; i++) {
+            desc.samplers[i].stage = samplers[i].stage;
+            desc.samplers[i].sampler_type = samplers[i].sampler_type;
+        }
+        for (int i = 0; i < SG_MAX_TEXTURE_SAMPLER_PAIRS; i++) {
+            desc.texture_sampler_pairs[i].stage = pairs[i].stage;
+            desc.texture_sampler_pairs[i].view_slot = pairs[i].view_slot;
+            desc.texture_sampler_pairs[i].sampler_slot = pairs[i].sampler_slot;
+        }
+    }
+};
+
+// Layout half of sg_pipeline_desc plus the sizes of the uniform data the application passes
+// to sg_apply_uniforms(), which sg_pipeline_desc does not record
+struct pipeline_layout {
+    struct attr_slot {
+        sg_vertex_format format = SG_VERTEXFORMAT_INVALID;
+        int buffer_index = 0;
+        int offset = 0;
+    };
+
+    struct buffer_slot {
+        int stride = 0;
+        sg_vertex_step step_func = _SG_VERTEXSTEP_DEFAULT;
+    };
+
+    struct uniform_slot {
+        sg_shader_stage stage = SG_SHADERSTAGE_NONE;
+        uint32_t size = 0;
+    };
+
+    attr_slot attrs[SG_MAX_VERTEX_ATTRIBUTES] = {};
+    buffer_slot buffers[SG_MAX_VERTEXBUFFER_BINDSLOTS] = {};
+    uniform_slot uniform_data[SG_MAX_UNIFORMBLOCK_BINDSLOTS] = {};
+    int color_count = 0;
+    sg_pixel_format colors[SG_MAX_COLOR_ATTACHMENTS] = {};
+    sg_pixel_format depth_format = _SG_PIXELFORMAT_DEFAULT;
+    int sample_count = 0;
+
+    // offset 0 on every attribute of a buffer lets sokol pack them in order
+    constexpr pipeline_layout& attr(int slot, sg_vertex_format format, int buffer_index = 0, int offset = 0) {
+        attrs[slot] = {format, buffer_index, offset};
+        return *this;
+    }
+
+    constexpr pipeline_layout& buffer(int slot, int stride, sg_vertex_step step_func = _SG_VERTEXSTEP_DEFAULT) {
+        buffers[slot] = {stride, step_func};
+        return *this;
+    }
+
+    // stage NONE accepts the block whatever stage the shader declares it in
+    constexpr pipeline_layout& uniforms(int slot, uint32_t size, sg_shader_stage stage = SG_SHADERSTAGE_NONE) {
+        uniform_data[slot] = {stage, size};
+        return *this;
+    }
+
+    constexpr pipeline_layout& color(int slot, sg_pixel_format format) {
+        colors[slot] = format;
+        color_count = color_count > slot + 1 ? color_count : slot + 1;
+        return *this;
+    }
+
+    constexpr pipeline_layout& depth(sg_pixel_format format) {
+        depth_format = format;
+        return *this;
+    }
+
+    constexpr pipeline_layout& samples(int count) {
+        sample_count = count;
+        return *this;
+    }
+
+    constexpr static pipeline_layout from(const sg_pipeline_desc& desc) {
+        pipeline_layout p;
+        for (int i = 0; i < SG_MAX_VERTEX_ATTRIBUTES; i++)
+            p.attrs[i] = {desc.layout.attrs[i].format, desc.layout.attrs[i].buffer_index, desc.layout.attrs[i].offset};
+        for (int i = 0; i < SG_MAX_VERTEXBUFFER_BINDSLOTS; i++)
+            p.buffers[i] = {desc.layout.buffers[i].stride, desc.layout.buffers[i].step_func};
+        p.color_count = desc.color_count;
+        for (int i = 0; i < SG_MAX_COLOR_ATTACHMENTS; i++)
+            p.colors[i] = desc.colors[i].pixel_format;
+        p.depth_format = desc.depth.pixel_format;
+        p.sample_count = desc.sample_count;
+        return p;
+    }
+
+    // Replace defaulted formats and counts with what sokol will pick, needs sg_setup()
+    void resolve_defaults() {
+        const auto& env = sg_query_desc().environment.defaults;
+        if (color_count == 0)
+            color_count = 1;
+        for (int i = 0; i < color_count && i < SG_MAX_COLOR_ATTACHMENTS; i++)
+            if (colors[i] == _SG_PIXELFORMAT_DEFAULT)
+                colors[i] = env.color_format;
+        if (depth_format == _SG_PIXELFORMAT_DEFAULT)
+            depth_format = env.depth_format;
+        if (sample_count == 0)
+            sample_count = env.sample_count;
+    }
+
+    void apply(sg_pipeline_desc& desc) const {
+        for (int i = 0; i < SG_MAX_VERTEX_ATTRIBUTES; i++) {
+            desc.layout.attrs[i].format = attrs[i].format;
+            desc.layout.attrs[i].buffer_index = attrs[i].buffer_index;
+            desc.layout.attrs[i].offset = attrs[i].offset;
+        }
+        for (int i = 0; i < SG_MAX_VERTEXBUFFER_BINDSLOTS; i++) {
+            desc.layout.buffers[i].stride = buffers[i].stride;
+            desc.layout.buffers[i].step_func = buffers[i].step_func;
+        }
+        desc.color_count = color_count;
+        for (int i = 0; i < SG_MAX_COLOR_ATTACHMENTS; i++)
+            desc.colors[i].pixel_format = colors[i];
+        desc.depth.pixel_format = depth_format;
+        desc.sample_count = sample_count;
+    }
+};
+
+// Attachment formats and sample count of a render pass
+struct pass_layout {
+    int color_count = 0;
+    sg_pixel_format colors[SG_MAX_COLOR_ATTACHMENTS] = {};
+    sg_pixel_format depth_format = SG_PIXELFORMAT_NONE;
+    int sample_count = 1;
+
+    constexpr pass_layout& color(int slot, sg_pixel_format format) {
+        colors[slot] = format;
+        color_count = color_count > slot + 1 ? color_count : slot + 1;
+        return *this;
+    }
+
+    constexpr pass_layout& depth(sg_pixel_format format) {
+        depth_format = format;
+        return *this;
+    }
+
+    constexpr pass_layout& samples(int count) {
+        sample_count = count;
+        return *this;
+    }
+
+    constexpr static pass_layout from(const sg_swapchain& swapchain) {
+        pass_layout p;
+        p.color(0, swapchain.color_format).depth(swapchain.depth_format).samples(swapchain.sample_count);
+        return p;
+    }
+
+    // Queries the images behind the attachment views, needs sg_setup()
+    static pass_layout from(const sg_attachments& atts) {
+        pass_layout p;
+        for (int i = 0; i < SG_MAX_COLOR_ATTACHMENTS; i++) {
+            if (atts.colors[i].id == SG_INVALID_ID)
+                continue;
+            sg_image img = sg_query_view_image(atts.colors[i]);
+            p.color(i, sg_query_image_pixelformat(img));
+            p.sample_count = sg_query_image_sample_count(img);
+        }
+        if (atts.depth_stencil.id != SG_INVALID_ID) {
+            sg_image img = sg_query_view_image(atts.depth_stencil);
+            p.depth_format = sg_query_image_pixelformat(img);
+            p.sample_count = sg_query_image_sample_count(img);
+        }
+        return p;
+    }
+
+    // Swapchain passes resolve defaulted formats from the environment
+    static pass_layout from(const sg_pass& pass) {
+        const sg_attachments& atts = pass.attachments;
+        bool offscreen = atts.depth_stencil.id != SG_INVALID_ID;
+        for (int i = 0; i < SG_MAX_COLOR_ATTACHMENTS; i++)
+            offscreen |= atts.colors[i].id != SG_INVALID_ID;
+        if (offscreen)
+            return from(atts);
+        pass_layout p = from(pass.swapchain);
+        const auto& env = sg_query_desc().environment.defaults;
+        if (p.colors[0] == _SG_PIXELFORMAT_DEFAULT)
+            p.colors[0] = env.color_format;
+        if (p.depth_format == _SG_PIXELFORMAT_DEFAULT)
+            p.depth_format = env.depth_format;
+        if (p.sample_count == 0)
+            p.sample_count = env.sample_count;
+        return p;
+    }
+
+    constexpr bool operator==(const pass_layout& other) const {
+        if (color_count != other.color_count || depth_format != other.depth_format || sample_count != other.sample_count)
+            return false;
+        for (int i = 0; i < color_count; i++)
+            if (colors[i] != other.colors[i])
+                return false;
+        return true;
+    }
+    constexpr bool operator!=(const pass_layout& other) const { return !(*this == other); }
+};
+
+// Texture-sampler pairs and uniform blocks of a shader on their own
+constexpr validation validate(const shader_interface& shd) {
+    using kind = shader_interface::view_kind;
+    for (int i = 0; i < SG_MAX_UNIFORMBLOCK_BINDSLOTS; i++)
+        if (shd.uniform_blocks[i].stage != SG_SHADERSTAGE_NONE && shd.uniform_blocks[i].size == 0)
+            return {validation::uniform_block_size_zero, i};
+    for (int i = 0; i < SG_MAX_TEXTURE_SAMPLER_PAIRS; i++) {
+        const auto& p = shd.pairs[i];
+        if (p.stage == SG_SHADERSTAGE_NONE)
+            continue;
+        if (p.view_slot < 0 || p.view_slot >= SG_MAX_VIEW_BINDSLOTS || shd.views[p.view_slot].kind != kind::texture)
+            return {validation::pair_view_not_texture, i};
+        if (p.sampler_slot < 0 || p.sampler_slot >= SG_MAX_SAMPLER_BINDSLOTS || shd.samplers[p.sampler_slot].stage == SG_SHADERSTAGE_NONE)
+            return {validation::pair_sampler_missing, i};
+        const auto& v = shd.views[p.view_slot];
+        const auto& s = shd.samplers[p.sampler_slot];
+        if (v.stage != p.stage || s.stage != p.stage)
+            return {validation::pair_stage_mismatch, i};
+        // depth textures need comparison samplers, integer and unfilterable textures non-filtering ones
+        const bool compare = s.sampler_type == SG_SAMPLERTYPE_COMPARISON;
+        const bool filtering = s.sampler_type == SG_SAMPLERTYPE_FILTERING || s.sampler_type == _SG_SAMPLERTYPE_DEFAULT;
+        switch (v.sample_type) {
+        case SG_IMAGESAMPLETYPE_DEPTH:
+            if (!compare)
+                return {validation::pair_sample_type_mismatch, i};
+            break;
+        case SG_IMAGESAMPLETYPE_SINT:
+        case SG_IMAGESAMPLETYPE_UINT:
+        case SG_IMAGESAMPLETYPE_UNFILTERABLE_FLOAT:
+            if (compare || filtering)
+                return {validation::pair_sample_type_mismatch, i};
+            break;
+        default:
+            if (compare)
+                return {validation::pair_sample_type_mismatch, i};
+            break;
+        }
+    }
+    return {};
+}
+
+// Vertex layout and uniform data of a pipeline against its shader
+constexpr validation validate(const shader_interface& shd, const pipeline_layout& pip) {
+    validation v = validate(shd);
+    if (!v)
+        return v;
+    for (int i = 0; i < SG_MAX_VERTEX_ATTRIBUTES; i++) {
+        const auto& a = pip.attrs[i];
+        if (shd.attrs[i] != SG_SHADERATTRBASETYPE_UNDEFINED) {
+            if (a.format == SG_VERTEXFORMAT_INVALID)
+                return {validation::attr_missing, i};
+            if (helper::vertex_format_base_type(a.format) != shd.attrs[i])
+                return {validation::attr_format_mismatch, i};
+        }
+        if (a.format != SG_VERTEXFORMAT_INVALID && (a.buffer_index < 0 || a.buffer_index >= SG_MAX_VERTEXBUFFER_BINDSLOTS))
+            return {validation::attr_buffer_out_of_range, i};
+    }
+    for (int b = 0; b < SG_MAX_VERTEXBUFFER_BINDSLOTS; b++) {
+        const int stride = pip.buffers[b].stride;
+        if (stride % 4 != 0)
+            return {validation::buffer_stride_unaligned, b};
+        if (stride == 0)
+            continue;
+        bool packed = true;
+        for (int i = 0; i < SG_MAX_VERTEX_ATTRIBUTES; i++)
+            if (pip.attrs[i].format != SG_VERTEXFORMAT_INVALID && pip.attrs[i].buffer_index == b && pip.attrs[i].offset != 0)
+                packed = false;
+        int end = 0;
+        for (int i = 0; i < SG_MAX_VERTEX_ATTRIBUTES; i++) {
+            const auto& a = pip.attrs[i];
+            if (a.format == SG_VERTEXFORMAT_INVALID || a.buffer_index != b)
+                continue;
+            const int bytes = helper::vertex_format_bytes(a.format);
+            end = packed ? end + bytes : a.offset + bytes;
+            if (end > stride)
+                return {validation::attr_exceeds_stride, i};
+        }
+    }
+    for (int i = 0; i < SG_MAX_UNIFORMBLOCK_BINDSLOTS; i++) {
+        const auto& u = pip.uniform_data[i];
+        if (u.size == 0)
+            continue;
+        const auto& ub = shd.uniform_blocks[i];
+        if (ub.stage == SG_SHADERSTAGE_NONE)
+            return {validation::uniform_block_missing, i};
+        if (ub.size != u.size)
+            return {validation::uniform_block_size_mismatch, i};
+        if (u.stage != SG_SHADERSTAGE_NONE && u.stage != ub.stage)
+            return {validation::uniform_block_stage_mismatch, i};
+    }
+    if (pip.color_count < 0 || pip.color_count > SG_MAX_COLOR_ATTACHMENTS)
+        return {validation::color_count_out_of_range, -1};
+    return {};
+}
+
+// Attachments of a pipeline against a pass it is used in; a defaulted format or sample
+// count matches anything here and is resolved by the runtime layouts
+constexpr validation validate(const pipeline_layout& pip, const pass_layout& pass) {
+    int color_count = pip.color_count ? pip.color_count : 1;
+    if (color_count > SG_MAX_COLOR_ATTACHMENTS)
+        return {validation::color_count_out_of_range, -1};
+    // depth-only passes take pipelines with a single NONE color format
+    if (pass.color_count == 0 && color_count == 1 && pip.colors[0] == SG_PIXELFORMAT_NONE)
+        color_count = 0;
+    if (color_count != pass.color_count)
+        return {validation::color_count_mismatch, -1};
+    for (int i = 0; i < color_count; i++)
+        if (!helper::same_format(pip.colors[i], pass.colors[i]))
+            return {validation::color_format_mismatch, i};
+    if (!helper::same_format(pip.depth_format, pass.depth_format))
+        return {validation::depth_format_mismatch, -1};
+    if (pip.sample_count != 0 && pass.sample_count != 0 && pip.sample_count != pass.sample_count)
+        return {validation::sample_count_mismatch, -1};
+    return {};
+}
+
+inline validation validate(const sg_shader_desc& shd, const sg_pipeline_desc& pip) {
+    return validate(shader_interface::from(shd), pipeline_layout::from(pip));
+}
+
+// static_assert(require(validate(...))) fails to compile on a mismatch with an error that
+// names it; returns true otherwise
+constexpr bool require(const validation& v) {
+    switch (v.err) {
+#define SG_VALIDATION_REQUIRE(name, msg) case validation::name: helper::pipeline_validation_failed_##name(v.slot); break;
+        SG_VALIDATION_ERRORS(SG_VALIDATION_REQUIRE)
+#undef SG_VALIDATION_REQUIRE
+    default:
+        break;
+    }
+    return true;
+}
+
+// Pool of transient render targets, keyed by size, pixel format and sample count.
+// Targets acquired during a frame are handed back by end_frame() and reused by
+// later acquire() calls; entries left unused for max_unused_frames are destroyed.
+class rt_pool {
+public:
+    struct key {
+        int width = 0;
+        int height = 0;
+        sg_pixel_format format = SG_PIXELFORMAT_RGBA8;
+        int sample_count = 1;
+
+        bool operator==(const key& other) const {
+            return width == other.width && height == other.height &&
+                   format == other.format && sample_count == other.sample_count;
+        }
+        bool operator!=(const key& other) const { return !(*this == other); }
+    };
+
+    struct target {
+        sg_image image = {};
+        sg_view attachment = {};  // color or depth-stencil attachment view
+        sg_view texture = {};     // texture view for sampling, only for sample_count == 1
+        key desc;
+    };
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t resident_bytes = 0;
+        int resident = 0;
+        int in_use = 0;
+
+        double hit_rate() const {
+            uint64_t total = hits + misses;
+            return total ? (double)hits / (double)total : 0.0;
+        }
+    };
+
+    explicit rt_pool(uint32_t max_unused_frames = 8) : max_unused_frames_(max_unused_frames) {}
+    rt_pool(const rt_pool&) = delete;
+    rt_pool& operator=(const rt_pool&) = delete;
+    ~rt_pool() { clear(); }
+
+    static bool is_depth_format(sg_pixel_format fmt) {
+        return fmt == SG_PIXELFORMAT_DEPTH || fmt == SG_PIXELFORMAT_DEPTH_STENCIL;
+    }
+
+    // Estimated GPU memory of one render target (all samples of mip 0)
+    static size_t target_bytes(const key& k) {
+        return (size_t)sg_query_surface_pitch(k.format, k.width, k.height, 1) * (size_t)(k.sample_count > 0 ? k.sample_count : 1);
+    }
+
+    // Hand out a target matching the key; valid until end_frame() or release()
+    target acquire(int width, int height, sg_pixel_format fmt = SG_PIXELFORMAT_RGBA8, int samples = 1) {
+        key k{width, height, fmt, samples};
+        for (auto& e : entries_) {
+            if (!e.in_use && e.rt.desc == k) {
+                e.in_use = true;
+                e.last_used = frame_;
+                stats_.hits++;
+                stats_.in_use++;
+                return e.rt;
+            }
+        }
+        stats_.misses++;
+        entry e;
+        e.rt = create(k);
+        e.bytes = target_bytes(k);
+        e.last_used = frame_;
+        e.in_use = true;
+        entries_.push_back(e);
+        stats_.resident++;
+        stats_.in_use++;
+        stats_.resident_bytes += e.bytes;
+        return e.rt;
+    }
+
+    // Return a target to the pool before the end of the frame
+    void release(const target& rt) {
+        for (auto& e : entries_) {
+            if (e.in_use && e.rt.image.id == rt.image.id) {
+                e.in_use = false;
+                stats_.in_use--;
+                return;
+            }
+        }
+    }
+
+    // Return all targets handed out this frame and evict stale entries
+    void end_frame() {
+        frame_++;
+        size_t n = 0;
+        for (size_t i = 0; i < entries_.size(); i++) {
+            entry& e = entries_[i];
+            if (e.in_use) {
+                e.in_use = false;
+                e.last_used = frame_;
+            } else if (frame_ - e.last_used > max_unused_frames_) {
+                destroy(e);
+                stats_.evictions++;
+                continue;
+            }
+            entries_[n++] = e;
+        }
+        entries_.resize(n);
+        stats_.in_use = 0;
+    }
+
+    // Destroy every pooled target, including those still handed out
+    void clear() {
+        for (auto& e : entries_)
+            destroy(e);
+        entries_.clear();
+        stats_.in_use = 0;
+    }
+
+    void set_max_unused_frames(uint32_t frames) { max_unused_frames_ = frames; }
+    uint32_t max_unused_frames() const { return max_unused_frames_; }
+    uint64_t frame() const { return frame_; }
+    const stats& query_stats() const { return stats_; }
+    void reset_stats() {
+        stats_.hits = 0;
+        stats_.misses = 0;
+        stats_.evictions = 0;
+    }
+
+private:
+    struct entry {
+        target rt;
+        size_t bytes = 0;
+        uint64_t last_used = 0;
+        bool in_use = false;
+    };
+
+    static target create(const key& k) {
+        target rt;
+        rt.desc = k;
+        const bool depth = is_depth_format(k.format);
+        image_desc img = depth ? image_desc::make_depth_stencil(k.width, k.height, k.format, k.sample_count)
+                               : image_desc::make_render_target(k.width, k.height, k.format, k.sample_count);
+        img.label("sg::rt_pool");
+        rt.image = sg_type_traits<sg_image_desc>::make(&img);
+        view_desc att;
+        if (depth)
+            att.depth_stencil_attachment_image_id(rt.image.id);
+        else
+            att.color_attachment_image_id(rt.image.id);
+        rt.attachment = sg_make_view(&att);
+        if (k.sample_count <= 1) {
+            view_desc tex;
+            tex.texture_image_id(rt.image.id);
+            rt.texture = sg_make_view(&tex);
+        }
+        return rt;
+    }
+
+    void destroy(entry& e) {
+        if (e.rt.texture.id != SG_INVALID_ID)
+            sg_destroy_view(e.rt.texture);
+        if (e.rt.attachment.id != SG_INVALID_ID)
+            sg_destroy_view(e.rt.attachment);
+        if (e.rt.image.id != SG_INVALID_ID)
+            sg_type_traits<sg_image_desc>::destroy(e.rt.image);
+        stats_.resident--;
+        stats_.resident_bytes -= e.bytes;
+    }
+
+    std::vector<entry> entries_;
+    uint32_t max_unused_frames_;
+    uint64_t frame_ = 0;
+    stats stats_;
+};
+
+// Typed storage buffer with its storage-buffer view, sized in elements of T
+template <typename T>
+class storage_buffer {
+public:
+    storage_buffer() = default;
+    explicit storage_buffer(size_t count, const T* data = nullptr, const char* label = nullptr) : count_(count) {
+        buffer_desc desc;
+        desc.size(count * sizeof(T)).usage_storage_buffer(true);
+        if (data)
+            desc.data_ptr(data).data_size(count * sizeof(T));
+        else
+            desc.usage_immutable(false).usage_dynamic_update(true);
+        if (label)
+            desc.label(label);
+        buffer_ = desc.build();
+        view_ = view_desc().storage_buffer_buffer_id(buffer_.id()).build();
+    }
+    storage_buffer(storage_buffer&& other) noexcept
+        : buffer_(std::move(other.buffer_)), view_(std::move(other.view_)), count_(std::exchange(other.count_, 0)) {}
+    storage_buffer& operator=(storage_buffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            buffer_ = std::move(other.buffer_);
+            view_ = std::move(other.view_);
+            count_ = std::exchange(other.count_, 0);
+        }
+        return *this;
+    }
+
+    // Only valid for buffers created without initial data
+    void update(const T* data, size_t count) {
+        sg_range range = {data, count * sizeof(T)};
+        sg_update_buffer(buffer_, &range);
+    }
+
+    void reset() {
+        view_.reset();
+        buffer_.reset();
+        count_ = 0;
+    }
+
+    sg_buffer buffer() const { return buffer_.get(); }
+    sg_view view() const { return view_.get(); }
+    size_t count() const { return count_; }
+    size_t size_bytes() const { return count_ * sizeof(T); }
+
+private:
+    // declared before the view so it is destroyed after it
+    sg::buffer buffer_;
+    sg::view view_;
+    size_t count_ = 0;
+};
+
+// Storage image with a storage-image view for compute writes and a texture view for sampling
+class storage_image {
+public:
+    storage_image() = default;
+    storage_image(int width, int height, sg_pixel_format fmt = SG_PIXELFORMAT_RGBA32F, const char* label = nullptr) {
+        image_desc desc;
+        desc.type(SG_IMAGETYPE_2D)
+            .width(width)
+            .height(height)
+            .pixel_format(fmt)
+            .usage_storage_image(true);
+        if (label)
+            desc.label(label);
+        image_ = desc.build();
+        storage_view_ = view_desc().storage_image_image_id(image_.id()).build();
+        texture_view_ = view_desc().texture_image_id(image_.id()).build();
+    }
+    storage_image(storage_image&& other) noexcept = default;
+    // the views are released before the image, not in member order
+    storage_image& operator=(storage_image&& other) noexcept {
+        if (this != &other) {
+            reset();
+            image_ = std::move(other.image_);
+            storage_view_ = std::move(other.storage_view_);
+            texture_view_ = std::move(other.texture_view_);
+        }
+        return *this;
+    }
+
+    void reset() {
+        texture_view_.reset();
+        storage_view_.reset();
+        image_.reset();
+    }
+
+    sg_image image() const { return image_.get(); }
+    sg_view view() const { return storage_view_.get(); }
+    sg_view texture_view() const { return texture_view_.get(); }
+
+private:
+    // declared before the views so it is destroyed after them
+    sg::image image_;
+    sg::view storage_view_;
+    sg::view texture_view_;
+};
+
+// Double-buffered resource pair; read the front, write the back, then swap()
+template <typename T>
+class ping_pong {
+public:
+    ping_pong() = default;
+    ping_pong(T&& a, T&& b) : res_{std::move(a), std::move(b)} {}
+
+    template <typename... Args>
+    static ping_pong make(const Args&... args) {
+        return ping_pong(T(args...), T(args...));
+    }
+
+    T& front() { return res_[index_]; }
+    T& back() { return res_[index_ ^ 1]; }
+    const T& front() const { return res_[index_]; }
+    const T& back() const { return res_[index_ ^ 1]; }
+    sg_view read_view() const { return front().view(); }
+    sg_view write_view() const { return back().view(); }
+    void swap() { index_ ^= 1; }
+
+private:
+    T res_[2];
+    int index_ = 0;
+};
+
+// Scoped compute pass; dispatches issued through it share one sg_begin_pass/sg_end_pass,
+// and pipeline and bindings are only re-applied when they change between dispatches
+class compute_pass {
+public:
+    explicit compute_pass(const char* label = nullptr) {
+        sg_pass pass = {};
+        pass.compute = true;
+        pass.label = label;
+        sg_begin_pass(&pass);
+        active_ = true;
+    }
+    compute_pass(const compute_pass&) = delete;
+    compute_pass& operator=(const compute_pass&) = delete;
+    ~compute_pass() { end(); }
+
+    // Number of workgroups needed to cover n invocations
+    static int group_count(int n, int group_size) {
+        return group_size > 0 ? (n + group_size - 1) / group_size : 0;
+    }
+
+    compute_pass& pipeline(sg_pipeline pip) {
+        if (pip.id != pipeline_.id) {
+            pipeline_ = pip;
+            sg_apply_pipeline(pip);
+            // bindings must be re-applied after a pipeline change
+            bindings_dirty_ = true;
+        }
+        return *this;
+    }
+
+    // Slots outside sg_bindings are ignored
+    compute_pass& view(int slot, sg_view v) {
+        if (slot < 0 || slot >= SG_MAX_VIEW_BINDSLOTS)
+            return *this;
+        if (bindings_.views[slot].id != v.id) {
+            bindings_.views[slot] = v;
+            bindings_dirty_ = true;
+        }
+        return *this;
+    }
+
+    compute_pass& sampler(int slot, sg_sampler smp) {
+        if (slot < 0 || slot >= SG_MAX_SAMPLER_BINDSLOTS)
+            return *this;
+        if (bindings_.samplers[slot].id != smp.id) {
+            bindings_.samplers[slot] = smp;
+            bindings_dirty_ = true;
+        }
+        return *this;
+    }
+
+    // Bind the read side of a ping-pong pair to read_slot and the write side to write_slot
+    template <typename T>
+    compute_pass& ping_pong_views(int read_slot, int write_slot, const ping_pong<T>& pp) {
+        return view(read_slot, pp.read_view()).view(write_slot, pp.write_view());
+    }
+
+    template <typename T>
+    compute_pass& uniforms(int slot, const T& data) {
+        sg_range range = {&data, sizeof(T)};
+        sg_apply_uniforms(slot, &range);
+        return *this;
+    }
+
+    compute_pass& dispatch(int groups_x, int groups_y = 1, int groups_z = 1) {
+        flush_bindings();
+        if (groups_x > 0 && groups_y > 0 && groups_z > 0) {
+            sg_dispatch(groups_x, groups_y, groups_z);
+            dispatches_++;
+        }
+        return *this;
+    }
+
+    // Dispatch enough workgroups of the given size to cover an nx * ny * nz problem
+    compute_pass& dispatch_threads(int nx, int group_x, int ny = 1, int group_y = 1, int nz = 1, int group_z = 1) {
+        return dispatch(group_count(nx, group_x), group_count(ny, group_y), group_count(nz, group_z));
+    }
+
+    void end() {
+        if (active_) {
+            sg_end_pass();
+            active_ = false;
+        }
+    }
+
+    int num_dispatches() const { return dispatches_; }
+
+private:
+    void flush_bindings() {
+        if (bindings_dirty_) {
+            sg_apply_bindings(&bindings_);
+            bindings_dirty_ = false;
+        }
+    }
+
+    sg_bindings bindings_ = {};
+    sg_pipeline pipeline_ = {};
+    bool bindings_dirty_ = true;
+    bool active_ = false;
+    int dispatches_ = 0;
+};
+
+// Runs frames against sokol_gfx without sokol_app, for measuring CPU cost in CI.
+// Link the sokol_gfx implementation with SOKOL_DUMMY_BACKEND so no GPU or window is needed.
+class headless {
+public:
+    struct config {
+        int width = 1280;
+        int height = 720;
+        sg_pixel_format color_format = SG_PIXELFORMAT_RGBA8;
+        sg_pixel_format depth_format = SG_PIXELFORMAT_DEPTH_STENCIL;
+        int sample_count = 1;
+        int warmup_frames = 0;  // run but not recorded
+    };
+
+    struct report {
+        int frames = 0;
+        double total_ms = 0.0;
+        double min_ms = 0.0;
+        double max_ms = 0.0;
+        double mean_ms = 0.0;
+        double stddev_ms = 0.0;
+        double p50_ms = 0.0;
+        double p90_ms = 0.0;
+        double p95_ms = 0.0;
+        double p99_ms = 0.0;
+        std::vector<double> frame_ms;
+        std::vector<sg_frame_stats> frame_stats;
+
+        // Nearest-rank percentile over the recorded frame times, p in [0, 100]
+        double percentile(double p) const {
+            if (frame_ms.empty())
+                return 0.0;
+            std::vector<double> sorted(frame_ms);
+            std::sort(sorted.begin(), sorted.end());
+            size_t rank = (size_t)std::ceil(p / 100.0 * (double)sorted.size());
+            return sorted[rank ? std::min(rank, sorted.size()) - 1 : 0];
+        }
+
+        void print(FILE* out = stdout) const {
+            fprintf(out, "frames: %d, total: %.3f ms\n", frames, total_ms);
+            fprintf(out, "min %.4f  mean %.4f  stddev %.4f  max %.4f ms\n", min_ms, mean_ms, stddev_ms, max_ms);
+            fprintf(out, "p50 %.4f  p90 %.4f  p95 %.4f  p99 %.4f ms\n", p50_ms, p90_ms, p95_ms, p99_ms);
+        }
+    };
+
+    explicit headless(const desc& d = desc()) : headless(d, config()) {}
+    headless(const desc& d, const config& cfg) : cfg_(cfg) {
+        sg_setup(&d);
+        sg_enable_frame_stats();
+        pass_.action.colors[0].load_action = SG_LOADACTION_DONTCARE;
+        pass_.action.depth.load_action = SG_LOADACTION_DONTCARE;
+        pass_.action.stencil.load_action = SG_LOADACTION_DONTCARE;
+        pass_.swapchain.width = cfg.width;
+        pass_.swapchain.height = cfg.height;
+        pass_.swapchain.sample_count = cfg.sample_count;
+        pass_.swapchain.color_format = cfg.color_format;
+        pass_.swapchain.depth_format = cfg.depth_format;
+        pass_.label = "sg::headless";
+    }
+    headless(const headless&) = delete;
+    headless& operator=(const headless&) = delete;
+    ~headless() { sg_shutdown(); }
+
+    bool is_dummy() const { return sg_query_backend() == SG_BACKEND_DUMMY; }
+    sg_pass_action& pass_action() { return pass_.action; }
+    const config& get_config() const { return cfg_; }
+
+    // Call frame_fn(frame_index) inside a swapchain pass for each frame, then commit.
+    // Passing begin_pass = false leaves pass management to frame_fn (e.g. for offscreen passes).
+    template <typename F>
+    report run(int frames, F&& frame_fn, bool begin_pass = true) {
+        report r;
+        r.frame_ms.reserve(frames > 0 ? (size_t)frames : 0);
+        r.frame_stats.reserve(frames > 0 ? (size_t)frames : 0);
+        for (int i = -cfg_.warmup_frames; i < frames; i++) {
+            auto start = std::chrono::steady_clock::now();
+            if (begin_pass)
+                sg_begin_pass(&pass_);
+            frame_fn(i);
+            if (begin_pass)
+                sg_end_pass();
+            sg_commit();
+            auto end = std::chrono::steady_clock::now();
+            if (i < 0)
+                continue;
+            r.frame_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            r.frame_stats.push_back(sg_query_frame_stats());
+        }
+        summarize(r);
+        return r;
+    }
+
+private:
+    static void summarize(report& r) {
+        r.frames = (int)r.frame_ms.size();
+        if (r.frame_ms.empty())
+            return;
+        std::vector<double> sorted(r.frame_ms);
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double ms : sorted)
+            sum += ms;
+        r.total_ms = sum;
+        r.mean_ms = sum / (double)sorted.size();
+        double var = 0.0;
+        for (double ms : sorted)
+            var += (ms - r.mean_ms) * (ms - r.mean_ms);
+        r.stddev_ms = std::sqrt(var / (double)sorted.size());
+        r.min_ms = sorted.front();
+        r.max_ms = sorted.back();
+        auto rank = [&](double p) {
+            size_t n = (size_t)std::ceil(p / 100.0 * (double)sorted.size());
+            return sorted[n ? std::min(n, sorted.size()) - 1 : 0];
+        };
+        r.p50_ms = rank(50.0);
+        r.p90_ms = rank(90.0);
+        r.p95_ms = rank(95.0);
+        r.p99_ms = rank(99.0);
+    }
+
+    config cfg_;
+    sg_pass pass_ = {};
+};
+
+} // namespace sg
+#endif // SOKOL_NO_SG
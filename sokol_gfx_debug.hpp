@@ -0,0 +1,831 @@
+/* sokol_gfx_debug.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+// Frame telemetry, GPU memory accounting and runtime pipeline checking for sokol_gfx. Not part
+// of the sokol.hpp umbrella, so translation units that only render do not pay for it
+#pragma once
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include "sokol_gfx.hpp"
+
+#ifndef SOKOL_NO_SG
+namespace sg {
+// Per-frame sg_frame_stats snapshots in a fixed-size ring, with derived metrics,
+// CSV/JSON export and threshold watches. Call snapshot() once per frame after sg_commit().
+class telemetry {
+public:
+    enum class metric {
+        passes,
+        draws,
+        dispatches,
+        pipeline_switches,
+        bindings,
+        uniform_applies,
+        uniform_bytes,
+        uniform_bytes_per_draw,
+        bindings_per_draw,
+        buffer_updates,
+        buffer_appends,
+        image_updates,
+        upload_bytes,
+        num
+    };
+
+    static constexpr int num_metrics = (int)metric::num;
+
+    // Called when a watched metric rises above its threshold (once per crossing)
+    using callback = std::function<void(metric m, double value, double threshold, const sg_frame_stats& stats)>;
+
+    explicit telemetry(size_t capacity = 600) : ring_(capacity ? capacity : 1) {
+        sg_enable_frame_stats();
+    }
+
+    static const char* name(metric m) {
+        static const char* names[num_metrics] = {
+            "passes",
+            "draws",
+            "dispatches",
+            "pipeline_switches",
+            "bindings",
+            "uniform_applies",
+            "uniform_bytes",
+            "uniform_bytes_per_draw",
+            "bindings_per_draw",
+            "buffer_updates",
+            "buffer_appends",
+            "image_updates",
+            "upload_bytes",
+        };
+        return names[(int)m];
+    }
+
+    static double value(metric m, const sg_frame_stats& s) {
+        switch (m) {
+            case metric::passes: return s.num_passes;
+            case metric::draws: return s.num_draw;
+            case metric::dispatches: return s.num_dispatch;
+            case metric::pipeline_switches: return s.num_apply_pipeline;
+            case metric::bindings: return s.num_apply_bindings;
+            case metric::uniform_applies: return s.num_apply_uniforms;
+            case metric::uniform_bytes: return s.size_apply_uniforms;
+            case metric::uniform_bytes_per_draw: return s.num_draw ? (double)s.size_apply_uniforms / s.num_draw : 0.0;
+            case metric::bindings_per_draw: return s.num_draw ? (double)s.num_apply_bindings / s.num_draw : 0.0;
+            case metric::buffer_updates: return s.num_update_buffer;
+            case metric::buffer_appends: return s.num_append_buffer;
+            case metric::image_updates: return s.num_update_image;
+            case metric::upload_bytes: return (double)s.size_update_buffer + s.size_append_buffer + s.size_update_image;
+            default: return 0.0;
+        }
+    }
+
+    // Record the stats of the last committed frame and evaluate the watches
+    void snapshot() {
+        record(sg_query_frame_stats());
+    }
+
+    void record(const sg_frame_stats& stats) {
+        ring_[next_] = stats;
+        next_ = (next_ + 1) % ring_.size();
+        if (count_ < ring_.size())
+            count_++;
+        for (auto& w : watches_) {
+            double v = value(w.m, stats);
+            bool above = v > w.threshold;
+            if (above && !w.above && w.fn)
+                w.fn(w.m, v, w.threshold, stats);
+            w.above = above;
+        }
+    }
+
+    // Watch a metric; returns an id for unwatch()
+    int watch(metric m, double threshold, callback fn) {
+        watches_.push_back({next_watch_id_, m, threshold, std::move(fn), false});
+        return next_watch_id_++;
+    }
+
+    void unwatch(int id) {
+        watches_.erase(std::remove_if(watches_.begin(), watches_.end(), [id](const watch_entry& w) { return w.id == id; }), watches_.end());
+    }
+
+    size_t capacity() const { return ring_.size(); }
+    size_t size() const { return count_; }
+    void clear() {
+        count_ = 0;
+        next_ = 0;
+    }
+
+    // i = 0 is the oldest snapshot, size() - 1 the newest
+    const sg_frame_stats& at(size_t i) const {
+        return ring_[(next_ + ring_.size() - count_ + i) % ring_.size()];
+    }
+    const sg_frame_stats& latest() const { return at(count_ - 1); }
+
+    double average(metric m) const {
+        double sum = 0.0;
+        for (size_t i = 0; i < count_; i++)
+            sum += value(m, at(i));
+        return count_ ? sum / (double)count_ : 0.0;
+    }
+
+    double peak(metric m) const {
+        double peak = 0.0;
+        for (size_t i = 0; i < count_; i++)
+            peak = std::max(peak, value(m, at(i)));
+        return peak;
+    }
+
+    void write_csv(FILE* out) const {
+        fprintf(out, "frame_index");
+        for (int m = 0; m < num_metrics; m++)
+            fprintf(out, ",%s", name((metric)m));
+        fprintf(out, "\n");
+        for (size_t i = 0; i < count_; i++) {
+            const sg_frame_stats& s = at(i);
+            fprintf(out, "%u", s.frame_index);
+            for (int m = 0; m < num_metrics; m++)
+                fprintf(out, ",%.10g", value((metric)m, s));
+            fprintf(out, "\n");
+        }
+    }
+
+    void write_json(FILE* out) const {
+        fprintf(out, "[\n");
+        for (size_t i = 0; i < count_; i++) {
+            const sg_frame_stats& s = at(i);
+            fprintf(out, "  {\"frame_index\": %u", s.frame_index);
+            for (int m = 0; m < num_metrics; m++)
+                fprintf(out, ", \"%s\": %.10g", name((metric)m), value((metric)m, s));
+            fprintf(out, "}%s\n", i + 1 < count_ ? "," : "");
+        }
+        fprintf(out, "]\n");
+    }
+
+private:
+    struct watch_entry {
+        int id;
+        metric m;
+        double threshold;
+        callback fn;
+        bool above;
+    };
+
+    std::vector<sg_frame_stats> ring_;
+    size_t next_ = 0;
+    size_t count_ = 0;
+    std::vector<watch_entry> watches_;
+    int next_watch_id_ = 1;
+};
+
+namespace helper {
+// Intrusive list of the live instances of T in construction order; the newest is the active
+// one. Each instance unlinks itself on destruction, so they may be destroyed in any order.
+template <typename T>
+class instance_list {
+public:
+    instance_list(const instance_list&) = delete;
+    instance_list& operator=(const instance_list&) = delete;
+
+    static T* active() { return static_cast<T*>(tail_); }
+
+protected:
+    instance_list() {
+        prev_ = tail_;
+        if (tail_)
+            tail_->next_ = this;
+        tail_ = this;
+    }
+    // The instance that becomes active once this one is destroyed
+    T* next_active() const { return static_cast<T*>(tail_ == this ? prev_ : tail_); }
+
+    ~instance_list() {
+        if (prev_)
+            prev_->next_ = next_;
+        if (next_)
+            next_->prev_ = prev_;
+        else
+            tail_ = prev_;
+    }
+
+private:
+    instance_list* prev_ = nullptr;
+    instance_list* next_ = nullptr;
+    static inline instance_list* tail_ = nullptr;
+};
+
+#ifdef SOKOL_TRACE_HOOKS
+// One sg_trace_hooks installation shared by every live memory_tracker and pipeline_checker,
+// counted by acquire() and release(); the hooks forward to on_make()/on_destroy() and so to
+// the active instances, and to the hooks that were installed before. sg_install_trace_hooks()
+// needs a valid sokol_gfx and sg_setup() resets the hooks, so an installation requested
+// earlier happens on the first install_pending() after sg_setup().
+class trace_dispatch {
+public:
+    static void acquire() {
+        if (users_++ == 0)
+            pending_ = true;
+        install_pending();
+    }
+
+    static void release() {
+        if (users_ == 0 || --users_ > 0)
+            return;
+        if (installed_ && sg_isvalid())
+            sg_install_trace_hooks(&prev_hooks_);
+        installed_ = false;
+        pending_ = false;
+    }
+
+    static void install_pending() {
+        if (pending_ && sg_isvalid()) {
+            pending_ = false;
+            installed_ = true;
+            install();
+        }
+    }
+
+private:
+    static void install() {
+        sg_trace_hooks hooks = {};
+        prev_hooks_ = sg_install_trace_hooks(&hooks);
+        hooks = prev_hooks_;
+        hooks.make_buffer = [](const sg_buffer_desc* desc, sg_buffer buf, void* ud) {
+            on_make(desc, buf);
+            if (prev_hooks_.make_buffer)
+                prev_hooks_.make_buffer(desc, buf, ud);
+        };
+        hooks.make_image = [](const sg_image_desc* desc, sg_image img, void* ud) {
+            on_make(desc, img);
+            if (prev_hooks_.make_image)
+                prev_hooks_.make_image(desc, img, ud);
+        };
+        hooks.init_buffer = [](sg_buffer buf, const sg_buffer_desc* desc, void* ud) {
+            on_make(desc, buf);
+            if (prev_hooks_.init_buffer)
+                prev_hooks_.init_buffer(buf, desc, ud);
+        };
+        hooks.init_image = [](sg_image img, const sg_image_desc* desc, void* ud) {
+            on_make(desc, img);
+            if (prev_hooks_.init_image)
+                prev_hooks_.init_image(img, desc, ud);
+        };
+        hooks.destroy_buffer = [](sg_buffer buf, void* ud) {
+            on_destroy(buf);
+            if (prev_hooks_.destroy_buffer)
+                prev_hooks_.destroy_buffer(buf, ud);
+        };
+        hooks.destroy_image = [](sg_image img, void* ud) {
+            on_destroy(img);
+            if (prev_hooks_.destroy_image)
+                prev_hooks_.destroy_image(img, ud);
+        };
+        hooks.uninit_buffer = [](sg_buffer buf, void* ud) {
+            on_destroy(buf);
+            if (prev_hooks_.uninit_buffer)
+                prev_hooks_.uninit_buffer(buf, ud);
+        };
+        hooks.uninit_image = [](sg_image img, void* ud) {
+            on_destroy(img);
+            if (prev_hooks_.uninit_image)
+                prev_hooks_.uninit_image(img, ud);
+        };
+        hooks.make_shader = [](const sg_shader_desc* desc, sg_shader shd, void* ud) {
+            on_make(desc, shd);
+            if (prev_hooks_.make_shader)
+                prev_hooks_.make_shader(desc, shd, ud);
+        };
+        // pipelines go to the previous hooks first, a rejecting pipeline_checker destroys them
+        hooks.make_pipeline = [](const sg_pipeline_desc* desc, sg_pipeline pip, void* ud) {
+            if (prev_hooks_.make_pipeline)
+                prev_hooks_.make_pipeline(desc, pip, ud);
+            on_make(desc, pip);
+        };
+        hooks.init_shader = [](sg_shader shd, const sg_shader_desc* desc, void* ud) {
+            on_make(desc, shd);
+            if (prev_hooks_.init_shader)
+                prev_hooks_.init_shader(shd, desc, ud);
+        };
+        hooks.init_pipeline = [](sg_pipeline pip, const sg_pipeline_desc* desc, void* ud) {
+            if (prev_hooks_.init_pipeline)
+                prev_hooks_.init_pipeline(pip, desc, ud);
+            on_make(desc, pip);
+        };
+        hooks.destroy_shader = [](sg_shader shd, void* ud) {
+            on_destroy(shd);
+            if (prev_hooks_.destroy_shader)
+                prev_hooks_.destroy_shader(shd, ud);
+        };
+        hooks.destroy_pipeline = [](sg_pipeline pip, void* ud) {
+            on_destroy(pip);
+            if (prev_hooks_.destroy_pipeline)
+                prev_hooks_.destroy_pipeline(pip, ud);
+        };
+        hooks.uninit_shader = [](sg_shader shd, void* ud) {
+            on_destroy(shd);
+            if (prev_hooks_.uninit_shader)
+                prev_hooks_.uninit_shader(shd, ud);
+        };
+        hooks.uninit_pipeline = [](sg_pipeline pip, void* ud) {
+            on_destroy(pip);
+            if (prev_hooks_.uninit_pipeline)
+                prev_hooks_.uninit_pipeline(pip, ud);
+        };
+        sg_install_trace_hooks(&hooks);
+    }
+
+    static inline sg_trace_hooks prev_hooks_ = {};
+    static inline int users_ = 0;
+    static inline bool pending_ = false;
+    static inline bool installed_ = false;
+};
+#endif
+} // namespace helper
+
+// Estimated GPU memory of every buffer and image created through the wrapper (the builders'
+// build(), sg_type_traits and so rt_pool, storage_buffer and storage_image), aggregated by
+// kind and by label, with budgets that warn before they are exhausted. The most recently
+// constructed live tracker is the active one; trackers may be destroyed in any order.
+// Resources created or destroyed through the C API are picked up by track() and sync(), or
+// automatically when sokol_gfx is built with SOKOL_TRACE_HOOKS; a tracker created before
+// sg_setup() installs the hooks once sokol_gfx is valid, at the first wrapper call, track()
+// or sync() after it.
+class memory_tracker : public helper::instance_list<memory_tracker>, helper::memory_hooks {
+public:
+    enum class kind {
+        vertex_buffer,
+        index_buffer,
+        storage_buffer,
+        texture,
+        color_attachment,
+        depth_stencil_attachment,
+        resolve_attachment,
+        storage_image,
+        num
+    };
+
+    static constexpr int num_kinds = (int)kind::num;
+
+    struct totals {
+        size_t bytes = 0;
+        size_t peak_bytes = 0;
+        int count = 0;
+    };
+
+    // Called when usage in a scope ("total", a kind name or a label) rises past the warning
+    // fraction of its budget, and again when it exceeds the budget
+    using callback = std::function<void(const char* scope, size_t used, size_t budget, bool exceeded)>;
+
+    // resolve_copy: count an extra single-sampled surface for MSAA images, as backends that
+    // resolve implicitly allocate one
+    explicit memory_tracker(bool resolve_copy = true) : resolve_copy_(resolve_copy) {
+        helper::memory_observer = this;
+#ifdef SOKOL_TRACE_HOOKS
+        helper::trace_dispatch::acquire();
+#endif
+    }
+    ~memory_tracker() {
+        helper::memory_observer = next_active();
+#ifdef SOKOL_TRACE_HOOKS
+        helper::trace_dispatch::release();
+#endif
+    }
+
+    // Install trace hooks requested before sg_setup(); called from the wrapper paths, track()
+    // and sync()
+    static void install_pending_hooks() {
+#ifdef SOKOL_TRACE_HOOKS
+        helper::trace_dispatch::install_pending();
+#endif
+    }
+
+    static const char* name(kind k) {
+        static const char* names[num_kinds] = {
+            "vertex_buffer",
+            "index_buffer",
+            "storage_buffer",
+            "texture",
+            "color_attachment",
+            "depth_stencil_attachment",
+            "resolve_attachment",
+            "storage_image",
+        };
+        return names[(int)k];
+    }
+
+    static kind classify(const sg_buffer_desc& desc) {
+        if (desc.usage.storage_buffer)
+            return kind::storage_buffer;
+        if (desc.usage.index_buffer)
+            return kind::index_buffer;
+        return kind::vertex_buffer;
+    }
+
+    static kind classify(const sg_image_desc& desc) {
+        if (desc.usage.color_attachment)
+            return kind::color_attachment;
+        if (desc.usage.depth_stencil_attachment)
+            return kind::depth_stencil_attachment;
+        if (desc.usage.resolve_attachment)
+            return kind::resolve_attachment;
+        if (desc.usage.storage_image)
+            return kind::storage_image;
+        return kind::texture;
+    }
+
+    static size_t buffer_bytes(const sg_buffer_desc& desc) {
+        return desc.size ? desc.size : desc.data.size;
+    }
+
+    // Bytes of the full mip chain over all faces/slices and samples; compressed formats are
+    // measured in whole blocks by sg_query_surface_pitch()
+    static size_t image_bytes(const sg_image_desc& desc, bool resolve_copy = true) {
+        sg_pixel_format fmt = desc.pixel_format;
+        if (fmt == _SG_PIXELFORMAT_DEFAULT) {
+            if (desc.usage.depth_stencil_attachment)
+                fmt = sg_query_desc().environment.defaults.depth_format;
+            else if (desc.usage.color_attachment || desc.usage.resolve_attachment)
+                fmt = sg_query_desc().environment.defaults.color_format;
+            if (fmt == _SG_PIXELFORMAT_DEFAULT)
+                fmt = SG_PIXELFORMAT_RGBA8;
+        }
+        const int width = std::max(desc.width, 1);
+        const int height = std::max(desc.height, 1);
+        const int mips = std::max(desc.num_mipmaps, 1);
+        const int samples = std::max(desc.sample_count, 1);
+        int slices = std::max(desc.num_slices, 1);
+        if (desc.type == SG_IMAGETYPE_CUBE)
+            slices = 6;
+        size_t bytes = 0;
+        for (int mip = 0; mip < mips; mip++) {
+            const int w = std::max(width >> mip, 1);
+            const int h = std::max(height >> mip, 1);
+            const int d = desc.type == SG_IMAGETYPE_3D ? std::max(slices >> mip, 1) : slices;
+            bytes += (size_t)sg_query_surface_pitch(fmt, w, h, 1) * (size_t)d;
+        }
+        size_t total = bytes * (size_t)samples;
+        if (samples > 1 && resolve_copy)
+            total += bytes;
+        return total;
+    }
+
+    // Register a resource; tracking an id again replaces the previous entry
+    void track(const sg_buffer_desc& desc, sg_buffer buf) {
+        install_pending_hooks();
+        if (buf.id != SG_INVALID_ID)
+            add(buffers_, buf.id, classify(desc), buffer_bytes(desc), desc.label);
+    }
+    void track(const sg_image_desc& desc, sg_image img) {
+        install_pending_hooks();
+        if (img.id != SG_INVALID_ID)
+            add(images_, img.id, classify(desc), image_bytes(desc, resolve_copy_), desc.label);
+    }
+
+    void untrack(sg_buffer buf) {
+        install_pending_hooks();
+        remove(buffers_, buf.id);
+    }
+    void untrack(sg_image img) {
+        install_pending_hooks();
+        remove(images_, img.id);
+    }
+
+    // Drop entries whose resources were destroyed without going through the tracker
+    void sync() {
+        install_pending_hooks();
+        purge(buffers_, [](uint32_t id) { return sg_query_buffer_state({id}) == SG_RESOURCESTATE_INVALID; });
+        purge(images_, [](uint32_t id) { return sg_query_image_state({id}) == SG_RESOURCESTATE_INVALID; });
+    }
+
+    const totals& total() const { return total_; }
+    const totals& of(kind k) const { return kinds_[(int)k]; }
+    totals of(const char* label) const {
+        auto it = labels_.find(label_key(label));
+        return it != labels_.end() ? it->second.usage : totals{};
+    }
+    size_t buffer_bytes() const {
+        return kinds_[(int)kind::vertex_buffer].bytes + kinds_[(int)kind::index_buffer].bytes + kinds_[(int)kind::storage_buffer].bytes;
+    }
+    size_t image_bytes() const { return total_.bytes - buffer_bytes(); }
+
+    // Bytes of a single tracked resource, 0 if unknown
+    size_t bytes_of(sg_buffer buf) const {
+        auto it = buffers_.find(buf.id);
+        return it != buffers_.end() ? it->second.bytes : 0;
+    }
+    size_t bytes_of(sg_image img) const {
+        auto it = images_.find(img.id);
+        return it != images_.end() ? it->second.bytes : 0;
+    }
+
+    // Visit every label with its usage, largest first
+    template <typename F>
+    void for_each_label(F&& fn) const {
+        for (auto* l : sorted_labels())
+            fn(l->first.c_str(), l->second.usage);
+    }
+
+    // A budget of 0 disables it; warn_fraction is the share of the budget that triggers the first warning
+    void set_budget(size_t bytes, double warn_fraction = 0.9) {
+        total_budget_ = {bytes, warn_fraction, 0};
+        check("total", total_.bytes, total_budget_);
+    }
+    void set_budget(kind k, size_t bytes, double warn_fraction = 0.9) {
+        kind_budgets_[(int)k] = {bytes, warn_fraction, 0};
+        check(name(k), kinds_[(int)k].bytes, kind_budgets_[(int)k]);
+    }
+    void set_budget(const char* label, size_t bytes, double warn_fraction = 0.9) {
+        auto& l = labels_[label_key(label)];
+        l.limit = {bytes, warn_fraction, 0};
+        check(label_key(label).c_str(), l.usage.bytes, l.limit);
+    }
+    void on_warning(callback fn) { warn_fn_ = std::move(fn); }
+
+    void dump(FILE* out = stdout) {
+        sync();
+        fprintf(out, "gpu memory: %.2f MiB in %d resources (peak %.2f MiB)\n",
+                mib(total_.bytes), total_.count, mib(total_.peak_bytes));
+        for (int k = 0; k < num_kinds; k++) {
+            const totals& t = kinds_[k];
+            if (t.count || t.peak_bytes)
+                fprintf(out, "  %-26s %10.2f MiB %6d (peak %.2f MiB)\n", name((kind)k), mib(t.bytes), t.count, mib(t.peak_bytes));
+        }
+        fprintf(out, "  by label:\n");
+        for (auto* l : sorted_labels()) {
+            if (l->second.usage.count)
+                fprintf(out, "    %-40s %10.2f MiB %6d\n", l->first.c_str(), mib(l->second.usage.bytes), l->second.usage.count);
+        }
+    }
+
+private:
+    void on_make(const sg_buffer_desc& desc, sg_buffer buf) override { track(desc, buf); }
+    void on_make(const sg_image_desc& desc, sg_image img) override { track(desc, img); }
+    void on_destroy(sg_buffer buf) override { untrack(buf); }
+    void on_destroy(sg_image img) override { untrack(img); }
+
+    struct entry {
+        kind k;
+        size_t bytes;
+        std::string label;
+    };
+
+    struct budget {
+        size_t bytes = 0;
+        double warn_fraction = 0.9;
+        int level = 0;  // 0 below the warning, 1 warned, 2 exceeded
+    };
+
+    struct label_entry {
+        totals usage;
+        budget limit;
+    };
+
+    using entry_map = std::unordered_map<uint32_t, entry>;
+
+    static double mib(size_t bytes) { return (double)bytes / (1024.0 * 1024.0); }
+
+    static std::string label_key(const char* label) {
+        return label && label[0] ? label : "(unlabeled)";
+    }
+
+    static void grow(totals& t, size_t bytes) {
+        t.bytes += bytes;
+        t.count++;
+        t.peak_bytes = std::max(t.peak_bytes, t.bytes);
+    }
+
+    static void shrink(totals& t, size_t bytes) {
+        t.bytes -= bytes;
+        t.count--;
+    }
+
+    void add(entry_map& map, uint32_t id, kind k, size_t bytes, const char* label) {
+        remove(map, id);
+        entry& e = map[id];
+        e.k = k;
+        e.bytes = bytes;
+        e.label = label_key(label);
+        label_entry& l = labels_[e.label];
+        grow(total_, bytes);
+        grow(kinds_[(int)k], bytes);
+        grow(l.usage, bytes);
+        check("total", total_.bytes, total_budget_);
+        check(name(k), kinds_[(int)k].bytes, kind_budgets_[(int)k]);
+        check(e.label.c_str(), l.usage.bytes, l.limit);
+    }
+
+    void remove(entry_map& map, uint32_t id) {
+        auto it = map.find(id);
+        if (it == map.end())
+            return;
+        release(it->second);
+        map.erase(it);
+    }
+
+    void release(const entry& e) {
+        label_entry& l = labels_[e.label];
+        shrink(total_, e.bytes);
+        shrink(kinds_[(int)e.k], e.bytes);
+        shrink(l.usage, e.bytes);
+        check("total", total_.bytes, total_budget_);
+        check(name(e.k), kinds_[(int)e.k].bytes, kind_budgets_[(int)e.k]);
+        check(e.label.c_str(), l.usage.bytes, l.limit);
+    }
+
+    template <typename F>
+    void purge(entry_map& map, F&& destroyed) {
+        for (auto it = map.begin(); it != map.end();) {
+            if (destroyed(it->first)) {
+                release(it->second);
+                it = map.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Re-arms once usage falls back below the warning level
+    void check(const char* scope, size_t used, budget& b) {
+        if (!b.bytes)
+            return;
+        int level = used > b.bytes ? 2 : ((double)used >= (double)b.bytes * b.warn_fraction ? 1 : 0);
+        if (level > b.level && warn_fn_)
+            warn_fn_(scope, used, b.bytes, level == 2);
+        b.level = level;
+    }
+
+    std::vector<const std::pair<const std::string, label_entry>*> sorted_labels() const {
+        std::vector<const std::pair<const std::string, label_entry>*> sorted;
+        sorted.reserve(labels_.size());
+        for (auto& l : labels_)
+            sorted.push_back(&l);
+        std::sort(sorted.begin(), sorted.end(), [](auto* a, auto* b) { return a->second.usage.bytes > b->second.usage.bytes; });
+        return sorted;
+    }
+
+    bool resolve_copy_;
+    entry_map buffers_;
+    entry_map images_;
+    std::unordered_map<std::string, label_entry> labels_;
+    totals total_;
+    totals kinds_[num_kinds];
+    budget total_budget_;
+    budget kind_budgets_[num_kinds];
+    callback warn_fn_;
+};
+
+// One-time check of every pipeline against its shader at creation, for builds that run with
+// disable_validation(true) and so would otherwise draw garbage on a mismatch. Shaders and
+// pipelines made through the wrapper (the builders' build() and sg_type_traits) are picked up
+// while the checker is active; builds through the C API are picked up by track() and check(),
+// or automatically when sokol_gfx is built with SOKOL_TRACE_HOOKS, through the hooks shared
+// with memory_tracker. The most recently constructed live checker is the active one; checkers
+// may be destroyed in any order.
+class pipeline_checker : public helper::instance_list<pipeline_checker>, helper::pipeline_hooks {
+public:
+    // Called once per failing pipeline (and per failing pass layout from check_pass())
+    using callback = std::function<void(sg_pipeline pip, const char* label, const validation& v)>;
+
+    // reject: destroy pipelines that fail at creation, so draws using them are skipped by sokol_gfx
+    explicit pipeline_checker(bool reject = false) : reject_(reject) {
+        fail_fn_ = [](sg_pipeline pip, const char* label, const validation& v) {
+            fprintf(stderr, "sg::pipeline_checker: pipeline %u (%s): %s, slot %d\n",
+                    pip.id, label ? label : "unlabeled", v.message(), v.slot);
+        };
+        helper::pipeline_observer = this;
+#ifdef SOKOL_TRACE_HOOKS
+        helper::trace_dispatch::acquire();
+#endif
+    }
+    ~pipeline_checker() {
+        helper::pipeline_observer = next_active();
+#ifdef SOKOL_TRACE_HOOKS
+        helper::trace_dispatch::release();
+#endif
+    }
+
+    // Same as memory_tracker::install_pending_hooks(), from the wrapper paths, track() and check()
+    static void install_pending_hooks() {
+#ifdef SOKOL_TRACE_HOOKS
+        helper::trace_dispatch::install_pending();
+#endif
+    }
+
+    void on_fail(callback fn) { fail_fn_ = std::move(fn); }
+
+    // Remember a shader's interface; tracking an id again replaces it
+    void track(const sg_shader_desc& desc, sg_shader shd) {
+        install_pending_hooks();
+        if (shd.id != SG_INVALID_ID)
+            shaders_[shd.id] = shader_interface::from(desc);
+    }
+
+    void untrack(sg_shader shd) {
+        install_pending_hooks();
+        shaders_.erase(shd.id);
+    }
+    void untrack(sg_pipeline pip) {
+        install_pending_hooks();
+        pipelines_.erase(pip.id);
+    }
+
+    // Validate a new pipeline against its tracked shader; each pipeline id is checked once.
+    // Returns false on a mismatch, true when it passed or its shader is unknown
+    bool check(const sg_pipeline_desc& desc, sg_pipeline pip) {
+        install_pending_hooks();
+        if (pip.id == SG_INVALID_ID)
+            return true;
+        auto it = pipelines_.find(pip.id);
+        if (it != pipelines_.end())
+            return it->second.ok;
+        auto shd = shaders_.find(desc.shader.id);
+        if (shd == shaders_.end()) {
+            unchecked_++;
+            return true;
+        }
+        entry e;
+        e.layout = pipeline_layout::from(desc);
+        e.layout.resolve_defaults();
+        e.label = desc.label ? desc.label : "";
+        validation v = validate(shd->second, e.layout);
+        e.ok = (bool)v;
+        checked_++;
+        if (!v) {
+            fail(pip, e, v);
+            if (reject_)
+                sg_destroy_pipeline(pip);
+        }
+        // kept after a rejection too, so a second report of the same creation is ignored
+        pipelines_[pip.id] = std::move(e);
+        return (bool)v;
+    }
+
+    // Validate a pipeline against the pass it is applied in. Cheap enough to call before every
+    // sg_apply_pipeline(): the result is cached until the pass layout changes
+    bool check_pass(sg_pipeline pip, const pass_layout& pass) {
+        install_pending_hooks();
+        auto it = pipelines_.find(pip.id);
+        if (it == pipelines_.end())
+            return true;
+        entry& e = it->second;
+        if (e.pass_checked && e.last_pass == pass)
+            return e.pass_ok;
+        validation v = validate(e.layout, pass);
+        e.last_pass = pass;
+        e.pass_checked = true;
+        e.pass_ok = (bool)v;
+        if (!v)
+            fail(pip, e, v);
+        return e.pass_ok;
+    }
+
+    int checked() const { return checked_; }
+    int failed() const { return failed_; }
+    // Pipelines whose shader was created before the checker and never tracked
+    int unchecked() const { return unchecked_; }
+
+private:
+    void on_make(const sg_shader_desc& desc, sg_shader shd) override { track(desc, shd); }
+    void on_make(const sg_pipeline_desc& desc, sg_pipeline pip) override { check(desc, pip); }
+    void on_destroy(sg_shader shd) override { untrack(shd); }
+    void on_destroy(sg_pipeline pip) override { untrack(pip); }
+
+    struct entry {
+        pipeline_layout layout;
+        pass_layout last_pass;
+        std::string label;
+        bool ok = true;
+        bool pass_checked = false;
+        bool pass_ok = true;
+    };
+
+    void fail(sg_pipeline pip, const entry& e, const validation& v) {
+        failed_++;
+        if (fail_fn_)
+            fail_fn_(pip, e.label.empty() ? nullptr : e.label.c_str(), v);
+    }
+
+    bool reject_;
+    int checked_ = 0;
+    int failed_ = 0;
+    int unchecked_ = 0;
+    std::unordered_map<uint32_t, shader_interface> shaders_;
+    std::unordered_map<uint32_t, entry> pipelines_;
+    callback fail_fn_;
+};
+
+} // namespace sg
+#endif // SOKOL_NO_SG
@@ -0,0 +1,505 @@
+/* sokol_jobs.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+// sokol::job_system, a work-stealing job scheduler over sokol::chase_lev_deque. Not part of
+// the sokol.hpp umbrella
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sokol {
+// Chase-Lev work-stealing deque of pointers (Lê et al., "Correct and Efficient Work-Stealing
+// for Weak Memory Models"). The owning thread pushes and pops at the bottom, any thread may
+// steal from the top. Fixed capacity: push() fails when it is full.
+template <typename T>
+class chase_lev_deque {
+public:
+    explicit chase_lev_deque(size_t capacity = 4096) {
+        size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        items_ = std::unique_ptr<std::atomic<T*>[]>(new std::atomic<T*>[cap]);
+        mask_ = (int64_t)cap - 1;
+    }
+    chase_lev_deque(const chase_lev_deque&) = delete;
+    chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+    // Owner
+    bool push(T* item) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t > mask_)
+            return false;
+        items_[b & mask_].store(item, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner
+    T* pop() {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = items_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // last item, race the thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread; nullptr when empty or when another thief won
+    T* steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        T* item = items_[t & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return item;
+    }
+
+    bool empty() const { return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed); }
+
+private:
+    std::unique_ptr<std::atomic<T*>[]> items_;
+    int64_t mask_ = 0;
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+};
+
+// Work-stealing job scheduler. Each worker owns a chase_lev_deque; idle workers steal from
+// the others. The thread that calls start() (normally the main thread) is worker 0 and runs
+// jobs while it waits, so nothing blocks on a fiber switch: jobs track completion through
+// counters, wait() helps out until a counter drains, and then() attaches a continuation that
+// is queued by whichever job finishes last. Before start() and after stop() jobs run inline.
+class job_system {
+public:
+    struct config {
+        int num_threads = -1;      // worker threads besides the caller; negative = one per extra core
+        int queue_capacity = 4096; // jobs per worker deque and job pool
+    };
+
+    // Jobs in flight; a counter must outlive the jobs that reference it
+    class counter {
+    public:
+        counter() = default;
+        counter(const counter&) = delete;
+        counter& operator=(const counter&) = delete;
+        bool done() const {
+            return pending_.load(std::memory_order_acquire) == 0 && finishing_.load(std::memory_order_acquire) == 0;
+        }
+        // Only between uses, once done
+        void reset() {
+            pending_.store(0, std::memory_order_relaxed);
+            next_.store(nullptr, std::memory_order_relaxed);
+        }
+
+    private:
+        friend class job_system;
+        std::atomic<int> pending_{0};
+        std::atomic<int> finishing_{0};     // jobs still touching the counter after their decrement
+        std::atomic<void*> next_{nullptr};  // continuation job, or the fired marker
+    };
+
+    struct stats {
+        int workers = 0;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+        uint64_t inline_runs = 0;  // queue or pool full, or not started
+    };
+
+    job_system() : job_system(config()) {}
+    explicit job_system(const config& cfg) : cfg_(cfg) {
+        if (cfg_.num_threads < 0)
+            cfg_.num_threads = std::max((int)std::thread::hardware_concurrency(), 1) - 1;
+        cfg_.queue_capacity = std::max(cfg_.queue_capacity, 16);
+    }
+    job_system(const job_system&) = delete;
+    job_system& operator=(const job_system&) = delete;
+    ~job_system() {
+        stop();
+        if (instance() == this)
+            instance() = nullptr;
+    }
+
+    // Start the workers in init_cb and stop them in cleanup_cb, before the app's own callbacks;
+    // AppDesc is sapp::desc, a template so the core header does not depend on sokol_app.h
+    template <typename AppDesc>
+    AppDesc& install(AppDesc& d) {
+        const auto& c = d.get();
+        prev_init_cb_ = c.init_cb;
+        prev_init_userdata_cb_ = c.init_userdata_cb;
+        prev_cleanup_cb_ = c.cleanup_cb;
+        prev_cleanup_userdata_cb_ = c.cleanup_userdata_cb;
+        prev_user_data_ = c.user_data;
+        instance() = this;
+        d.init_cb([] {
+            if (job_system* js = instance()) {
+                js->start();
+                if (js->prev_init_cb_)
+                    js->prev_init_cb_();
+                else if (js->prev_init_userdata_cb_)
+                    js->prev_init_userdata_cb_(js->prev_user_data_);
+            }
+        });
+        d.cleanup_cb([] {
+            if (job_system* js = instance()) {
+                js->stop();
+                if (js->prev_cleanup_cb_)
+                    js->prev_cleanup_cb_();
+                else if (js->prev_cleanup_userdata_cb_)
+                    js->prev_cleanup_userdata_cb_(js->prev_user_data_);
+            }
+        });
+        return d;
+    }
+
+    // The calling thread becomes worker 0
+    void start() {
+        if (running_.load(std::memory_order_acquire))
+            return;
+        const int n = cfg_.num_threads + 1;
+        workers_.clear();
+        for (int i = 0; i < n; i++)
+            workers_.emplace_back(new worker((size_t)cfg_.queue_capacity));
+        bind_thread(0);
+        running_.store(true, std::memory_order_release);
+        for (int i = 1; i < n; i++)
+            workers_[(size_t)i]->thread = std::thread([this, i] { work(i); });
+    }
+
+    // Runs the remaining queued jobs, then joins the workers
+    void stop() {
+        if (!running_.load(std::memory_order_acquire))
+            return;
+        while (job* j = find_job(current_index()))
+            execute(j);
+        running_.store(false, std::memory_order_release);
+        wake_.notify_all();
+        for (auto& w : workers_)
+            if (w->thread.joinable())
+                w->thread.join();
+        bind_thread(-1);
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    int num_workers() const { return cfg_.num_threads + 1; }
+
+    // Queue fn() as a job, counted on c if given
+    template <typename F>
+    void run(F&& fn, counter* c = nullptr) {
+        if (c)
+            c->pending_.fetch_add(1, std::memory_order_relaxed);
+        job* j = make_job(std::forward<F>(fn), c);
+        if (j)
+            submit(j);
+    }
+
+    // Queue fn() once every job counted on c has finished (immediately if none are pending);
+    // one continuation per counter use
+    template <typename F>
+    void then(counter& c, F&& fn) {
+        // a continuation may only run inline when nothing can still be pending, i.e. before start()
+        job* j = make_job(std::forward<F>(fn), nullptr, false);
+        if (!j)
+            return;
+        void* expected = nullptr;
+        if (!c.next_.compare_exchange_strong(expected, j, std::memory_order_acq_rel)) {
+            // already fired (or a second continuation, which is not supported): run it now
+            submit(j);
+            return;
+        }
+        // nothing left to fire it: take it back unless a finishing job already did
+        if (c.done() && c.next_.exchange(fired(), std::memory_order_acq_rel) == j)
+            submit(j);
+    }
+
+    // Run jobs until every job counted on c has finished
+    void wait(counter& c) {
+        const int index = current_index();
+        while (!c.done()) {
+            if (job* j = find_job(index))
+                execute(j);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // fn(size_t begin, size_t end) over [begin, end) in chunks of at most grain, split
+    // recursively so thieves take large halves; returns when all chunks are done
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, const F& fn) {
+        counter c;
+        split(begin, end, std::max<size_t>(grain, 1), fn, c);
+        wait(c);
+    }
+
+    // Frame fence: jobs counted on frame() are all finished when end_frame() returns
+    counter& frame() { return frame_; }
+    void begin_frame() { frame_.reset(); }
+    void end_frame() { wait(frame_); }
+
+    stats query_stats() const {
+        stats s;
+        s.workers = num_workers();
+        for (auto& w : workers_) {
+            s.executed += w->executed.load(std::memory_order_relaxed);
+            s.stolen += w->stolen.load(std::memory_order_relaxed);
+        }
+        s.inline_runs = inline_runs_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    static constexpr size_t storage_size = 64;
+
+    struct job {
+        void (*invoke)(job*) = nullptr;  // runs and destroys the callable
+        counter* parent = nullptr;
+        std::atomic<bool> busy{false};
+        bool heap = false;
+        alignas(16) unsigned char storage[storage_size];
+    };
+
+    struct worker {
+        explicit worker(size_t capacity) : deque(capacity), pool(new job[capacity]), pool_size(capacity) {}
+        chase_lev_deque<job> deque;
+        std::unique_ptr<job[]> pool;  // reused round-robin by the owner
+        size_t pool_size;
+        size_t pool_next = 0;
+        uint32_t rng = 0x9e3779b9u;
+        std::thread thread;
+        alignas(64) std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+    };
+
+    static job_system*& instance() {
+        static job_system* js = nullptr;
+        return js;
+    }
+
+    static void* fired() {
+        static char marker;
+        return &marker;
+    }
+
+    // Which worker of which system the current thread is
+    static job_system*& thread_owner() {
+        static thread_local job_system* owner = nullptr;
+        return owner;
+    }
+    static int& thread_index() {
+        static thread_local int index = -1;
+        return index;
+    }
+    void bind_thread(int index) {
+        thread_owner() = index >= 0 ? this : nullptr;
+        thread_index() = index;
+    }
+    int current_index() const { return thread_owner() == this ? thread_index() : -1; }
+
+    template <typename F>
+    job* make_job(F&& fn, counter* c, bool allow_inline = true) {
+        using fn_type = typename std::decay<F>::type;
+        static_assert(sizeof(fn_type) <= storage_size, "job callable too large, capture by reference");
+        static_assert(alignof(fn_type) <= 16, "job callable over-aligned");
+        const int index = current_index();
+        job* j = nullptr;
+        if (running_.load(std::memory_order_acquire)) {
+            if (index >= 0) {
+                worker& w = *workers_[(size_t)index];
+                job& candidate = w.pool[w.pool_next];
+                if (!candidate.busy.load(std::memory_order_acquire)) {
+                    j = &candidate;
+                    w.pool_next = (w.pool_next + 1) % w.pool_size;
+                } else if (!allow_inline) {
+                    j = new job();
+                    j->heap = true;
+                }
+            } else {
+                j = new job();
+                j->heap = true;
+            }
+        }
+        if (!j) {
+            // not started, or pool exhausted for a plain job: run now
+            inline_runs_.fetch_add(1, std::memory_order_relaxed);
+            fn_type f(std::forward<F>(fn));
+            f();
+            finish(c);
+            return nullptr;
+        }
+        j->busy.store(true, std::memory_order_relaxed);
+        j->parent = c;
+        new (j->storage) fn_type(std::forward<F>(fn));
+        j->invoke = [](job* self) {
+            fn_type* f = reinterpret_cast<fn_type*>(self->storage);
+            (*f)();
+            f->~fn_type();
+        };
+        return j;
+    }
+
+    void submit(job* j) {
+        const int index = current_index();
+        if (index >= 0 && workers_[(size_t)index]->deque.push(j)) {
+            if (sleeping_.load(std::memory_order_relaxed) > 0)
+                wake_.notify_one();
+            return;
+        }
+        if (index < 0 && running_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            injected_.push_back(j);
+            has_injected_.store(true, std::memory_order_release);
+            wake_.notify_one();
+            return;
+        }
+        inline_runs_.fetch_add(1, std::memory_order_relaxed);
+        execute(j);
+    }
+
+    void execute(job* j) {
+        j->invoke(j);
+        counter* c = j->parent;
+        if (j->heap)
+            delete j;
+        else
+            j->busy.store(false, std::memory_order_release);
+        const int index = current_index();
+        if (index >= 0)
+            workers_[(size_t)index]->executed.fetch_add(1, std::memory_order_relaxed);
+        finish(c);
+    }
+
+    void finish(counter* c) {
+        if (!c)
+            return;
+        // keeps done() false, and the counter alive, until the continuation has been taken
+        c->finishing_.fetch_add(1, std::memory_order_acq_rel);
+        void* next = nullptr;
+        if (c->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            next = c->next_.exchange(fired(), std::memory_order_acq_rel);
+        c->finishing_.fetch_sub(1, std::memory_order_release);
+        if (next && next != fired())
+            submit(static_cast<job*>(next));
+    }
+
+    job* find_job(int index) {
+        if (index >= 0)
+            if (job* j = workers_[(size_t)index]->deque.pop())
+                return j;
+        if (has_injected_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!injected_.empty()) {
+                job* j = injected_.back();
+                injected_.pop_back();
+                has_injected_.store(!injected_.empty(), std::memory_order_release);
+                return j;
+            }
+        }
+        const size_t n = workers_.size();
+        if (n < 2 && index >= 0)
+            return nullptr;
+        // threads that are not workers each get their own xorshift state
+        static thread_local uint32_t external_rng = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1u;
+        uint32_t& rng = index >= 0 ? workers_[(size_t)index]->rng : external_rng;
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        for (size_t k = 0; k < n; k++) {
+            const size_t victim = (rng + k) % n;
+            if ((int)victim == index)
+                continue;
+            if (job* j = workers_[victim]->deque.steal()) {
+                if (index >= 0)
+                    workers_[(size_t)index]->stolen.fetch_add(1, std::memory_order_relaxed);
+                return j;
+            }
+        }
+        return nullptr;
+    }
+
+    void work(int index) {
+        bind_thread(index);
+        int idle = 0;
+        while (running_.load(std::memory_order_acquire)) {
+            if (job* j = find_job(index)) {
+                execute(j);
+                idle = 0;
+                continue;
+            }
+            if (++idle < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            // a timed wait so a wake-up racing with going to sleep costs at most 1 ms
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleeping_.fetch_add(1, std::memory_order_relaxed);
+            wake_.wait_for(lock, std::chrono::milliseconds(1));
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+        bind_thread(-1);
+    }
+
+    template <typename F>
+    void split(size_t begin, size_t end, size_t grain, const F& fn, counter& c) {
+        while (end - begin > grain) {
+            const size_t mid = begin + (end - begin) / 2;
+            run([this, mid, end, grain, &fn, &c] { split(mid, end, grain, fn, c); }, &c);
+            end = mid;
+        }
+        fn(begin, end);
+    }
+
+    config cfg_;
+    std::vector<std::unique_ptr<worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<int> sleeping_{0};
+    std::vector<job*> injected_;  // jobs queued from threads that are not workers
+    std::atomic<bool> has_injected_{false};
+    std::atomic<uint64_t> inline_runs_{0};
+    counter frame_;
+    void (*prev_init_cb_)() = nullptr;
+    void (*prev_init_userdata_cb_)(void*) = nullptr;
+    void (*prev_cleanup_cb_)() = nullptr;
+    void (*prev_cleanup_userdata_cb_)(void*) = nullptr;
+    void* prev_user_data_ = nullptr;
+};
+} // namespace sokol
@@ -0,0 +1,272 @@
+/* sokol_log.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include "sokol_core.hpp"
+
+// The C header must be included at global scope, sokol_log.inl is wrapped in a namespace
+#ifndef SOKOL_LOG_INCLUDED
+#if __has_include("sokol_log.h")
+#include "sokol_log.h"
+#elif __has_include("sokol/sokol_log.h")
+#include "sokol/sokol_log.h"
+#endif
+#endif
+
+namespace gen {
+#include "sokol_log.inl"
+}
+
+#ifndef SOKOL_NO_SLOG
+namespace slog {
+// Asynchronous drop-in replacement for slog_func. func() copies each log call
+// into a bounded lock-free multi-producer ring (no allocation, no locks, safe on
+// the audio thread) and a background thread formats and writes the entries,
+// collapsing runs of identical messages into a repeat count. Panics (level 0)
+// stop the writer thread once it has drained the ring and are then written
+// synchronously before aborting, like slog_func does.
+//
+//   slog::async_logger logger;
+//   sg_setup(&sg::desc().logger_func(slog::async_logger::func).logger_user_data(&logger));
+class async_logger {
+public:
+    using write_fn = void (*)(const char* text, void* user_data);
+
+    struct config {
+        size_t capacity = 1024;        // entries, rounded up to a power of two
+        write_fn write = nullptr;      // defaults to fputs into stderr
+        void* write_user_data = nullptr;
+        int poll_interval_ms = 5;      // how often the writer thread checks an empty ring
+    };
+
+    static constexpr size_t max_tag = 16;
+    static constexpr size_t max_message = 192;
+
+    async_logger() : async_logger(config()) {}
+    explicit async_logger(const config& cfg) : cfg_(cfg) {
+        size_t cap = 2;
+        while (cap < cfg.capacity)
+            cap <<= 1;
+        cells_ = std::unique_ptr<cell[]>(new cell[cap]);
+        mask_ = cap - 1;
+        for (size_t i = 0; i < cap; i++)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        if (!cfg_.write)
+            cfg_.write = [](const char* text, void*) { fputs(text, stderr); };
+        thread_ = std::thread([this] { run(); });
+    }
+    async_logger(const async_logger&) = delete;
+    async_logger& operator=(const async_logger&) = delete;
+    ~async_logger() { stop(); }
+
+    // sokol logger callback, pass the async_logger as user_data
+    static void func(const char* tag, uint32_t log_level, uint32_t log_item, const char* message,
+                     uint32_t line_nr, const char* filename, void* user_data) {
+        async_logger* self = (async_logger*)user_data;
+        if (log_level == 0 || !self) {
+            // panic: the caller expects the process to end. Concurrent panics are serialized,
+            // and the writer thread is joined first so cfg_.write is never entered twice
+            std::unique_lock<std::mutex> lock;
+            if (self) {
+                lock = std::unique_lock<std::mutex>(self->panic_mutex_);
+                self->stop();
+            }
+            char buf[max_message + 256];
+            format(buf, sizeof(buf), tag, log_level, log_item, message, line_nr, filename);
+            if (self)
+                self->cfg_.write(buf, self->cfg_.write_user_data);
+            else
+                fputs(buf, stderr);
+            if (log_level == 0)
+                abort();
+            return;
+        }
+        self->push(tag, log_level, log_item, message, line_nr, filename);
+    }
+
+    // Block until everything logged so far has been written
+    void flush() {
+        uint64_t target = enqueue_pos_.load(std::memory_order_acquire);
+        while (written_.load(std::memory_order_acquire) < target && running_.load(std::memory_order_acquire))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    struct entry {
+        char tag[max_tag];
+        char message[max_message];
+        const char* filename;
+        uint32_t level;
+        uint32_t item;
+        uint32_t line;
+    };
+
+    struct cell {
+        std::atomic<uint64_t> seq;
+        entry e;
+    };
+
+    static void copy(char* dst, const char* src, size_t size) {
+        size_t i = 0;
+        if (src)
+            for (; i + 1 < size && src[i]; i++)
+                dst[i] = src[i];
+        dst[i] = 0;
+    }
+
+    static const char* level_name(uint32_t level) {
+        switch (level) {
+            case 0: return "panic";
+            case 1: return "error";
+            case 2: return "warning";
+            default: return "info";
+        }
+    }
+
+    static int format(char* buf, size_t size, const char* tag, uint32_t level, uint32_t item,
+                      const char* message, uint32_t line, const char* filename) {
+        return snprintf(buf, size, "[%s][%s][id:%u] %s:%u:0:\n\t%s\n\n", tag ? tag : "", level_name(level), item,
+                        filename ? filename : "", line, message ? message : "");
+    }
+
+    // Let the writer thread drain the ring, then join it; a no-op on the writer thread itself
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id())
+            thread_.join();
+    }
+
+    // Bounded MPMC queue after Dmitry Vyukov, used with a single consumer
+    void push(const char* tag, uint32_t level, uint32_t item, const char* message, uint32_t line, const char* filename) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            uint64_t seq = c->seq.load(std::memory_order_acquire);
+            int64_t diff = (int64_t)seq - (int64_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        copy(c->e.tag, tag, max_tag);
+        copy(c->e.message, message, max_message);
+        c->e.filename = filename;
+        c->e.level = level;
+        c->e.item = item;
+        c->e.line = line;
+        c->seq.store(pos + 1, std::memory_order_release);
+    }
+
+    bool pop(entry& out) {
+        cell* c = &cells_[dequeue_pos_ & mask_];
+        uint64_t seq = c->seq.load(std::memory_order_acquire);
+        if ((int64_t)seq - (int64_t)(dequeue_pos_ + 1) < 0)
+            return false;
+        out = c->e;
+        c->seq.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        dequeue_pos_++;
+        return true;
+    }
+
+    static bool same(const entry& a, const entry& b) {
+        return a.level == b.level && a.item == b.item && a.line == b.line && a.filename == b.filename &&
+               !strcmp(a.tag, b.tag) && !strcmp(a.message, b.message);
+    }
+
+    void flush_repeats() {
+        if (repeats_ > 0) {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "[%s][%s][id:%u] previous message repeated %u times\n\n", last_.tag,
+                     level_name(last_.level), last_.item, repeats_);
+            cfg_.write(buf, cfg_.write_user_data);
+            repeats_ = 0;
+        }
+    }
+
+    void write(const entry& e) {
+        if (has_last_ && same(e, last_)) {
+            repeats_++;
+        } else {
+            flush_repeats();
+            char buf[max_message + 256];
+            format(buf, sizeof(buf), e.tag, e.level, e.item, e.message, e.line, e.filename);
+            cfg_.write(buf, cfg_.write_user_data);
+            last_ = e;
+            has_last_ = true;
+        }
+        written_.fetch_add(1, std::memory_order_release);
+    }
+
+    void run() {
+        entry e;
+        for (;;) {
+            bool any = false;
+            while (pop(e)) {
+                write(e);
+                any = true;
+            }
+            if (!any) {
+                // idle: report pending repeats and drops instead of holding them back indefinitely
+                flush_repeats();
+                uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+                if (dropped != reported_dropped_) {
+                    char buf[96];
+                    snprintf(buf, sizeof(buf), "[slog][warning] %llu log messages dropped, ring full\n\n",
+                             (unsigned long long)(dropped - reported_dropped_));
+                    cfg_.write(buf, cfg_.write_user_data);
+                    reported_dropped_ = dropped;
+                }
+                if (!running_.load(std::memory_order_acquire))
+                    break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(cfg_.poll_interval_ms));
+            }
+        }
+    }
+
+    config cfg_;
+    std::unique_ptr<cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(64) uint64_t dequeue_pos_ = 0;
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> running_{true};
+    entry last_ = {};
+    bool has_last_ = false;
+    uint32_t repeats_ = 0;
+    uint64_t reported_dropped_ = 0;
+    std::mutex panic_mutex_;
+    std::thread thread_;
+};
+} // namespace slog
+#endif // SOKOL_NO_SLOG
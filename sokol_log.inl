@@ -0,0 +1,24 @@
+// Machine generated C++ wrapper for Sokol library.
+// https://github.com/takeiteasy/sokol.hpp
+//
+// Do not edit manually; regenerate using generate.py.
+
+#pragma once
+#include <utility>
+#include <memory>
+
+#ifndef SOKOL_LOG_INCLUDED
+#if __has_include("sokol_log.h")
+#include "sokol_log.h"
+#elif __has_include("sokol/sokol_log.h")
+#include "sokol/sokol_log.h"
+#else
+#warning "Cannot find sokol_log.h, disabling!"
+#define SOKOL_NO_SLOG
+#endif
+#endif
+
+#ifndef SOKOL_NO_SLOG
+namespace slog {
+} // namespace slog
+#endif // SOKOL_NO_SLOG
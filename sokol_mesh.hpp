@@ -0,0 +1,985 @@
+/* sokol_mesh.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+// Load/bake-time mesh processing for sokol_gfx. Not part of the sokol.hpp umbrella, so
+// translation units that only render do not pay for it
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "sokol_gfx.hpp"
+#include "sokol_simd.hpp"
+
+#ifndef SOKOL_NO_SG
+namespace sg {
+namespace mesh {
+// Post-transform cache efficiency of a triangle list under a FIFO cache of cache_size vertices.
+// acmr: transformed vertices per triangle (0.5 is the best a regular grid can reach, 3 the worst);
+// atvr: transformed vertices per referenced vertex (1 is optimal)
+struct cache_stats {
+    size_t transformed = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+inline cache_stats analyze_vertex_cache(const uint32_t* indices, size_t index_count, size_t vertex_count, int cache_size = 16) {
+    cache_stats s;
+    if (index_count < 3)
+        return s;
+    // a vertex is cached while fewer than cache_size misses happened since it was loaded
+    std::vector<uint32_t> loaded(vertex_count, 0);
+    std::vector<bool> seen(vertex_count, false);
+    uint32_t time = (uint32_t)cache_size + 1;
+    size_t unique = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        uint32_t v = indices[i];
+        if (time - loaded[v] > (uint32_t)cache_size) {
+            loaded[v] = time++;
+            s.transformed++;
+        }
+        if (!seen[v]) {
+            seen[v] = true;
+            unique++;
+        }
+    }
+    s.acmr = (float)s.transformed / (float)(index_count / 3);
+    s.atvr = unique ? (float)s.transformed / (float)unique : 0.0f;
+    return s;
+}
+
+// Bytes pulled through a small FIFO cache of 64-byte lines, relative to the vertex buffer size
+// (1 means every byte is read exactly once)
+inline float analyze_vertex_fetch(const uint32_t* indices, size_t index_count, size_t vertex_count, size_t stride,
+                                  int cache_lines = 64) {
+    const size_t line = 64;
+    const size_t buffer_bytes = vertex_count * stride;
+    if (!buffer_bytes)
+        return 0.0f;
+    std::vector<uint32_t> loaded((buffer_bytes + line - 1) / line, 0);
+    uint32_t time = (uint32_t)cache_lines + 1;
+    size_t fetched = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        size_t begin = indices[i] * stride / line;
+        size_t end = (indices[i] * stride + stride - 1) / line;
+        for (size_t l = begin; l <= end; l++) {
+            if (time - loaded[l] > (uint32_t)cache_lines) {
+                loaded[l] = time++;
+                fetched += line;
+            }
+        }
+    }
+    return (float)fetched / (float)buffer_bytes;
+}
+
+// Map bitwise-identical vertices onto one, in order of first reference; unreferenced vertices
+// map to ~0u. Without indices the vertices are a plain triangle list. Returns the unique count
+inline size_t generate_remap(uint32_t* remap, const uint32_t* indices, size_t index_count,
+                             const void* vertices, size_t vertex_count, size_t stride) {
+    const uint8_t* data = (const uint8_t*)vertices;
+    std::fill(remap, remap + vertex_count, ~0u);
+    size_t capacity = 16;
+    while (capacity < vertex_count * 2)
+        capacity *= 2;
+    std::vector<uint32_t> table(capacity, ~0u);
+    size_t unique = 0;
+    const size_t count = indices ? index_count : vertex_count;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t v = indices ? indices[i] : (uint32_t)i;
+        if (remap[v] != ~0u)
+            continue;
+        const uint8_t* bytes = data + v * stride;
+        uint64_t h = 14695981039346656037ull;
+        for (size_t b = 0; b < stride; b++)
+            h = (h ^ bytes[b]) * 1099511628211ull;
+        size_t slot = (size_t)(h ^ (h >> 32)) & (capacity - 1);
+        for (;;) {
+            uint32_t other = table[slot];
+            if (other == ~0u) {
+                table[slot] = v;
+                remap[v] = (uint32_t)unique++;
+                break;
+            }
+            if (!memcmp(data + other * stride, bytes, stride)) {
+                remap[v] = remap[other];
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+    }
+    return unique;
+}
+
+// Tipsify (Sander, Nehab and Barczak 2007): fans around the most recently used vertex that is
+// still going to be in the cache, in linear time. dst may not alias indices
+inline void optimize_vertex_cache_tipsify(uint32_t* dst, const uint32_t* indices, size_t index_count,
+                                          size_t vertex_count, int cache_size = 16) {
+    const size_t tri_count = index_count / 3;
+    // triangles adjacent to each vertex, one entry per corner
+    std::vector<uint32_t> offsets(vertex_count + 1, 0);
+    for (size_t i = 0; i < tri_count * 3; i++)
+        offsets[indices[i] + 1]++;
+    for (size_t v = 0; v < vertex_count; v++)
+        offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> adjacency(tri_count * 3);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < tri_count * 3; i++)
+        adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+    std::vector<uint32_t> live(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++)
+        live[v] = offsets[v + 1] - offsets[v];
+
+    std::vector<uint32_t> loaded(vertex_count, 0);
+    std::vector<bool> emitted(tri_count, false);
+    std::vector<uint32_t> dead_end;
+    std::vector<uint32_t> candidates;
+    uint32_t time = (uint32_t)cache_size + 1;
+    size_t cursor = 0;
+    size_t out = 0;
+    int64_t fan = tri_count ? indices[0] : -1;
+    while (fan >= 0) {
+        candidates.clear();
+        for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; a++) {
+            uint32_t t = adjacency[a];
+            if (emitted[t])
+                continue;
+            emitted[t] = true;
+            for (int c = 0; c < 3; c++) {
+                uint32_t v = indices[t * 3 + c];
+                dst[out++] = v;
+                dead_end.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - loaded[v] > (uint32_t)cache_size)
+                    loaded[v] = time++;
+            }
+        }
+        // prefer the candidate that stays in the cache longest while its fan is emitted
+        fan = -1;
+        int64_t best_priority = -1;
+        for (uint32_t v : candidates) {
+            if (!live[v])
+                continue;
+            int64_t priority = 0;
+            if ((int64_t)(time - loaded[v]) + 2 * (int64_t)live[v] <= cache_size)
+                priority = time - loaded[v];
+            if (priority > best_priority) {
+                best_priority = priority;
+                fan = v;
+            }
+        }
+        if (fan >= 0)
+            continue;
+        while (!dead_end.empty()) {
+            uint32_t v = dead_end.back();
+            dead_end.pop_back();
+            if (live[v]) {
+                fan = v;
+                break;
+            }
+        }
+        while (fan < 0 && cursor < vertex_count) {
+            if (live[cursor])
+                fan = (int64_t)cursor;
+            cursor++;
+        }
+    }
+}
+
+// Forsyth's linear-speed vertex cache optimization: greedily emits the best scoring triangle
+// around an LRU cache of cache_size vertices. About twice as slow as Tipsify; models LRU rather
+// than FIFO hardware, so prefer it when targeting GPUs with a larger LRU-like vertex reuse window
+inline void optimize_vertex_cache_forsyth(uint32_t* dst, const uint32_t* indices, size_t index_count,
+                                          size_t vertex_count, int cache_size = 32) {
+    const size_t tri_count = index_count / 3;
+    const int max_valence = 32;
+    cache_size = std::max(cache_size, 4);
+    // score tables: position in the LRU cache, and remaining valence
+    std::vector<float> cache_score(cache_size + 1, 0.0f);
+    for (int p = 0; p < cache_size; p++)
+        cache_score[p] = p < 3 ? 0.75f : std::pow(1.0f - (float)(p - 3) / (float)(cache_size - 3), 1.5f);
+    float valence_score[max_valence + 1];
+    valence_score[0] = 0.0f;
+    for (int l = 1; l <= max_valence; l++)
+        valence_score[l] = 2.0f / std::sqrt((float)l);
+
+    std::vector<uint32_t> offsets(vertex_count + 1, 0);
+    for (size_t i = 0; i < tri_count * 3; i++)
+        offsets[indices[i] + 1]++;
+    for (size_t v = 0; v < vertex_count; v++)
+        offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> adjacency(tri_count * 3);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < tri_count * 3; i++)
+        adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+    // live triangles are kept at the front of each vertex's adjacency range
+    std::vector<uint32_t> live(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++)
+        live[v] = offsets[v + 1] - offsets[v];
+
+    std::vector<int> position(vertex_count, -1);
+    auto vertex_score = [&](uint32_t v) {
+        if (!live[v])
+            return -1.0f;
+        int p = position[v];
+        return (p >= 0 ? cache_score[p] : 0.0f) + valence_score[std::min<uint32_t>(live[v], max_valence)];
+    };
+    std::vector<float> score(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++)
+        score[v] = vertex_score((uint32_t)v);
+    std::vector<float> tri_score(tri_count);
+    std::vector<bool> emitted(tri_count, false);
+    for (size_t t = 0; t < tri_count; t++)
+        tri_score[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+
+    std::vector<uint32_t> cache, next_cache;
+    cache.reserve(cache_size + 3);
+    next_cache.reserve(cache_size + 3);
+    size_t cursor = 0;
+    size_t out = 0;
+    int64_t best = -1;
+    float best_score = -1.0f;
+    for (size_t t = 0; t < tri_count; t++) {
+        if (tri_score[t] > best_score) {
+            best_score = tri_score[t];
+            best = (int64_t)t;
+        }
+    }
+    while (best >= 0) {
+        const uint32_t* tri = &indices[best * 3];
+        emitted[best] = true;
+        next_cache.clear();
+        for (int c = 0; c < 3; c++) {
+            uint32_t v = tri[c];
+            dst[out++] = v;
+            if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end())
+                next_cache.push_back(v);
+            // drop the triangle from the vertex's live range
+            uint32_t* adj = &adjacency[offsets[v]];
+            for (uint32_t a = 0; a < live[v]; a++) {
+                if (adj[a] == (uint32_t)best) {
+                    std::swap(adj[a], adj[live[v] - 1]);
+                    live[v]--;
+                    break;
+                }
+            }
+        }
+        for (uint32_t v : cache)
+            if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end())
+                next_cache.push_back(v);
+        // vertices pushed out of the cache lose their cache score
+        for (size_t i = (size_t)cache_size; i < next_cache.size(); i++) {
+            uint32_t v = next_cache[i];
+            position[v] = -1;
+            score[v] = vertex_score(v);
+        }
+        if (next_cache.size() > (size_t)cache_size)
+            next_cache.resize(cache_size);
+        cache.swap(next_cache);
+
+        best = -1;
+        best_score = -1.0f;
+        for (size_t i = 0; i < cache.size(); i++) {
+            uint32_t v = cache[i];
+            position[v] = (int)i;
+            score[v] = vertex_score(v);
+        }
+        for (uint32_t v : cache) {
+            for (uint32_t a = 0; a < live[v]; a++) {
+                uint32_t t = adjacency[offsets[v] + a];
+                float s = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                tri_score[t] = s;
+                if (s > best_score) {
+                    best_score = s;
+                    best = t;
+                }
+            }
+        }
+        // the cache ran dry, continue with the next triangle not emitted yet
+        while (best < 0 && cursor < tri_count) {
+            if (!emitted[cursor])
+                best = (int64_t)cursor;
+            cursor++;
+        }
+    }
+}
+
+// Reorders clusters of a cache-optimized triangle list so outward-facing clusters come first and
+// occlude the rest (Sander et al. 2007). Clusters start where the cache flushed, and are split
+// further while their ACMR stays within threshold of the hard cluster's, so the ACMR rises by at
+// most about that factor. positions: float3 at position_offset in each vertex. dst may not alias
+// indices
+inline void optimize_overdraw(uint32_t* dst, const uint32_t* indices, size_t index_count, const void* vertices,
+                              size_t vertex_count, size_t stride, size_t position_offset = 0,
+                              float threshold = 1.05f, int cache_size = 16) {
+    const size_t tri_count = index_count / 3;
+    if (!tri_count)
+        return;
+    const uint8_t* data = (const uint8_t*)vertices;
+    auto position = [&](uint32_t v) {
+        float p[3];
+        memcpy(p, data + v * stride + position_offset, sizeof(p));
+        return std::array<float, 3>{p[0], p[1], p[2]};
+    };
+
+    // misses per triangle when the whole list runs through the cache, and with resets per cluster
+    std::vector<uint32_t> loaded(vertex_count, 0);
+    uint32_t time = (uint32_t)cache_size + 1;
+    auto misses = [&](size_t t) {
+        int m = 0;
+        for (int c = 0; c < 3; c++) {
+            uint32_t v = indices[t * 3 + c];
+            if (time - loaded[v] > (uint32_t)cache_size) {
+                loaded[v] = time++;
+                m++;
+            }
+        }
+        return m;
+    };
+    auto reset = [&] { time += (uint32_t)cache_size + 1; };
+
+    std::vector<size_t> hard;
+    for (size_t t = 0; t < tri_count; t++)
+        if (misses(t) == 3)
+            hard.push_back(t);
+    if (hard.empty() || hard[0] != 0)
+        hard.insert(hard.begin(), 0);
+    hard.push_back(tri_count);
+
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hard.size(); h++) {
+        const size_t begin = hard[h], end = hard[h + 1];
+        reset();
+        int cluster_misses = 0;
+        for (size_t t = begin; t < end; t++)
+            cluster_misses += misses(t);
+        const float cluster_threshold = threshold * (float)cluster_misses / (float)(end - begin);
+        reset();
+        clusters.push_back(begin);
+        int running_misses = 0, running_tris = 0;
+        for (size_t t = begin; t < end; t++) {
+            running_misses += misses(t);
+            running_tris++;
+            if (t + 1 < end && (float)running_misses / (float)running_tris <= cluster_threshold) {
+                clusters.push_back(t + 1);
+                running_misses = running_tris = 0;
+                reset();
+            }
+        }
+    }
+    clusters.push_back(tri_count);
+
+    // sort key: how far the cluster sits out along its own average normal
+    float mesh_center[3] = {0, 0, 0};
+    double mesh_area = 0.0;
+    struct cluster_key {
+        size_t begin, end;
+        float center[3], normal[3], area;
+        float key;
+    };
+    std::vector<cluster_key> keys(clusters.size() - 1);
+    for (size_t c = 0; c + 1 < clusters.size(); c++) {
+        cluster_key& k = keys[c];
+        k = {clusters[c], clusters[c + 1], {0, 0, 0}, {0, 0, 0}, 0.0f, 0.0f};
+        for (size_t t = k.begin; t < k.end; t++) {
+            auto a = position(indices[t * 3]), b = position(indices[t * 3 + 1]), d = position(indices[t * 3 + 2]);
+            float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            float e2[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+            float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int i = 0; i < 3; i++) {
+                float centroid = (a[i] + b[i] + d[i]) / 3.0f;
+                k.center[i] += centroid * area;
+                k.normal[i] += n[i];
+                mesh_center[i] += centroid * area;
+            }
+            k.area += area;
+        }
+        mesh_area += k.area;
+        if (k.area > 0.0f)
+            for (int i = 0; i < 3; i++)
+                k.center[i] /= k.area;
+    }
+    if (mesh_area > 0.0)
+        for (int i = 0; i < 3; i++)
+            mesh_center[i] /= (float)mesh_area;
+    for (cluster_key& k : keys) {
+        float len = std::sqrt(k.normal[0] * k.normal[0] + k.normal[1] * k.normal[1] + k.normal[2] * k.normal[2]);
+        k.key = 0.0f;
+        if (len > 0.0f)
+            for (int i = 0; i < 3; i++)
+                k.key += (k.center[i] - mesh_center[i]) * k.normal[i] / len;
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const cluster_key& a, const cluster_key& b) { return a.key > b.key; });
+    size_t out = 0;
+    for (const cluster_key& k : keys)
+        for (size_t i = k.begin * 3; i < k.end * 3; i++)
+            dst[out++] = indices[i];
+}
+
+// Reorders vertices by first use and rewrites indices in place; unreferenced vertices are
+// dropped. Returns the number of vertices written to dst
+inline size_t optimize_vertex_fetch(void* dst, uint32_t* indices, size_t index_count, const void* vertices,
+                                    size_t vertex_count, size_t stride) {
+    std::vector<uint32_t> remap(vertex_count, ~0u);
+    uint8_t* out = (uint8_t*)dst;
+    const uint8_t* data = (const uint8_t*)vertices;
+    size_t next = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        uint32_t& r = remap[indices[i]];
+        if (r == ~0u) {
+            memcpy(out + next * stride, data + indices[i] * stride, stride);
+            r = (uint32_t)next++;
+        }
+        indices[i] = r;
+    }
+    return next;
+}
+
+enum class cache_algorithm { none, tipsify, forsyth };
+
+struct options {
+    bool deduplicate = true;
+    cache_algorithm cache = cache_algorithm::tipsify;
+    int cache_size = 16;
+    // float3 position used to order clusters for overdraw; a negative offset skips the pass
+    int position_offset = 0;
+    float overdraw_threshold = 1.05f;
+    bool optimize_fetch = true;
+    // pick SG_INDEXTYPE_UINT16 whenever every index fits
+    bool allow_16bit = true;
+};
+
+struct stats {
+    size_t vertices_in = 0;
+    size_t vertices_out = 0;
+    size_t triangles = 0;
+    cache_stats cache_before;
+    cache_stats cache_after;
+    float overfetch_before = 0.0f;
+    float overfetch_after = 0.0f;
+    size_t bytes_in = 0;
+    size_t bytes_out = 0;
+    double milliseconds = 0.0;
+
+    size_t bytes_saved() const { return bytes_in > bytes_out ? bytes_in - bytes_out : 0; }
+
+    void print(FILE* out = stdout) const {
+        fprintf(out, "mesh: %zu triangles, %zu -> %zu vertices, %.1f ms\n", triangles, vertices_in, vertices_out, milliseconds);
+        fprintf(out, "  acmr %.3f -> %.3f, atvr %.3f -> %.3f, overfetch %.2f -> %.2f\n", cache_before.acmr,
+                cache_after.acmr, cache_before.atvr, cache_after.atvr, overfetch_before, overfetch_after);
+        fprintf(out, "  %zu -> %zu bytes, %zu saved\n", bytes_in, bytes_out, bytes_saved());
+    }
+};
+
+// Optimized vertex and index data, ready to be uploaded
+struct data {
+    std::vector<uint8_t> vertices;
+    std::vector<uint8_t> indices;
+    size_t stride = 0;
+    size_t vertex_count = 0;
+    size_t index_count = 0;
+    sg_index_type index_type = SG_INDEXTYPE_UINT32;
+    mesh::stats stats;
+
+    uint32_t index(size_t i) const {
+        if (index_type == SG_INDEXTYPE_UINT16) {
+            uint16_t v;
+            memcpy(&v, &indices[i * 2], 2);
+            return v;
+        }
+        uint32_t v;
+        memcpy(&v, &indices[i * 4], 4);
+        return v;
+    }
+
+    // The descs point into this object, which must outlive the build
+    buffer_desc vertex_buffer_desc() const { return buffer_desc::make_vertex_with_data(vertices.data(), vertices.size()); }
+    buffer_desc index_buffer_desc() const { return buffer_desc::make_index_with_data(indices.data(), indices.size()); }
+};
+
+// Deduplicate, reorder for the post-transform cache, order clusters against overdraw, reorder
+// vertices for fetch locality and narrow the indices. Input is a triangle list; without indices
+// every three vertices are a triangle
+inline data optimize(const void* vertices, size_t vertex_count, size_t stride, const uint32_t* indices,
+                     size_t index_count, const options& opt = options()) {
+    auto start = std::chrono::steady_clock::now();
+    data m;
+    m.stride = stride;
+    m.stats.vertices_in = vertex_count;
+    m.stats.bytes_in = vertex_count * stride + (indices ? index_count * sizeof(uint32_t) : 0);
+
+    std::vector<uint32_t> ib;
+    if (indices)
+        ib.assign(indices, indices + index_count - index_count % 3);
+    else
+        for (uint32_t i = 0; i < (uint32_t)(vertex_count - vertex_count % 3); i++)
+            ib.push_back(i);
+    m.stats.triangles = ib.size() / 3;
+    m.stats.cache_before = analyze_vertex_cache(ib.data(), ib.size(), vertex_count, opt.cache_size);
+    m.stats.overfetch_before = analyze_vertex_fetch(ib.data(), ib.size(), vertex_count, stride);
+
+    std::vector<uint8_t> vb;
+    size_t count = vertex_count;
+    const uint8_t* src = (const uint8_t*)vertices;
+    if (opt.deduplicate) {
+        std::vector<uint32_t> remap(vertex_count);
+        count = generate_remap(remap.data(), ib.data(), ib.size(), vertices, vertex_count, stride);
+        vb.resize(count * stride);
+        for (size_t v = 0; v < vertex_count; v++)
+            if (remap[v] != ~0u)
+                memcpy(&vb[remap[v] * stride], src + v * stride, stride);
+        for (uint32_t& i : ib)
+            i = remap[i];
+    } else {
+        vb.assign(src, src + vertex_count * stride);
+    }
+
+    std::vector<uint32_t> tmp(ib.size());
+    if (opt.cache != cache_algorithm::none && !ib.empty()) {
+        if (opt.cache == cache_algorithm::forsyth)
+            optimize_vertex_cache_forsyth(tmp.data(), ib.data(), ib.size(), count, opt.cache_size);
+        else
+            optimize_vertex_cache_tipsify(tmp.data(), ib.data(), ib.size(), count, opt.cache_size);
+        ib.swap(tmp);
+    }
+    if (opt.position_offset >= 0 && opt.overdraw_threshold > 0.0f && !ib.empty() &&
+        (size_t)opt.position_offset + 3 * sizeof(float) <= stride) {
+        optimize_overdraw(tmp.data(), ib.data(), ib.size(), vb.data(), count, stride, (size_t)opt.position_offset,
+                          opt.overdraw_threshold, opt.cache_size);
+        ib.swap(tmp);
+    }
+    if (opt.optimize_fetch) {
+        std::vector<uint8_t> fetch(count * stride);
+        count = optimize_vertex_fetch(fetch.data(), ib.data(), ib.size(), vb.data(), count, stride);
+        fetch.resize(count * stride);
+        vb.swap(fetch);
+    }
+
+    m.vertices.swap(vb);
+    m.vertex_count = count;
+    m.index_count = ib.size();
+    m.index_type = opt.allow_16bit && count <= 0xFFFF ? SG_INDEXTYPE_UINT16 : SG_INDEXTYPE_UINT32;
+    if (m.index_type == SG_INDEXTYPE_UINT16) {
+        m.indices.resize(ib.size() * 2);
+        for (size_t i = 0; i < ib.size(); i++) {
+            uint16_t v = (uint16_t)ib[i];
+            memcpy(&m.indices[i * 2], &v, 2);
+        }
+    } else {
+        m.indices.resize(ib.size() * 4);
+        memcpy(m.indices.data(), ib.data(), m.indices.size());
+    }
+
+    m.stats.vertices_out = count;
+    m.stats.cache_after = analyze_vertex_cache(ib.data(), ib.size(), count, opt.cache_size);
+    m.stats.overfetch_after = analyze_vertex_fetch(ib.data(), ib.size(), count, stride);
+    m.stats.bytes_out = m.vertices.size() + m.indices.size();
+    m.stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return m;
+}
+
+// IEEE 754 half precision conversions, rounding to nearest even; values beyond the half range
+// become infinity
+inline uint16_t float_to_half(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    const uint32_t sign = x & 0x80000000u;
+    x ^= sign;
+    uint32_t h;
+    if (x >= (127u + 16u) << 23) {
+        h = x > 0x7F800000u ? 0x7E00u : 0x7C00u;
+    } else if (x < 113u << 23) {
+        // denormal: let the float adder do the rounding
+        const uint32_t magic_bits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        float v, magic;
+        memcpy(&v, &x, sizeof(v));
+        memcpy(&magic, &magic_bits, sizeof(magic));
+        v += magic;
+        memcpy(&h, &v, sizeof(h));
+        h -= magic_bits;
+    } else {
+        const uint32_t odd = (x >> 13) & 1u;
+        x += ((uint32_t)(15 - 127) << 23) + 0xFFFu + odd;
+        h = x >> 13;
+    }
+    return (uint16_t)(h | (sign >> 16));
+}
+
+inline float half_to_float(uint16_t h) {
+    const uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1Fu, mantissa = h & 0x3FFu;
+    if (!exponent) {
+        const float v = std::ldexp((float)mantissa, -24);
+        return sign ? -v : v;
+    }
+    const uint32_t bits = sign | (exponent == 31 ? 0x7F800000u : (exponent + 112u) << 23) | (mantissa << 13);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// One float attribute of the source vertex and the format it is packed into. The normalized
+// formats (and halves) store the per-mesh bounds remapped onto [-1, 1] or [0, 1] when
+// use_bounds is set, otherwise values are clamped to that range. Components the format has but
+// the source lacks decode to fill, so a vec4 position attribute still gets w = 1.
+// Supported: FLOAT..FLOAT4, HALF2/HALF4, SHORT2N/SHORT4N, USHORT2N/USHORT4N, BYTE4N, UBYTE4N and
+// UINT10_N2; integer formats are stored as floats instead
+struct attribute {
+    int location = 0;
+    size_t offset = 0;
+    int components = 3;
+    sg_vertex_format format = SG_VERTEXFORMAT_FLOAT3;
+    bool use_bounds = true;
+    float fill = 1.0f;
+
+    static attribute make(int location, size_t offset, int components, sg_vertex_format format, bool use_bounds = true) {
+        attribute a;
+        a.location = location;
+        a.offset = offset;
+        a.components = components;
+        a.format = format;
+        a.use_bounds = use_bounds;
+        return a;
+    }
+};
+
+// decoded = stored * scale + bias, per component
+struct dequant {
+    float scale[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float bias[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+struct packed_attribute {
+    int location = 0;
+    sg_vertex_format format = SG_VERTEXFORMAT_INVALID;
+    int offset = 0;
+    int components = 0;
+    mesh::dequant dequant;
+    float min[4] = {};
+    float max[4] = {};
+    // in source units, over the stored components
+    float max_error = 0.0f;
+    float rms_error = 0.0f;
+};
+
+namespace helper {
+enum class encoding { float32, half, snorm, unorm, unorm10_2 };
+
+struct packing {
+    encoding enc;
+    int lanes;
+    int lane_bytes;
+};
+
+inline packing packing_of(sg_vertex_format fmt, int components) {
+    switch (fmt) {
+    case SG_VERTEXFORMAT_FLOAT: return {encoding::float32, 1, 4};
+    case SG_VERTEXFORMAT_FLOAT2: return {encoding::float32, 2, 4};
+    case SG_VERTEXFORMAT_FLOAT3: return {encoding::float32, 3, 4};
+    case SG_VERTEXFORMAT_FLOAT4: return {encoding::float32, 4, 4};
+    case SG_VERTEXFORMAT_HALF2: return {encoding::half, 2, 2};
+    case SG_VERTEXFORMAT_HALF4: return {encoding::half, 4, 2};
+    case SG_VERTEXFORMAT_SHORT2N: return {encoding::snorm, 2, 2};
+    case SG_VERTEXFORMAT_SHORT4N: return {encoding::snorm, 4, 2};
+    case SG_VERTEXFORMAT_USHORT2N: return {encoding::unorm, 2, 2};
+    case SG_VERTEXFORMAT_USHORT4N: return {encoding::unorm, 4, 2};
+    case SG_VERTEXFORMAT_BYTE4N: return {encoding::snorm, 4, 1};
+    case SG_VERTEXFORMAT_UBYTE4N: return {encoding::unorm, 4, 1};
+    case SG_VERTEXFORMAT_UINT10_N2: return {encoding::unorm10_2, 4, 0};
+    default: return {encoding::float32, components, 4};
+    }
+}
+
+inline sg_vertex_format float_format(int components) {
+    const sg_vertex_format formats[4] = {SG_VERTEXFORMAT_FLOAT, SG_VERTEXFORMAT_FLOAT2, SG_VERTEXFORMAT_FLOAT3, SG_VERTEXFORMAT_FLOAT4};
+    return formats[components - 1];
+}
+
+// N source floats at p, zero padded. Built from scalars below 4, a vector load of the padded
+// copy would stall on store forwarding
+template <int N>
+inline sokol::simd::f32x4 load_components(const uint8_t* p) {
+    float f[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    memcpy(f, p, N * sizeof(float));
+    return N == 4 ? sokol::simd::load(f) : sokol::simd::set(f[0], f[1], f[2], f[3]);
+}
+
+// Grows min/max by count vertices
+template <int N>
+inline void bounds(const uint8_t* src, size_t stride, size_t count, float* min, float* max) {
+    namespace simd = sokol::simd;
+    simd::f32x4 lo = simd::load(min), hi = simd::load(max);
+    for (size_t v = 0; v < count; v++, src += stride) {
+        const simd::f32x4 x = load_components<N>(src);
+        lo = simd::min(lo, x);
+        hi = simd::max(hi, x);
+    }
+    simd::store(min, lo);
+    simd::store(max, hi);
+}
+
+inline void bounds(int components, const uint8_t* src, size_t stride, size_t count, float* min, float* max) {
+    switch (components) {
+    case 1: return bounds<1>(src, stride, count, min, max);
+    case 2: return bounds<2>(src, stride, count, min, max);
+    case 3: return bounds<3>(src, stride, count, min, max);
+    default: return bounds<4>(src, stride, count, min, max);
+    }
+}
+
+// Encode constants of one attribute: n = clamp((x - bias) * inv, lo, hi) is stored as
+// round(n * step) (or as is for floats and halves) and decoded as n * scale + out_bias
+struct kernel {
+    sokol::simd::f32x4 bias, inv, lo, hi, step, inv_step, scale, out_bias, lanes;
+    int out_lanes;
+    int lane_bytes;
+};
+
+// Encodes count vertices; grows max_error and sum_sq by the decode error of the stored components
+template <encoding E, int N>
+inline void encode(const kernel& k, const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                   size_t count, float& max_error, double& sum_sq) {
+    namespace simd = sokol::simd;
+    simd::f32x4 err_max = simd::splat(0.0f), err_sum = simd::splat(0.0f);
+    for (size_t v = 0; v < count; v++, src += src_stride, dst += dst_stride) {
+        const simd::f32x4 x = load_components<N>(src);
+        const simd::f32x4 n = simd::min(simd::max((x - k.bias) * k.inv, k.lo), k.hi);
+        simd::f32x4 back;
+        if (E == encoding::float32) {
+            float f[4];
+            simd::store(f, n);
+            memcpy(dst, f, (size_t)k.out_lanes * sizeof(float));
+            back = n;
+        } else if (E == encoding::half) {
+            float f[4];
+            uint16_t h[4];
+            simd::store(f, n);
+            for (int c = 0; c < 4; c++) {
+                h[c] = float_to_half(f[c]);
+                f[c] = half_to_float(h[c]);
+            }
+            memcpy(dst, h, (size_t)k.out_lanes * sizeof(uint16_t));
+            back = simd::load(f);
+        } else {
+            int32_t q[4];
+            simd::store_rounded(q, n * k.step);
+            if (E == encoding::unorm10_2) {
+                const uint32_t packed = (uint32_t)q[0] | ((uint32_t)q[1] << 10) | ((uint32_t)q[2] << 20) | ((uint32_t)q[3] << 30);
+                memcpy(dst, &packed, sizeof(packed));
+            } else if (k.lane_bytes == 2) {
+                const uint16_t s[4] = {(uint16_t)q[0], (uint16_t)q[1], (uint16_t)q[2], (uint16_t)q[3]};
+                memcpy(dst, s, (size_t)k.out_lanes * sizeof(uint16_t));
+            } else {
+                const uint8_t b[4] = {(uint8_t)q[0], (uint8_t)q[1], (uint8_t)q[2], (uint8_t)q[3]};
+                memcpy(dst, b, 4);
+            }
+            back = simd::set((float)q[0], (float)q[1], (float)q[2], (float)q[3]) * k.inv_step;
+        }
+        const simd::f32x4 d = (back * k.scale + k.out_bias - x) * k.lanes;
+        err_max = simd::max(err_max, simd::max(d, simd::splat(0.0f) - d));
+        err_sum = err_sum + d * d;
+        // keep the float accumulator short
+        if ((v & 4095) == 4095) {
+            sum_sq += simd::hsum(err_sum);
+            err_sum = simd::splat(0.0f);
+        }
+    }
+    sum_sq += simd::hsum(err_sum);
+    float e[4];
+    simd::store(e, err_max);
+    max_error = std::max(max_error, std::max(std::max(e[0], e[1]), std::max(e[2], e[3])));
+}
+
+inline void encode(int components, encoding e, const kernel& k, const uint8_t* src, size_t src_stride, uint8_t* dst,
+                   size_t dst_stride, size_t count, float& max_error, double& sum_sq) {
+    switch (components * 8 + (int)e) {
+#define SOKOL_MESH_ENCODE(N, E) \
+    case N * 8 + (int)encoding::E: return encode<encoding::E, N>(k, src, src_stride, dst, dst_stride, count, max_error, sum_sq);
+#define SOKOL_MESH_ENCODE_N(N) \
+    SOKOL_MESH_ENCODE(N, float32) SOKOL_MESH_ENCODE(N, half) SOKOL_MESH_ENCODE(N, snorm) SOKOL_MESH_ENCODE(N, unorm) SOKOL_MESH_ENCODE(N, unorm10_2)
+    SOKOL_MESH_ENCODE_N(1)
+    SOKOL_MESH_ENCODE_N(2)
+    SOKOL_MESH_ENCODE_N(3)
+    SOKOL_MESH_ENCODE_N(4)
+#undef SOKOL_MESH_ENCODE_N
+#undef SOKOL_MESH_ENCODE
+    }
+}
+} // namespace helper
+
+// Quantized vertex data with the layout and dequantization constants the shader needs
+struct quantized {
+    std::vector<uint8_t> vertices;
+    size_t stride = 0;
+    size_t vertex_count = 0;
+    std::vector<packed_attribute> attributes;
+    size_t bytes_in = 0;
+    double milliseconds = 0.0;
+
+    size_t bytes_out() const { return vertices.size(); }
+    size_t bytes_saved() const { return bytes_in > bytes_out() ? bytes_in - bytes_out() : 0; }
+
+    // Vertex layout of every attribute, reading from buffer slot buffer_index
+    void apply(sg_pipeline_desc& desc, int buffer_index = 0) const {
+        for (const packed_attribute& a : attributes) {
+            desc.layout.attrs[a.location].format = a.format;
+            desc.layout.attrs[a.location].offset = a.offset;
+            desc.layout.attrs[a.location].buffer_index = buffer_index;
+        }
+        desc.layout.buffers[buffer_index].stride = (int)stride;
+    }
+
+    // Same, for compile-time style checks with sg::validate
+    pipeline_layout& layout(pipeline_layout& p, int buffer_index = 0) const {
+        for (const packed_attribute& a : attributes)
+            p.attr(a.location, a.format, buffer_index, a.offset);
+        return p.buffer(buffer_index, (int)stride);
+    }
+
+    // Uniform data: a scale and a bias vec4 per attribute, in attribute order, e.g. for
+    // `uniform vec4 dequant[2 * N]` decode with `a * dequant[2 * i] + dequant[2 * i + 1]`
+    size_t uniform_size() const { return attributes.size() * sizeof(mesh::dequant); }
+    void write_uniforms(void* dst) const {
+        uint8_t* out = (uint8_t*)dst;
+        for (const packed_attribute& a : attributes) {
+            memcpy(out, &a.dequant, sizeof(mesh::dequant));
+            out += sizeof(mesh::dequant);
+        }
+    }
+
+    // The desc points into this object, which must outlive the build
+    buffer_desc vertex_buffer_desc() const { return buffer_desc::make_vertex_with_data(vertices.data(), vertices.size()); }
+
+    void print(FILE* out = stdout) const {
+        fprintf(out, "quantize: %zu vertices, stride %zu, %.1f ms\n", vertex_count, stride, milliseconds);
+        for (const packed_attribute& a : attributes)
+            fprintf(out, "  attr %d: format %d at %d, max error %g, rms error %g\n", a.location, (int)a.format, a.offset,
+                    a.max_error, a.rms_error);
+        fprintf(out, "  %zu -> %zu bytes, %zu saved\n", bytes_in, bytes_out(), bytes_saved());
+    }
+};
+
+// Pack float attributes into the formats requested, interleaved in the order given
+inline quantized quantize(const void* vertices, size_t vertex_count, size_t stride, const std::vector<attribute>& attrs) {
+    namespace simd = sokol::simd;
+    auto start = std::chrono::steady_clock::now();
+    const uint8_t* src = (const uint8_t*)vertices;
+    // vertices are processed in blocks small enough that every attribute of a block is read
+    // from the cache after the first
+    const size_t block = 4096;
+    quantized q;
+    q.vertex_count = vertex_count;
+    q.bytes_in = vertex_count * stride;
+    std::vector<int> stored(attrs.size());
+    for (size_t i = 0; i < attrs.size(); i++) {
+        packed_attribute a;
+        a.location = attrs[i].location;
+        a.components = std::min(std::max(attrs[i].components, 1), 4);
+        a.format = attrs[i].format;
+        if (helper::packing_of(a.format, a.components).lane_bytes == 4)
+            a.format = helper::float_format(a.components);
+        a.offset = (int)q.stride;
+        stored[i] = std::min(a.components, helper::packing_of(a.format, a.components).lanes);
+        std::fill(a.min, a.min + 4, vertex_count ? FLT_MAX : 0.0f);
+        std::fill(a.max, a.max + 4, vertex_count ? -FLT_MAX : 0.0f);
+        q.stride += sg::helper::vertex_format_bytes(a.format);
+        q.attributes.push_back(a);
+    }
+    q.vertices.resize(q.stride * vertex_count);
+
+    // per-mesh bounds
+    for (size_t b = 0; b < vertex_count; b += block) {
+        const size_t count = std::min(block, vertex_count - b);
+        for (size_t i = 0; i < attrs.size(); i++)
+            helper::bounds(stored[i], src + b * stride + attrs[i].offset, stride, count, q.attributes[i].min, q.attributes[i].max);
+    }
+
+    // encode: n = clamp((x - bias) * inv, range), decode: x = n * scale + bias
+    std::vector<helper::kernel> kernels(attrs.size());
+    for (size_t i = 0; i < attrs.size(); i++) {
+        const attribute& in = attrs[i];
+        packed_attribute& a = q.attributes[i];
+        const helper::packing pk = helper::packing_of(a.format, a.components);
+        const bool is_signed = pk.enc == helper::encoding::snorm || pk.enc == helper::encoding::half;
+        const bool remap = in.use_bounds && vertex_count && pk.enc != helper::encoding::float32;
+        float enc_bias[4] = {}, enc_inv[4] = {}, mask[4] = {}, steps[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        for (int c = 0; c < 4; c++) {
+            if (c >= stored[i]) {
+                a.dequant.scale[c] = 0.0f;
+                a.dequant.bias[c] = in.fill;
+                continue;
+            }
+            mask[c] = 1.0f;
+            enc_inv[c] = 1.0f;
+            if (remap) {
+                const float extent = is_signed ? (a.max[c] - a.min[c]) * 0.5f : a.max[c] - a.min[c];
+                a.dequant.scale[c] = extent;
+                a.dequant.bias[c] = is_signed ? (a.max[c] + a.min[c]) * 0.5f : a.min[c];
+                enc_bias[c] = a.dequant.bias[c];
+                enc_inv[c] = extent > 0.0f ? 1.0f / extent : 0.0f;
+            }
+        }
+        if (pk.enc == helper::encoding::snorm || pk.enc == helper::encoding::unorm)
+            for (int c = 0; c < 4; c++)
+                steps[c] = pk.enc == helper::encoding::snorm ? (float)((1 << (pk.lane_bytes * 8 - 1)) - 1) : (float)((1 << (pk.lane_bytes * 8)) - 1);
+        if (pk.enc == helper::encoding::unorm10_2)
+            steps[0] = steps[1] = steps[2] = 1023.0f, steps[3] = 3.0f;
+        float range_lo = is_signed ? -1.0f : 0.0f, range_hi = 1.0f;
+        if (pk.enc == helper::encoding::float32 || (pk.enc == helper::encoding::half && !remap))
+            range_lo = -FLT_MAX, range_hi = FLT_MAX;
+
+        helper::kernel& k = kernels[i];
+        k.bias = simd::load(enc_bias);
+        k.inv = simd::load(enc_inv);
+        k.lo = simd::splat(range_lo);
+        k.hi = simd::splat(range_hi);
+        k.step = simd::load(steps);
+        k.inv_step = simd::set(1.0f / steps[0], 1.0f / steps[1], 1.0f / steps[2], 1.0f / steps[3]);
+        k.scale = simd::load(a.dequant.scale);
+        k.out_bias = simd::load(a.dequant.bias);
+        k.lanes = simd::load(mask);
+        k.out_lanes = pk.lanes;
+        k.lane_bytes = pk.lane_bytes;
+    }
+    std::vector<double> sum_sq(attrs.size(), 0.0);
+    for (size_t b = 0; b < vertex_count; b += block) {
+        const size_t count = std::min(block, vertex_count - b);
+        for (size_t i = 0; i < attrs.size(); i++) {
+            packed_attribute& a = q.attributes[i];
+            helper::encode(stored[i], helper::packing_of(a.format, a.components).enc, kernels[i], src + b * stride + attrs[i].offset,
+                           stride, q.vertices.data() + b * q.stride + a.offset, q.stride, count, a.max_error, sum_sq[i]);
+        }
+    }
+    for (size_t i = 0; i < attrs.size(); i++)
+        if (vertex_count)
+            q.attributes[i].rms_error = (float)std::sqrt(sum_sq[i] / (double)(vertex_count * stored[i]));
+    q.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return q;
+}
+
+// Quantize the vertices of an optimized mesh; its index data stays valid
+inline quantized quantize(const data& m, const std::vector<attribute>& attrs) {
+    return quantize(m.vertices.data(), m.vertex_count, m.stride, attrs);
+}
+} // namespace mesh
+} // namespace sg
+#endif // SOKOL_NO_SG
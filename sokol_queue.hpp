@@ -0,0 +1,105 @@
+/* sokol_queue.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+// Wait-free handoff between two threads: sokol::spsc_queue for streams of values and
+// sokol::triple_buffer for the latest value only
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace sokol {
+// Bounded wait-free single-producer/single-consumer queue of trivially copyable values
+template <typename T>
+class spsc_queue {
+public:
+    explicit spsc_queue(size_t capacity = 1024) {
+        size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        items_ = std::unique_ptr<T[]>(new T[cap]);
+        mask_ = cap - 1;
+    }
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    bool push(const T& item) {
+        const uint64_t w = write_.load(std::memory_order_relaxed);
+        if (w - read_.load(std::memory_order_acquire) > mask_)
+            return false;
+        items_[w & mask_] = item;
+        write_.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const uint64_t r = read_.load(std::memory_order_relaxed);
+        if (r == write_.load(std::memory_order_acquire))
+            return false;
+        item = items_[r & mask_];
+        read_.store(r + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact on the producer side, a lower bound on the consumer side
+    size_t free_space() const { return mask_ + 1 - (size_t)(write_.load(std::memory_order_relaxed) - read_.load(std::memory_order_acquire)); }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::unique_ptr<T[]> items_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> write_{0};
+    alignas(64) std::atomic<uint64_t> read_{0};
+};
+
+// Wait-free triple buffer handing the latest value from one producer thread to one consumer
+// thread. The producer fills write_buffer() and publishes it; the consumer's update() swaps in
+// the newest published value, if any. Neither side ever waits and intermediate values the
+// consumer was too slow to see are skipped.
+template <typename T>
+class triple_buffer {
+public:
+    triple_buffer() = default;
+    triple_buffer(const triple_buffer&) = delete;
+    triple_buffer& operator=(const triple_buffer&) = delete;
+
+    // Producer
+    T& write_buffer() { return slots_[back_].value; }
+    void publish() { back_ = middle_.exchange((uint8_t)(back_ | fresh), std::memory_order_acq_rel) & 3; }
+
+    // Consumer: true if a newer value was published since the last update()
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & fresh))
+            return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & 3;
+        return true;
+    }
+    const T& read_buffer() const { return slots_[front_].value; }
+    T& read_buffer() { return slots_[front_].value; }
+
+private:
+    static constexpr uint8_t fresh = 4;
+    struct alignas(64) slot {
+        T value{};
+    };
+    slot slots_[3];
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) uint8_t back_ = 0;  // producer
+    alignas(64) uint8_t front_ = 2; // consumer
+};
+} // namespace sokol
@@ -0,0 +1,114 @@
+/* sokol_simd.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+// SSE2/NEON detection and sokol::simd, the 4-wide float vector the audio mixers and the mesh
+// quantizer are written against. Define SOKOL_NO_SIMD to force the scalar fallback
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#if !defined(SOKOL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SOKOL_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#elif !defined(SOKOL_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define SOKOL_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace sokol {
+// Minimal 4-wide float vector over SSE2/NEON with a scalar fallback (define SOKOL_NO_SIMD to force it)
+namespace simd {
+struct f32x4 {
+#if defined(SOKOL_SIMD_SSE2)
+    __m128 v;
+#elif defined(SOKOL_SIMD_NEON)
+    float32x4_t v;
+#else
+    float v[4];
+#endif
+};
+
+#if defined(SOKOL_SIMD_SSE2)
+inline f32x4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, f32x4 a) { _mm_storeu_ps(p, a.v); }
+inline f32x4 splat(float x) { return {_mm_set1_ps(x)}; }
+inline f32x4 set(float a, float b, float c, float d) { return {_mm_setr_ps(a, b, c, d)}; }
+inline f32x4 operator+(f32x4 a, f32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline f32x4 operator-(f32x4 a, f32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline f32x4 operator*(f32x4 a, f32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline f32x4 zip_lo(f32x4 a, f32x4 b) { return {_mm_unpacklo_ps(a.v, b.v)}; }
+inline f32x4 zip_hi(f32x4 a, f32x4 b) { return {_mm_unpackhi_ps(a.v, b.v)}; }
+inline float hsum(f32x4 a) {
+    __m128 s = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+}
+inline f32x4 min(f32x4 a, f32x4 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline f32x4 max(f32x4 a, f32x4 b) { return {_mm_max_ps(a.v, b.v)}; }
+// Round to nearest (even) and store as int32
+inline void store_rounded(int32_t* p, f32x4 a) { _mm_storeu_si128((__m128i*)p, _mm_cvtps_epi32(a.v)); }
+#elif defined(SOKOL_SIMD_NEON)
+inline f32x4 load(const float* p) { return {vld1q_f32(p)}; }
+inline void store(float* p, f32x4 a) { vst1q_f32(p, a.v); }
+inline f32x4 splat(float x) { return {vdupq_n_f32(x)}; }
+inline f32x4 set(float a, float b, float c, float d) {
+    const float f[4] = {a, b, c, d};
+    return {vld1q_f32(f)};
+}
+inline f32x4 operator+(f32x4 a, f32x4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline f32x4 operator-(f32x4 a, f32x4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline f32x4 operator*(f32x4 a, f32x4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline f32x4 zip_lo(f32x4 a, f32x4 b) { return {vzipq_f32(a.v, b.v).val[0]}; }
+inline f32x4 zip_hi(f32x4 a, f32x4 b) { return {vzipq_f32(a.v, b.v).val[1]}; }
+inline float hsum(f32x4 a) {
+    float32x2_t s = vadd_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+inline f32x4 min(f32x4 a, f32x4 b) { return {vminq_f32(a.v, b.v)}; }
+inline f32x4 max(f32x4 a, f32x4 b) { return {vmaxq_f32(a.v, b.v)}; }
+#if defined(__aarch64__) || defined(_M_ARM64)
+inline void store_rounded(int32_t* p, f32x4 a) { vst1q_s32(p, vcvtnq_s32_f32(a.v)); }
+#else
+// ARMv7 only truncates, round half away from zero instead
+inline void store_rounded(int32_t* p, f32x4 a) {
+    float32x4_t half = vbslq_f32(vdupq_n_u32(0x80000000u), a.v, vdupq_n_f32(0.5f));
+    vst1q_s32(p, vcvtq_s32_f32(vaddq_f32(a.v, half)));
+}
+#endif
+#else
+inline f32x4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, f32x4 a) { memcpy(p, a.v, sizeof(a.v)); }
+inline f32x4 splat(float x) { return {{x, x, x, x}}; }
+inline f32x4 set(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+inline f32x4 operator+(f32x4 a, f32x4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline f32x4 operator-(f32x4 a, f32x4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline f32x4 operator*(f32x4 a, f32x4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline f32x4 zip_lo(f32x4 a, f32x4 b) { return {{a.v[0], b.v[0], a.v[1], b.v[1]}}; }
+inline f32x4 zip_hi(f32x4 a, f32x4 b) { return {{a.v[2], b.v[2], a.v[3], b.v[3]}}; }
+inline float hsum(f32x4 a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+inline f32x4 min(f32x4 a, f32x4 b) { return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}}; }
+inline f32x4 max(f32x4 a, f32x4 b) { return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}}; }
+inline void store_rounded(int32_t* p, f32x4 a) {
+    for (int i = 0; i < 4; i++)
+        p[i] = (int32_t)std::nearbyint(a.v[i]);
+}
+#endif
+} // namespace simd
+} // namespace sokol
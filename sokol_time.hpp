@@ -0,0 +1,619 @@
+/* sokol_time.hpp -- https://github.com/takeiteasy/sokol.hpp
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sokol_core.hpp"
+
+// The C header must be included at global scope, sokol_time.inl is wrapped in a namespace
+#ifndef SOKOL_TIME_INCLUDED
+#if __has_include("sokol_time.h")
+#include "sokol_time.h"
+#elif __has_include("sokol/sokol_time.h")
+#include "sokol/sokol_time.h"
+#endif
+#endif
+
+namespace gen {
+#include "sokol_time.inl"
+}
+
+#ifndef SOKOL_NO_STM
+namespace stm {
+// Hierarchical CPU scope profiler. Scopes are recorded into a lock-free ring per
+// thread and drained once per frame by end_frame(), which rebuilds the scope tree
+// and, while a capture is running, keeps the events for Chrome trace export.
+// Scope names must outlive the profiler (string literals) and each thread that
+// records a scope keeps its ring for the profiler's lifetime. Compile with
+// SOKOL_NO_PROFILER to remove STM_PROFILE_SCOPE entirely.
+class profiler {
+    struct ring;
+
+public:
+    struct event {
+        const char* name;
+        uint64_t begin;
+        uint64_t end;
+        uint32_t depth;
+        uint32_t thread;
+    };
+
+    // One node per distinct call path in a frame, children linked as siblings
+    struct node {
+        const char* name = nullptr;
+        int parent = -1;
+        int first_child = -1;
+        int next_sibling = -1;
+        uint32_t thread = 0;
+        uint32_t calls = 0;
+        uint64_t total_ticks = 0;
+        uint64_t self_ticks = 0;
+    };
+
+    struct frame {
+        uint64_t index = 0;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        std::vector<node> nodes;  // roots have parent == -1
+        uint64_t dropped = 0;     // events lost to full rings this frame
+    };
+
+    // RAII scope marker
+    class scope {
+    public:
+        explicit scope(const char* name) {
+            if (profiler::enabled()) {
+                name_ = name;
+                ring_ = &profiler::get().local_ring();
+                depth_ = ring_->depth++;
+                begin_ = stm_now();
+            }
+        }
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+        ~scope() {
+            if (ring_) {
+                ring_->push({name_, begin_, stm_now(), depth_, ring_->thread});
+                ring_->depth--;
+            }
+        }
+
+    private:
+        const char* name_ = nullptr;
+        ring* ring_ = nullptr;
+        uint64_t begin_ = 0;
+        uint32_t depth_ = 0;
+    };
+
+    static profiler& get() {
+        static profiler instance;
+        return instance;
+    }
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    // Capacity of rings created from now on, rounded up to a power of two
+    void set_ring_capacity(size_t events) {
+        size_t cap = 64;
+        while (cap < events)
+            cap <<= 1;
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        ring_capacity_ = cap;
+    }
+
+    // Drain all thread rings and rebuild the scope tree for the frame that just ended
+    const frame& end_frame() {
+        uint64_t now = stm_now();
+        events_.clear();
+        uint64_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            // events of threads that exited since the last frame
+            events_.swap(retired_);
+            dropped = retired_dropped_;
+            retired_dropped_ = 0;
+            for (auto& r : rings_) {
+                r->drain(events_);
+                dropped += r->dropped.exchange(0, std::memory_order_relaxed);
+            }
+        }
+        last_.index = frame_index_++;
+        last_.begin = frame_begin_;
+        last_.end = now;
+        last_.dropped = dropped;
+        frame_begin_ = now;
+        build_tree(events_, last_.nodes);
+        if (capturing_)
+            capture_.insert(capture_.end(), events_.begin(), events_.end());
+        return last_;
+    }
+
+    const frame& last_frame() const { return last_; }
+
+    // Keep drained events until end_capture(), for export with write_chrome_trace()
+    void begin_capture() {
+        capture_.clear();
+        capturing_ = true;
+    }
+    void end_capture() { capturing_ = false; }
+    bool capturing() const { return capturing_; }
+    const std::vector<event>& captured() const { return capture_; }
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto) of the captured events
+    void write_chrome_trace(FILE* out) const {
+        fprintf(out, "{\"traceEvents\":[\n");
+        for (size_t i = 0; i < capture_.size(); i++) {
+            const event& e = capture_[i];
+            fputs("{\"name\":\"", out);
+            write_escaped(out, e.name);
+            fprintf(out, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                    e.thread, stm_us(e.begin), stm_us(stm_diff(e.end, e.begin)),
+                    i + 1 < capture_.size() ? "," : "");
+        }
+        fprintf(out, "],\"displayTimeUnit\":\"ms\"}\n");
+    }
+
+    bool write_chrome_trace(const char* path) const {
+        FILE* out = fopen(path, "w");
+        if (!out)
+            return false;
+        write_chrome_trace(out);
+        fclose(out);
+        return true;
+    }
+
+    // Indented per-frame tree, one line per node
+    void print_frame(const frame& f, FILE* out = stdout) const {
+        fprintf(out, "frame %llu: %.3f ms\n", (unsigned long long)f.index, stm_ms(stm_diff(f.end, f.begin)));
+        for (size_t i = 0; i < f.nodes.size(); i++)
+            if (f.nodes[i].parent < 0)
+                print_node(f, (int)i, 1, out);
+    }
+
+private:
+    // Single-producer (owning thread) single-consumer (end_frame) event ring
+    struct ring {
+        explicit ring(size_t capacity, uint32_t thread_index) : events(capacity), mask(capacity - 1), thread(thread_index) {}
+
+        void push(const event& e) {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) >= events.size()) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            events[h & mask] = e;
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        void drain(std::vector<event>& out) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            size_t h = head.load(std::memory_order_acquire);
+            for (; t != h; t++)
+                out.push_back(events[t & mask]);
+            tail.store(t, std::memory_order_release);
+        }
+
+        std::vector<event> events;
+        size_t mask;
+        uint32_t thread;     // reassigned when the ring is reused by another thread
+        uint32_t depth = 0;  // only touched by the owning thread
+        std::atomic<size_t> head{0};
+        std::atomic<size_t> tail{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    profiler() : frame_begin_(stm_now()) {}
+
+    // Returns the calling thread's ring to the free list when the thread exits
+    struct ring_holder {
+        ring* r = nullptr;
+        ~ring_holder() {
+            if (r)
+                profiler::get().release_ring(r);
+        }
+    };
+
+    ring& local_ring() {
+        thread_local ring_holder local;
+        if (!local.r)
+            local.r = acquire_ring();
+        return *local.r;
+    }
+
+    ring* acquire_ring() {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        ring* r = nullptr;
+        for (size_t i = 0; i < free_rings_.size(); i++)
+            if (free_rings_[i]->events.size() == ring_capacity_) {
+                r = free_rings_[i];
+                free_rings_.erase(free_rings_.begin() + (ptrdiff_t)i);
+                break;
+            }
+        if (!r) {
+            rings_.push_back(std::make_unique<ring>(ring_capacity_, 0));
+            r = rings_.back().get();
+        }
+        r->thread = next_thread_++;
+        return r;
+    }
+
+    // Keep the exiting thread's events for the next end_frame() and park the ring for reuse
+    void release_ring(ring* r) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        r->drain(retired_);
+        retired_dropped_ += r->dropped.exchange(0, std::memory_order_relaxed);
+        r->depth = 0;
+        free_rings_.push_back(r);
+    }
+
+    static int find_child(std::vector<node>& nodes, int parent, int& first_root, const char* name, uint32_t thread) {
+        int first = parent >= 0 ? nodes[parent].first_child : first_root;
+        for (int i = first; i >= 0; i = nodes[i].next_sibling)
+            if (nodes[i].thread == thread && (nodes[i].name == name || !strcmp(nodes[i].name, name)))
+                return i;
+        node n;
+        n.name = name;
+        n.parent = parent;
+        n.thread = thread;
+        n.next_sibling = first;
+        nodes.push_back(n);
+        int index = (int)nodes.size() - 1;
+        if (parent >= 0)
+            nodes[parent].first_child = index;
+        else
+            first_root = index;
+        return index;
+    }
+
+    static void build_tree(std::vector<event>& events, std::vector<node>& nodes) {
+        nodes.clear();
+        // a parent begins no later than its children and has a smaller depth
+        std::sort(events.begin(), events.end(), [](const event& a, const event& b) {
+            if (a.thread != b.thread)
+                return a.thread < b.thread;
+            if (a.begin != b.begin)
+                return a.begin < b.begin;
+            return a.depth < b.depth;
+        });
+        struct open_scope {
+            int node;
+            uint32_t depth;
+        };
+        std::vector<open_scope> stack;
+        int first_root = -1;
+        uint32_t thread = UINT32_MAX;
+        for (const event& e : events) {
+            if (e.thread != thread) {
+                thread = e.thread;
+                stack.clear();
+            }
+            while (!stack.empty() && stack.back().depth >= e.depth)
+                stack.pop_back();
+            // scopes whose parent opened in an earlier frame become roots
+            int parent = stack.empty() ? -1 : stack.back().node;
+            int n = find_child(nodes, parent, first_root, e.name, e.thread);
+            uint64_t ticks = stm_diff(e.end, e.begin);
+            nodes[n].calls++;
+            nodes[n].total_ticks += ticks;
+            nodes[n].self_ticks += ticks;
+            if (parent >= 0)
+                nodes[parent].self_ticks -= std::min(nodes[parent].self_ticks, ticks);
+            stack.push_back({n, e.depth});
+        }
+    }
+
+    static void print_node(const frame& f, int index, int indent, FILE* out) {
+        const node& n = f.nodes[index];
+        fprintf(out, "%*s%s [t%u] %.3f ms (self %.3f ms, %u calls)\n", indent * 2, "", n.name, n.thread,
+                stm_ms(n.total_ticks), stm_ms(n.self_ticks), n.calls);
+        for (int c = n.first_child; c >= 0; c = f.nodes[c].next_sibling)
+            print_node(f, c, indent + 1, out);
+    }
+
+    static void write_escaped(FILE* out, const char* str) {
+        for (; *str; str++) {
+            if (*str == '"' || *str == '\\')
+                fputc('\\', out);
+            if ((unsigned char)*str >= 0x20)
+                fputc(*str, out);
+        }
+    }
+
+    static inline std::atomic<bool> enabled_{true};
+    std::mutex rings_mutex_;
+    std::vector<std::unique_ptr<ring>> rings_;
+    // guarded by rings_mutex_
+    std::vector<ring*> free_rings_;
+    std::vector<event> retired_;
+    uint64_t retired_dropped_ = 0;
+    uint32_t next_thread_ = 0;
+    size_t ring_capacity_ = 4096;
+    std::vector<event> events_;
+    std::vector<event> capture_;
+    bool capturing_ = false;
+    frame last_;
+    uint64_t frame_index_ = 0;
+    uint64_t frame_begin_;
+};
+
+// Log-bucketed histogram of tick values in the style of HDR histograms: values
+// below 2^sub_bits are counted exactly, larger ones with 2^sub_bits buckets per
+// power of two (~3% relative precision). Memory is fixed and recording is O(1).
+class histogram {
+public:
+    static constexpr int sub_bits = 5;
+    static constexpr int sub_count = 1 << sub_bits;
+    static constexpr int max_exponent = 40;  // ~18 minutes in nanosecond ticks
+    static constexpr int num_buckets = (max_exponent - sub_bits + 2) * sub_count;
+
+    static int bucket(uint64_t value) {
+        if (value < (uint64_t)sub_count)
+            return (int)value;
+        int e = 63;
+        while (!(value >> e))
+            e--;
+        if (e > max_exponent)
+            return num_buckets - 1;
+        int sub = (int)(value >> (e - sub_bits)) & (sub_count - 1);
+        return (e - sub_bits + 1) * sub_count + sub;
+    }
+
+    // Midpoint of the value range covered by a bucket
+    static uint64_t bucket_value(int index) {
+        if (index < sub_count)
+            return (uint64_t)index;
+        int e = index / sub_count + sub_bits - 1;
+        int sub = index % sub_count;
+        uint64_t lo = ((uint64_t)(sub_count + sub)) << (e - sub_bits);
+        uint64_t width = 1ull << (e - sub_bits);
+        return lo + width / 2;
+    }
+
+    void add(uint64_t value) {
+        counts_[bucket(value)]++;
+        total_++;
+    }
+
+    void remove(uint64_t value) {
+        counts_[bucket(value)]--;
+        total_--;
+    }
+
+    void clear() {
+        std::fill(std::begin(counts_), std::end(counts_), 0u);
+        total_ = 0;
+    }
+
+    uint64_t count() const { return total_; }
+
+    // Value at percentile p in [0, 100]
+    uint64_t percentile(double p) const {
+        if (!total_)
+            return 0;
+        uint64_t rank = (uint64_t)std::ceil(p / 100.0 * (double)total_);
+        if (rank == 0)
+            rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < num_buckets; i++) {
+            seen += counts_[i];
+            if (seen >= rank)
+                return bucket_value(i);
+        }
+        return bucket_value(num_buckets - 1);
+    }
+
+private:
+    uint32_t counts_[num_buckets] = {};
+    uint64_t total_ = 0;
+};
+
+// Frame-time statistics over a rolling window of the last N frames. Feed it
+// with lap() once per frame, or record() with ticks from any other source.
+class frame_stats {
+public:
+    explicit frame_stats(size_t window = 240) : samples_(window ? window : 1) {}
+
+    // Record the time since the previous lap() call; the first call only starts the clock
+    uint64_t lap() {
+        bool first = last_time_ == 0;
+        uint64_t ticks = stm_laptime(&last_time_);
+        if (!first)
+            record(ticks);
+        return ticks;
+    }
+
+    void record(uint64_t ticks) {
+        const size_t n = samples_.size();
+        if (count_ == n) {
+            // evict the oldest sample and its contribution to the jitter sum
+            const size_t oldest = next_;
+            hist_.remove(samples_[oldest]);
+            sum_ -= samples_[oldest];
+            if (n > 1)
+                jitter_sum_ -= absdiff(samples_[(oldest + 1) % n], samples_[oldest]);
+            count_--;
+        }
+        if (count_ > 0)
+            jitter_sum_ += absdiff(ticks, last_sample_);
+        samples_[next_] = ticks;
+        next_ = (next_ + 1) % n;
+        count_++;
+        hist_.add(ticks);
+        sum_ += ticks;
+        last_sample_ = ticks;
+        total_frames_++;
+    }
+
+    void reset() {
+        hist_.clear();
+        count_ = 0;
+        next_ = 0;
+        sum_ = 0;
+        jitter_sum_ = 0;
+        last_time_ = 0;
+        last_sample_ = 0;
+    }
+
+    size_t window() const { return samples_.size(); }
+    size_t count() const { return count_; }
+    uint64_t total_frames() const { return total_frames_; }
+    uint64_t last() const { return last_sample_; }
+    uint64_t percentile(double p) const { return hist_.percentile(p); }
+    const histogram& hist() const { return hist_; }
+
+    double mean_ms() const { return count_ ? stm_ms(sum_) / (double)count_ : 0.0; }
+    double percentile_ms(double p) const { return stm_ms(hist_.percentile(p)); }
+    double p50_ms() const { return percentile_ms(50.0); }
+    double p95_ms() const { return percentile_ms(95.0); }
+    double p99_ms() const { return percentile_ms(99.0); }
+    double max_ms() const { return percentile_ms(100.0); }
+    // Mean absolute difference between consecutive frame times
+    double jitter_ms() const { return count_ > 1 ? stm_ms(jitter_sum_) / (double)(count_ - 1) : 0.0; }
+
+private:
+    static uint64_t absdiff(uint64_t a, uint64_t b) { return a > b ? a - b : b - a; }
+
+    std::vector<uint64_t> samples_;
+    histogram hist_;
+    size_t count_ = 0;
+    size_t next_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t jitter_sum_ = 0;
+    uint64_t last_time_ = 0;
+    uint64_t last_sample_ = 0;
+    uint64_t total_frames_ = 0;
+};
+
+// Paces frames to a target frame time: sleeps for most of the remaining budget and
+// spins the rest. The CPU work time of recent frames drives a dynamic resolution
+// hint in [min_scale, max_scale]. begin_frame()/end_work() take explicit timestamps
+// so the controller can be driven with synthetic ones.
+class frame_pacer {
+public:
+    struct config {
+        double target_ms = 1000.0 / 60.0;
+        double spin_ms = 1.0;          // tail of the wait that is spun instead of slept
+        double high_watermark = 0.90;  // scale down when p95 work exceeds this share of the target
+        double low_watermark = 0.70;   // scale up when p95 work falls below this share
+        float min_scale = 0.5f;
+        float max_scale = 1.0f;
+        float scale_step = 0.05f;
+        int cooldown_frames = 30;      // frames between resolution changes
+        size_t window = 120;
+    };
+
+    frame_pacer() : frame_pacer(config()) {}
+    explicit frame_pacer(const config& cfg) : cfg_(cfg), work_(cfg.window), scale_(cfg.max_scale) {
+        target_ticks_ = ticks(cfg.target_ms);
+        spin_ticks_ = ticks(cfg.spin_ms);
+    }
+
+    // Retarget, e.g. when the window moves to a display with a different refresh rate
+    void set_target_ms(double target_ms) {
+        cfg_.target_ms = target_ms;
+        target_ticks_ = ticks(target_ms);
+    }
+
+    void begin_frame(uint64_t now) {
+        frame_start_ = now;
+        started_ = true;
+    }
+
+    // Record the work done since begin_frame() and return the ticks left until the target
+    uint64_t end_work(uint64_t now) {
+        uint64_t work = started_ ? stm_diff(now, frame_start_) : 0;
+        work_.record(work);
+        update_scale();
+        uint64_t deadline = frame_start_ + target_ticks_;
+        return now < deadline ? deadline - now : 0;
+    }
+
+    // End the frame's work, wait until the target frame time and start the next frame
+    void pace() {
+        if (!started_) {
+            begin_frame(stm_now());
+            return;
+        }
+        uint64_t now = stm_now();
+        uint64_t remaining = end_work(now);
+        uint64_t deadline = now + remaining;
+        if (remaining > spin_ticks_) {
+            double sleep_ms = stm_ms(remaining - spin_ticks_);
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(sleep_ms));
+        }
+        while ((now = stm_now()) < deadline)
+            ;
+        // keep the cadence unless the frame overran its budget
+        begin_frame(remaining ? deadline : now);
+        frames_.lap();
+    }
+
+    float resolution_scale() const { return scale_; }
+    const frame_stats& work_stats() const { return work_; }
+    const frame_stats& frame_times() const { return frames_; }
+    const config& get_config() const { return cfg_; }
+    uint64_t target_ticks() const { return target_ticks_; }
+
+private:
+    static uint64_t ticks(double ms) { return (uint64_t)(ms * 1000000.0 / stm_ms(1000000)); }
+
+    void update_scale() {
+        if (cooldown_ > 0) {
+            cooldown_--;
+            return;
+        }
+        if (work_.count() < work_.window() / 4)
+            return;
+        double p95 = work_.p95_ms();
+        if (p95 > cfg_.target_ms * cfg_.high_watermark && scale_ > cfg_.min_scale) {
+            scale_ = std::max(cfg_.min_scale, scale_ - cfg_.scale_step);
+            cooldown_ = cfg_.cooldown_frames;
+        } else if (p95 < cfg_.target_ms * cfg_.low_watermark && scale_ < cfg_.max_scale) {
+            scale_ = std::min(cfg_.max_scale, scale_ + cfg_.scale_step);
+            cooldown_ = cfg_.cooldown_frames;
+        }
+    }
+
+    config cfg_;
+    frame_stats work_;
+    frame_stats frames_;
+    uint64_t target_ticks_ = 0;
+    uint64_t spin_ticks_ = 0;
+    uint64_t frame_start_ = 0;
+    bool started_ = false;
+    float scale_;
+    int cooldown_ = 0;
+};
+} // namespace stm
+
+#ifndef SOKOL_NO_PROFILER
+#define STM_PROFILE_CONCAT_(a, b) a##b
+#define STM_PROFILE_CONCAT(a, b) STM_PROFILE_CONCAT_(a, b)
+#define STM_PROFILE_SCOPE(name) ::stm::profiler::scope STM_PROFILE_CONCAT(stm_profile_scope_, __LINE__)(name)
+#else
+#define STM_PROFILE_SCOPE(name) ((void)0)
+#endif
+#endif // SOKOL_NO_STM
@@ -0,0 +1,24 @@
+// Machine generated C++ wrapper for Sokol library.
+// https://github.com/takeiteasy/sokol.hpp
+//
+// Do not edit manually; regenerate using generate.py.
+
+#pragma once
+#include <utility>
+#include <memory>
+
+#ifndef SOKOL_TIME_INCLUDED
+#if __has_include("sokol_time.h")
+#include "sokol_time.h"
+#elif __has_include("sokol/sokol_time.h")
+#include "sokol/sokol_time.h"
+#else
+#warning "Cannot find sokol_time.h, disabling!"
+#define SOKOL_NO_STM
+#endif
+#endif
+
+#ifndef SOKOL_NO_STM
+namespace stm {
+} // namespace stm
+#endif // SOKOL_NO_STM
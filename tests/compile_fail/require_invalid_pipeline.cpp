@@ -0,0 +1,10 @@
+// Must not compile: the pipeline feeds an integer vertex format to a float shader attribute,
+// so require() reaches helper::pipeline_validation_failed_attr_format_mismatch
+
+#include "sokol_gfx.hpp"
+
+constexpr auto shd = sg::shader_interface().attr(0, SG_SHADERATTRBASETYPE_FLOAT);
+constexpr auto pip = sg::pipeline_layout().attr(0, SG_VERTEXFORMAT_INT3);
+static_assert(sg::require(sg::validate(shd, pip)));
+
+int main() {}
@@ -0,0 +1,26 @@
+// Minimal checks for the sokol_hpp tests; each test executable links the sokol dummy
+// backends and returns non-zero if any check failed
+#pragma once
+#include <cstdio>
+
+namespace test {
+inline int checks = 0;
+inline int failures = 0;
+
+inline bool check(bool ok, const char* expr, const char* file, int line) {
+    checks++;
+    if (!ok) {
+        failures++;
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    }
+    return ok;
+}
+
+// Print a summary and return the process exit code
+inline int finish(const char* name) {
+    printf("%s: %d checks, %d failed\n", name, checks, failures);
+    return failures ? 1 : 0;
+}
+} // namespace test
+
+#define CHECK(expr) test::check((expr), #expr, __FILE__, __LINE__)
@@ -0,0 +1,69 @@
+// saudio::graph with saudio::gain_node; the graph is driven through process() directly, as
+// the audio thread would
+
+#include "sokol.hpp"
+#include "test.hpp"
+#include <vector>
+
+namespace {
+
+struct constant {
+    float value = 1.0f;
+    void operator()(float* buffer, int num_frames, int num_channels) {
+        for (int i = 0; i < num_frames * num_channels; i++)
+            buffer[i] = value;
+    }
+};
+
+void test_gain_node() {
+    saudio::gain_node gain(1.0f);
+    std::vector<float> in(64 * 2, 1.0f), out(64 * 2, -1.0f);
+    const float* inputs[1] = {in.data()};
+    CHECK(gain.process(inputs, out.data(), 64, 2) && out[0] == 1.0f && out[127] == 1.0f);
+
+    // a fade to zero is ramped over one block and is not silent until the next one
+    gain.set_gain(0.0f);
+    CHECK(gain.process(inputs, out.data(), 64, 2));
+    CHECK(out[0] == 1.0f && out[1] == 1.0f && out[64] == 0.5f && out[126] > 0.0f && out[127] > 0.0f);
+    CHECK(!gain.process(inputs, out.data(), 64, 2) && out[0] == 0.0f && out[127] == 0.0f);
+
+    // and back up from zero
+    gain.set_gain(1.0f);
+    CHECK(gain.process(inputs, out.data(), 64, 2) && out[0] == 0.0f && out[126] > 0.9f);
+}
+
+void test_graph_fade_out() {
+    saudio::graph::config cfg;
+    cfg.block_frames = 64;
+    cfg.channels = 1;
+    cfg.measure_cost = false;
+    saudio::graph g(cfg);
+    constant src;
+    auto* source = g.add<saudio::source_node<constant>>(src);
+    auto* gain = g.add<saudio::gain_node>(1.0f);
+    CHECK(g.connect(source, gain));
+    g.set_output(gain);
+    CHECK(g.commit());
+
+    std::vector<float> out(64, -1.0f);
+    g.process(out.data(), 64, 1);
+    CHECK(out[0] == 1.0f && out[63] == 1.0f);
+
+    // the ramp block reaches the output instead of being dropped as silent
+    gain->set_gain(0.0f);
+    g.process(out.data(), 64, 1);
+    bool ramp = true;
+    for (int i = 0; i < 64; i++)
+        ramp = ramp && out[(size_t)i] > 0.0f && (i == 0 || out[(size_t)i] < out[(size_t)i - 1]);
+    CHECK(ramp);
+    g.process(out.data(), 64, 1);
+    CHECK(out[0] == 0.0f && out[63] == 0.0f);
+}
+
+} // namespace
+
+int main() {
+    test_gain_node();
+    test_graph_fade_out();
+    return test::finish("test_audio_graph");
+}
@@ -0,0 +1,291 @@
+// saudio::pcm_format::parse_wav, saudio::pcm_to_float and saudio::file_stream seeking and
+// end of file; no audio device is needed, file_stream is driven through read() directly
+
+#include "sokol.hpp"
+#include "test.hpp"
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+void put16(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back((uint8_t)v);
+    out.push_back((uint8_t)(v >> 8));
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    put16(out, v & 0xffff);
+    put16(out, v >> 16);
+}
+
+void put_tag(std::vector<uint8_t>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+// RIFF/WAVE file with a fmt chunk (extensible if requested), an odd-sized chunk to skip
+// and the data chunk
+std::vector<uint8_t> make_wav(uint32_t tag, int bits, int channels, int rate, const std::vector<uint8_t>& data, bool extensible = false) {
+    std::vector<uint8_t> w;
+    put_tag(w, "RIFF");
+    put32(w, 0);
+    put_tag(w, "WAVE");
+    put_tag(w, "fmt ");
+    put32(w, extensible ? 40 : 16);
+    put16(w, extensible ? 0xfffe : tag);
+    put16(w, (uint32_t)channels);
+    put32(w, (uint32_t)rate);
+    put32(w, (uint32_t)(rate * channels * bits / 8));
+    put16(w, (uint32_t)(channels * bits / 8));
+    put16(w, (uint32_t)bits);
+    if (extensible) {
+        put16(w, 22);
+        put16(w, (uint32_t)bits);
+        put32(w, 0);
+        // sub-format GUID, the first two bytes carry the format tag
+        put16(w, tag);
+        for (int i = 0; i < 14; i++)
+            w.push_back(0);
+    }
+    put_tag(w, "LIST");
+    put32(w, 3);
+    w.insert(w.end(), {'a', 'b', 'c', 0});
+    put_tag(w, "data");
+    put32(w, (uint32_t)data.size());
+    w.insert(w.end(), data.begin(), data.end());
+    const uint32_t riff_size = (uint32_t)w.size() - 8;
+    memcpy(w.data() + 4, &riff_size, 4);
+    return w;
+}
+
+void test_parse_wav() {
+    std::vector<uint8_t> data(4 * 10);
+    saudio::pcm_format fmt;
+
+    std::vector<uint8_t> w = make_wav(1, 16, 2, 48000, data);
+    CHECK(saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    CHECK(fmt.enc == saudio::pcm_format::encoding::s16 && fmt.channels == 2 && fmt.sample_rate == 48000);
+    CHECK(fmt.frames == 10 && fmt.bytes_per_frame() == 4);
+
+    w = make_wav(1, 24, 1, 44100, std::vector<uint8_t>(3 * 7));
+    CHECK(saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    CHECK(fmt.enc == saudio::pcm_format::encoding::s24 && fmt.channels == 1 && fmt.frames == 7);
+    CHECK(fmt.data_offset == w.size() - 3 * 7);
+
+    w = make_wav(3, 32, 2, 22050, std::vector<uint8_t>(8 * 5));
+    CHECK(saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    CHECK(fmt.enc == saudio::pcm_format::encoding::f32 && fmt.sample_rate == 22050 && fmt.frames == 5);
+
+    w = make_wav(1, 32, 1, 8000, std::vector<uint8_t>(4 * 3));
+    CHECK(saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    CHECK(fmt.enc == saudio::pcm_format::encoding::s32 && fmt.frames == 3);
+
+    // WAVE_FORMAT_EXTENSIBLE takes the format from the sub-format GUID
+    w = make_wav(3, 32, 2, 48000, std::vector<uint8_t>(8 * 4), true);
+    CHECK(saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    CHECK(fmt.enc == saudio::pcm_format::encoding::f32 && fmt.channels == 2 && fmt.frames == 4);
+    w = make_wav(1, 24, 6, 48000, std::vector<uint8_t>(18 * 2), true);
+    CHECK(saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    CHECK(fmt.enc == saudio::pcm_format::encoding::s24 && fmt.channels == 6 && fmt.frames == 2);
+
+    // a data chunk cut short by the end of the file only counts the frames present
+    w = make_wav(1, 16, 2, 48000, data);
+    w.resize(w.size() - 6);
+    CHECK(saudio::pcm_format::parse_wav(w.data(), w.size(), fmt) && fmt.frames == 8);
+
+    // rejected: unsupported formats, missing chunks, truncated headers
+    w = make_wav(1, 8, 1, 8000, data);
+    CHECK(!saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    w = make_wav(2, 16, 1, 8000, data);
+    CHECK(!saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    w = make_wav(1, 16, 1, 8000, data);
+    memcpy(w.data() + 8, "AVI ", 4);
+    CHECK(!saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    w = make_wav(1, 16, 1, 8000, data);
+    memcpy(w.data() + 12, "junk", 4);
+    CHECK(!saudio::pcm_format::parse_wav(w.data(), w.size(), fmt));
+    w = make_wav(1, 16, 2, 48000, data, true);
+    for (size_t size = 0; size < 12 + 8 + 40; size++)
+        CHECK(!saudio::pcm_format::parse_wav(w.data(), size, fmt));
+}
+
+void test_pcm_to_float() {
+    // long enough for the SIMD paths and their scalar tails
+    const int n = 37;
+    std::vector<uint8_t> s16, s24, s32, f32;
+    std::vector<float> expect((size_t)n), out((size_t)n);
+    for (int i = 0; i < n; i++) {
+        const int32_t x24 = (int32_t)((uint32_t)i * 2654435761u) >> 8;  // spread over the 24-bit range, both signs
+        const int16_t x16 = (int16_t)(x24 >> 8);
+        put16(s16, (uint16_t)x16);
+        s24.push_back((uint8_t)x24);
+        s24.push_back((uint8_t)(x24 >> 8));
+        s24.push_back((uint8_t)(x24 >> 16));
+        put32(s32, (uint32_t)(x24 * 256));
+        expect[(size_t)i] = (float)x24 / 8388608.0f;
+        const float f = expect[(size_t)i];
+        uint32_t bits;
+        memcpy(&bits, &f, 4);
+        put32(f32, bits);
+    }
+
+    auto max_error = [&](float tolerance_scale) {
+        double err = 0.0;
+        for (int i = 0; i < n; i++)
+            err = std::max(err, (double)std::fabs(out[(size_t)i] - expect[(size_t)i]));
+        return err * tolerance_scale;
+    };
+    saudio::pcm_to_float(saudio::pcm_format::encoding::s16, s16.data(), out.data(), (size_t)n);
+    CHECK(max_error(32768.0f) <= 1.0);
+    saudio::pcm_to_float(saudio::pcm_format::encoding::s24, s24.data(), out.data(), (size_t)n);
+    CHECK(max_error(1.0f) == 0.0);
+    saudio::pcm_to_float(saudio::pcm_format::encoding::s32, s32.data(), out.data(), (size_t)n);
+    CHECK(max_error(1.0f) == 0.0);
+    saudio::pcm_to_float(saudio::pcm_format::encoding::f32, f32.data(), out.data(), (size_t)n);
+    CHECK(max_error(1.0f) == 0.0);
+
+    // full-scale values
+    const uint8_t s16_ext[4] = {0x00, 0x80, 0xff, 0x7f};
+    saudio::pcm_to_float(saudio::pcm_format::encoding::s16, s16_ext, out.data(), 2);
+    CHECK(out[0] == -1.0f && out[1] == 32767.0f / 32768.0f);
+    const uint8_t s24_ext[6] = {0x00, 0x00, 0x80, 0xff, 0xff, 0x7f};
+    saudio::pcm_to_float(saudio::pcm_format::encoding::s24, s24_ext, out.data(), 2);
+    CHECK(out[0] == -1.0f && std::fabs(out[1] - 8388607.0f / 8388608.0f) < 1e-7f);
+}
+
+// Pull frames from the stream until it reports the end, as the audio thread would
+std::vector<float> read_to_end(saudio::file_stream& fs, int chunk_frames) {
+    const int ch = fs.format().channels;
+    std::vector<float> all, buf((size_t)chunk_frames * (size_t)ch);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!fs.finished() && std::chrono::steady_clock::now() < deadline) {
+        const int n = fs.read(buf.data(), chunk_frames);
+        all.insert(all.end(), buf.begin(), buf.begin() + (ptrdiff_t)n * ch);
+        if (n == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return all;
+}
+
+void test_file_stream() {
+    // stereo s16 ramp, left = frame index, right = -frame index
+    const int frames = 1000;
+    std::vector<uint8_t> data;
+    for (int i = 0; i < frames; i++) {
+        put16(data, (uint16_t)(int16_t)i);
+        put16(data, (uint16_t)(int16_t)-i);
+    }
+    const std::vector<uint8_t> w = make_wav(1, 16, 2, 48000, data);
+    const std::string path = "test_audio_pcm.wav";
+    FILE* f = fopen(path.c_str(), "wb");
+    CHECK(f != nullptr);
+    if (!f)
+        return;
+    fwrite(w.data(), 1, w.size(), f);
+    fclose(f);
+
+    saudio::file_stream::config cfg;
+    cfg.block_frames = 64;
+    cfg.num_blocks = 4;
+    cfg.poll_interval_ms = 1;
+    saudio::file_stream fs(cfg);
+    CHECK(!fs.open_wav("does_not_exist.wav") && !fs.is_open());
+    CHECK(fs.open_wav(path.c_str()));
+    CHECK(fs.length() == frames && fs.format().channels == 2 && fs.format().sample_rate == 48000);
+
+    auto frame_value = [](int i) { return (float)i / 32768.0f; };
+    std::vector<float> all = read_to_end(fs, 100);
+    CHECK(all.size() == 2 * (size_t)frames);
+    bool ramp = all.size() == 2 * (size_t)frames;
+    for (int i = 0; ramp && i < frames; i++)
+        ramp = all[2 * (size_t)i] == frame_value(i) && all[2 * (size_t)i + 1] == -frame_value(i);
+    CHECK(ramp);
+    CHECK(fs.position() == frames);
+
+    // past the end: silence, no underruns
+    const uint64_t underruns = fs.underruns();
+    float tail[2 * 16];
+    memset(tail, 0x7f, sizeof(tail));
+    CHECK(fs.read(tail, 16) == 0);
+    CHECK(tail[0] == 0.0f && tail[31] == 0.0f && fs.underruns() == underruns);
+
+    // seeks are frame accurate and restart from the end too
+    fs.seek(777);
+    CHECK(!fs.finished());
+    all = read_to_end(fs, 10);
+    CHECK(all.size() == 2 * (size_t)(frames - 777));
+    CHECK(!all.empty() && all[0] == frame_value(777) && all[1] == -frame_value(777));
+    CHECK(!all.empty() && all[all.size() - 2] == frame_value(frames - 1));
+    fs.seek(5000);
+    all = read_to_end(fs, 10);
+    CHECK(all.empty() && fs.finished());
+    fs.seek(-3);
+    all = read_to_end(fs, 256);
+    CHECK(all.size() == 2 * (size_t)frames && all[0] == 0.0f);
+
+    // reopening mid-stream discards the old file's blocks; a mono file is spread over
+    // both output channels by the callback
+    fs.seek(0);
+    CHECK(fs.read(tail, 16) >= 0);
+    std::vector<uint8_t> mono;
+    for (int i = 0; i < frames; i++)
+        put16(mono, (uint16_t)(int16_t)(frames + i));
+    const std::string mono_path = "test_audio_pcm_mono.wav";
+    f = fopen(mono_path.c_str(), "wb");
+    CHECK(f != nullptr);
+    if (f) {
+        const std::vector<uint8_t> m = make_wav(1, 16, 1, 48000, mono);
+        fwrite(m.data(), 1, m.size(), f);
+        fclose(f);
+    }
+    CHECK(fs.open_wav(mono_path.c_str()) && fs.format().channels == 1 && fs.position() == 0);
+    std::vector<float> out;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!fs.finished() && std::chrono::steady_clock::now() < deadline) {
+        // every file frame is non-zero, the zeros are underruns while the prefetch thread
+        // catches up
+        float buf[2 * 50];
+        fs(buf, 50, 2);
+        size_t n = 0;
+        for (int i = 0; i < 50; i++) {
+            if (buf[2 * i] != 0.0f) {
+                out.insert(out.end(), buf + 2 * i, buf + 2 * i + 2);
+                n++;
+            }
+        }
+        if (n == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(out.size() == 2 * (size_t)frames);
+    bool spread = out.size() == 2 * (size_t)frames;
+    for (int i = 0; spread && i < frames; i++)
+        spread = out[2 * (size_t)i] == frame_value(frames + i) && out[2 * (size_t)i + 1] == frame_value(frames + i);
+    CHECK(spread);
+
+    // files with more channels than the ring holds are rejected
+    const std::vector<uint8_t> six = make_wav(1, 16, 6, 48000, std::vector<uint8_t>(12 * 4));
+    f = fopen(mono_path.c_str(), "wb");
+    if (f) {
+        fwrite(six.data(), 1, six.size(), f);
+        fclose(f);
+    }
+    CHECK(!fs.open_wav(mono_path.c_str()));
+
+    // closing leaves the stream readable as silence
+    fs.close();
+    CHECK(!fs.is_open() && fs.finished());
+    memset(tail, 0x7f, sizeof(tail));
+    CHECK(fs.read(tail, 16) == 0 && tail[0] == 0.0f);
+    remove(path.c_str());
+    remove(mono_path.c_str());
+}
+
+} // namespace
+
+int main() {
+    test_parse_wav();
+    test_pcm_to_float();
+    test_file_stream();
+    return test::finish("test_audio_pcm");
+}
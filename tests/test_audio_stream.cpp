@@ -0,0 +1,145 @@
+// saudio::bind, saudio::spsc_ring and saudio::push_stream against the dummy backend, which
+// never runs the stream callback itself; the tests call the installed callback directly
+
+#include "sokol.hpp"
+#include "test.hpp"
+#include <vector>
+
+namespace {
+
+// Invoke the stream callback a desc was configured with, as the audio thread would
+void run_callback(const saudio_desc& d, float* buffer, int num_frames, int num_channels) {
+    d.stream_userdata_cb(buffer, num_frames, num_channels, d.user_data);
+}
+
+void test_bind() {
+    struct counter {
+        int calls = 0;
+        int frames = 0;
+        int channels = 0;
+        void operator()(float* buffer, int num_frames, int num_channels) {
+            calls++;
+            frames += num_frames;
+            channels = num_channels;
+            buffer[0] = 1.0f;
+        }
+    } c;
+    saudio::desc d;
+    CHECK(&saudio::bind(d, c) == &d);
+    CHECK(d.get().stream_userdata_cb != nullptr && d.get().user_data == &c);
+    float buf[2 * 64] = {};
+    run_callback(d.get(), buf, 64, 2);
+    run_callback(d.get(), buf, 32, 2);
+    CHECK(c.calls == 2 && c.frames == 96 && c.channels == 2 && buf[0] == 1.0f);
+
+    // lambdas bind the same way
+    int calls = 0;
+    auto fn = [&](float*, int, int) { calls++; };
+    saudio::bind(d, fn);
+    run_callback(d.get(), buf, 16, 1);
+    CHECK(calls == 1 && c.calls == 2);
+}
+
+void test_spsc_ring() {
+    saudio::spsc_ring ring(100, 2);
+    // capacity rounds up to a power of two samples, in whole frames
+    CHECK(ring.capacity() == 128 && ring.channels() == 2);
+    CHECK(ring.expect() == 128 && ring.available() == 0);
+
+    std::vector<float> in(2 * 256), out(2 * 256, -1.0f);
+    for (size_t i = 0; i < in.size(); i++)
+        in[i] = (float)i;
+    CHECK(ring.push(in.data(), 100) == 100);
+    CHECK(ring.available() == 100 && ring.expect() == 28);
+    CHECK(ring.pop(out.data(), 60) == 60);
+    CHECK(out[0] == 0.0f && out[119] == 119.0f);
+
+    // wraps around the end of the storage
+    CHECK(ring.push(in.data() + 200, 80) == 80);
+    CHECK(ring.pop(out.data(), 120) == 120);
+    bool in_order = true;
+    for (int i = 0; i < 80; i++)
+        in_order &= out[(size_t)i] == (float)(120 + i) && out[80 + (size_t)i] == (float)(200 + i);
+    CHECK(in_order);
+    CHECK(ring.overruns() == 0 && ring.underruns() == 0);
+
+    // overruns drop the tail, underruns zero-fill the tail
+    CHECK(ring.push(in.data(), 200) == 128);
+    CHECK(ring.overruns() == 1 && ring.overrun_frames() == 72);
+    CHECK(ring.pop(out.data(), 130) == 128);
+    CHECK(out[255] == 255.0f && out[256] == 0.0f && out[259] == 0.0f);
+    CHECK(ring.underruns() == 1 && ring.underrun_frames() == 2);
+
+    ring.reset(16, 3);
+    CHECK(ring.channels() == 3 && ring.capacity() == 21 && ring.available() == 0 && ring.overruns() == 0);
+
+    // one producer and one consumer thread, frames arrive complete and in order
+    saudio::spsc_ring shared(64, 2);
+    const int total = 200000;
+    std::thread producer([&] {
+        float frame[2];
+        for (int i = 0; i < total;) {
+            frame[0] = (float)i;
+            frame[1] = -(float)i;
+            if (shared.push(frame, 1) == 1)
+                i++;
+            else
+                std::this_thread::yield();
+        }
+    });
+    bool ordered = true;
+    float frame[2];
+    for (int i = 0; i < total;) {
+        if (shared.available() == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        shared.pop(frame, 1);
+        ordered &= frame[0] == (float)i && frame[1] == -(float)i;
+        i++;
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(shared.underruns() == 0);
+}
+
+void test_push_stream() {
+    saudio::push_stream stream(256, 2);
+    saudio::desc d;
+    CHECK(stream.setup(d));
+    CHECK(saudio_channels() == 2);
+    const saudio_desc active = saudio_query_desc();
+    CHECK(active.stream_userdata_cb != nullptr && active.user_data == &stream);
+
+    std::vector<float> in(2 * 64), out(2 * 64, -1.0f);
+    for (size_t i = 0; i < in.size(); i++)
+        in[i] = 0.5f;
+    CHECK(stream.expect() == 256);
+    CHECK(stream.push(in.data(), 64) == 64);
+    CHECK(stream.expect() == 192);
+    run_callback(active, out.data(), 64, 2);
+    CHECK(out[0] == 0.5f && out[127] == 0.5f);
+    CHECK(stream.ring().available() == 0 && stream.ring().underruns() == 0);
+
+    // an empty ring plays silence
+    run_callback(active, out.data(), 64, 2);
+    CHECK(out[0] == 0.0f && stream.ring().underruns() == 1);
+
+    // a channel count other than the ring's plays silence and leaves the ring alone
+    stream.push(in.data(), 16);
+    out.assign(out.size(), -1.0f);
+    run_callback(active, out.data(), 32, 1);
+    CHECK(out[0] == 0.0f && out[31] == 0.0f && out[32] == -1.0f);
+    CHECK(stream.ring().available() == 16);
+
+    saudio_shutdown();
+}
+
+} // namespace
+
+int main() {
+    test_bind();
+    test_spsc_ring();
+    test_push_stream();
+    return test::finish("test_audio_stream");
+}
@@ -0,0 +1,99 @@
+// stm::frame_pacer driven with synthetic timestamps through begin_frame()/end_work(); pace()
+// itself sleeps on the real clock and is not exercised here
+
+#include "sokol.hpp"
+#include "test.hpp"
+
+namespace {
+
+uint64_t ticks(double ms) { return (uint64_t)(ms * 1000000.0 / stm_ms(1000000)); }
+
+stm::frame_pacer::config small_window() {
+    stm::frame_pacer::config cfg;
+    cfg.window = 40;
+    cfg.cooldown_frames = 5;
+    return cfg;
+}
+
+// Run frames back to back on the target cadence, each doing work ticks of work; returns
+// the time left until the deadline reported for the last frame
+uint64_t run(stm::frame_pacer& pacer, uint64_t& now, uint64_t work, int frames) {
+    uint64_t remaining = 0;
+    for (int i = 0; i < frames; i++) {
+        pacer.begin_frame(now);
+        remaining = pacer.end_work(now + work);
+        now += work + remaining;
+    }
+    return remaining;
+}
+
+void test_steady() {
+    stm::frame_pacer pacer(small_window());
+    const uint64_t target = pacer.target_ticks();
+    CHECK(target == ticks(1000.0 / 60.0));
+
+    uint64_t now = 1000;
+    // half the budget is work, the rest is waited out
+    CHECK(run(pacer, now, target / 2, 1) == target - target / 2);
+    CHECK(run(pacer, now, target / 2, 99) == target - target / 2);
+    CHECK(now == 1000 + 100 * target);
+    CHECK(pacer.work_stats().count() == 40);
+    CHECK(pacer.work_stats().p95_ms() < 1000.0 / 60.0 * 0.70);
+    CHECK(pacer.resolution_scale() == 1.0f);
+}
+
+void test_missed_deadline() {
+    stm::frame_pacer pacer(small_window());
+    const uint64_t target = pacer.target_ticks();
+    uint64_t now = 1000;
+    run(pacer, now, target / 2, 20);
+
+    // an overrun leaves nothing to wait for
+    CHECK(run(pacer, now, target + target / 2, 1) == 0);
+    CHECK(pacer.resolution_scale() == 1.0f);
+
+    // sustained overruns step the resolution down to min_scale, one step per cooldown
+    run(pacer, now, target + target / 2, 4);
+    float first = pacer.resolution_scale();
+    CHECK(first < 1.0f && first >= 0.95f - 1e-5f);
+    run(pacer, now, target + target / 2, 200);
+    CHECK(pacer.resolution_scale() == 0.5f);
+
+    // and back up once the work fits again
+    CHECK(run(pacer, now, target / 4, 200) == target - target / 4);
+    CHECK(pacer.resolution_scale() == 1.0f);
+}
+
+void test_refresh_rate_change() {
+    stm::frame_pacer pacer(small_window());
+    const uint64_t target60 = pacer.target_ticks();
+    const uint64_t work = ticks(8.0);
+    uint64_t now = 1000;
+    CHECK(run(pacer, now, work, 60) == target60 - work);
+    CHECK(pacer.resolution_scale() == 1.0f);
+
+    // moving to a 144 Hz display shortens the budget below the work
+    pacer.set_target_ms(1000.0 / 144.0);
+    const uint64_t target144 = pacer.target_ticks();
+    CHECK(target144 == ticks(1000.0 / 144.0) && target144 < work);
+    CHECK(run(pacer, now, work, 1) == 0);
+    run(pacer, now, work, 200);
+    CHECK(pacer.resolution_scale() < 1.0f);
+
+    // work that fits the new budget is paced to it
+    const uint64_t light = ticks(2.0);
+    CHECK(run(pacer, now, light, 1) == target144 - light);
+    uint64_t start = now;
+    run(pacer, now, light, 10);
+    CHECK(now - start == 10 * target144);
+}
+
+} // namespace
+
+int main() {
+    stm_setup();
+    test_steady();
+    test_missed_deadline();
+    test_refresh_rate_change();
+    return test::finish("test_frame_pacer");
+}
@@ -0,0 +1,105 @@
+// sg::storage_buffer, sg::storage_image, sg::ping_pong and sg::compute_pass against the dummy
+// backend
+
+#include "sokol.hpp"
+#include "test.hpp"
+
+namespace {
+
+void test_storage_resources() {
+    const float data[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    sg::storage_buffer<float> buf(4, data);
+    CHECK(buf.count() == 4 && buf.size_bytes() == sizeof(data));
+    CHECK(sg_query_buffer_state(buf.buffer()) == SG_RESOURCESTATE_VALID);
+    CHECK(sg_query_view_state(buf.view()) == SG_RESOURCESTATE_VALID);
+
+    const sg_buffer handle = buf.buffer();
+    sg::storage_buffer<float> moved(std::move(buf));
+    CHECK(moved.buffer().id == handle.id && moved.count() == 4);
+    CHECK(buf.buffer().id == SG_INVALID_ID && buf.view().id == SG_INVALID_ID && buf.count() == 0);
+    moved.reset();
+    CHECK(sg_query_buffer_state(handle) == SG_RESOURCESTATE_INVALID);
+
+    sg::storage_image img(16, 16);
+    CHECK(sg_query_image_state(img.image()) == SG_RESOURCESTATE_VALID);
+    CHECK(img.view().id != SG_INVALID_ID && img.texture_view().id != SG_INVALID_ID && img.view().id != img.texture_view().id);
+    const sg_view texture_view = img.texture_view();
+    img = sg::storage_image();
+    CHECK(sg_query_view_state(texture_view) == SG_RESOURCESTATE_INVALID);
+}
+
+void test_ping_pong() {
+    auto pp = sg::ping_pong<sg::storage_buffer<float>>::make(16);
+    const sg_view a = pp.read_view();
+    const sg_view b = pp.write_view();
+    CHECK(a.id != SG_INVALID_ID && b.id != SG_INVALID_ID && a.id != b.id);
+    CHECK(pp.front().view().id == a.id && pp.back().view().id == b.id);
+    pp.swap();
+    CHECK(pp.read_view().id == b.id && pp.write_view().id == a.id);
+    pp.swap();
+    CHECK(pp.read_view().id == a.id);
+
+    auto images = sg::ping_pong<sg::storage_image>::make(8, 8, SG_PIXELFORMAT_RGBA32F);
+    CHECK(images.front().image().id != images.back().image().id);
+}
+
+void test_compute_pass() {
+    CHECK(sg::compute_pass::group_count(0, 64) == 0);
+    CHECK(sg::compute_pass::group_count(1, 64) == 1);
+    CHECK(sg::compute_pass::group_count(64, 64) == 1);
+    CHECK(sg::compute_pass::group_count(65, 64) == 2);
+    CHECK(sg::compute_pass::group_count(10, 0) == 0);
+
+    // the dummy backend accepts any shader source; slot 0 is read, slot 1 written, as
+    // ping_pong_views() binds them
+    sg::shader shd = sg::shader_desc()
+        .compute_func_source("main")
+        .view_storage_buffer_stage(0, SG_SHADERSTAGE_COMPUTE)
+        .view_storage_buffer_readonly(0, true)
+        .view_storage_buffer_hlsl_register_t_n(0, 0)
+        .view_storage_buffer_msl_buffer_n(0, 0)
+        .view_storage_buffer_wgsl_group1_binding_n(0, 0)
+        .view_storage_buffer_spirv_set1_binding_n(0, 0)
+        .view_storage_buffer_glsl_binding_n(0, 0)
+        .view_storage_buffer_stage(1, SG_SHADERSTAGE_COMPUTE)
+        .view_storage_buffer_readonly(1, false)
+        .view_storage_buffer_hlsl_register_u_n(1, 0)
+        .view_storage_buffer_msl_buffer_n(1, 1)
+        .view_storage_buffer_wgsl_group1_binding_n(1, 1)
+        .view_storage_buffer_spirv_set1_binding_n(1, 1)
+        .view_storage_buffer_glsl_binding_n(1, 1)
+        .build();
+    CHECK(sg_query_shader_state(shd.get()) == SG_RESOURCESTATE_VALID);
+    sg::pipeline pip = sg::pipeline_desc().compute(true).shader_id(shd.id()).build();
+    CHECK(sg_query_pipeline_state(pip.get()) == SG_RESOURCESTATE_VALID);
+
+    auto pp = sg::ping_pong<sg::storage_buffer<float>>::make(256);
+    {
+        sg::compute_pass pass("test_compute_pass");
+        pass.pipeline(pip.get()).ping_pong_views(0, 1, pp).dispatch_threads(256, 64);
+        CHECK(pass.num_dispatches() == 1);
+        // empty dispatches are skipped
+        pass.dispatch(0).dispatch_threads(0, 64);
+        CHECK(pass.num_dispatches() == 1);
+        // out-of-range slots are ignored
+        pass.view(-1, pp.read_view()).view(SG_MAX_VIEW_BINDSLOTS, pp.read_view()).sampler(SG_MAX_SAMPLER_BINDSLOTS, sg_sampler{});
+        pp.swap();
+        pass.ping_pong_views(0, 1, pp).dispatch(4, 2);
+        CHECK(pass.num_dispatches() == 2);
+        pass.end();
+        // ending twice, and again from the destructor, is harmless
+        pass.end();
+    }
+    sg_commit();
+}
+
+} // namespace
+
+int main() {
+    // validation stays on, a binding that does not match the shader aborts the test
+    sg::headless gfx(sg::desc().logger_func(slog_func));
+    test_storage_resources();
+    test_ping_pong();
+    test_compute_pass();
+    return test::finish("test_gfx_compute");
+}
@@ -0,0 +1,56 @@
+// sg::validate and sg::require: the pipeline from the usage comment passes static_assert, and
+// each kind of mismatch is reported by validate(); tests/compile_fail covers require() on an
+// invalid pipeline
+
+#include "sokol.hpp"
+#include "test.hpp"
+#include <string>
+
+namespace {
+
+struct vs_params_t {
+    float mvp[16];
+};
+
+constexpr auto shd = sg::shader_interface()
+    .attr(0, SG_SHADERATTRBASETYPE_FLOAT)
+    .uniform_block(0, SG_SHADERSTAGE_VERTEX, sizeof(vs_params_t))
+    .texture(0, SG_SHADERSTAGE_FRAGMENT)
+    .sampler(0, SG_SHADERSTAGE_FRAGMENT)
+    .texture_sampler_pair(0, SG_SHADERSTAGE_FRAGMENT, 0, 0);
+
+constexpr auto pip = sg::pipeline_layout()
+    .attr(0, SG_VERTEXFORMAT_FLOAT3)
+    .uniforms(0, sizeof(vs_params_t))
+    .color(0, SG_PIXELFORMAT_RGBA8);
+
+static_assert(sg::require(sg::validate(shd)));
+static_assert(sg::require(sg::validate(shd, pip)));
+
+void test_validate() {
+    CHECK((bool)sg::validate(shd, pip));
+
+    constexpr sg::validation format = sg::validate(shd, sg::pipeline_layout()
+        .attr(0, SG_VERTEXFORMAT_INT3)
+        .uniforms(0, sizeof(vs_params_t)));
+    CHECK(format.err == sg::validation::attr_format_mismatch && format.slot == 0);
+
+    constexpr sg::validation missing = sg::validate(shd, sg::pipeline_layout().uniforms(0, sizeof(vs_params_t)));
+    CHECK(missing.err == sg::validation::attr_missing && missing.slot == 0);
+
+    constexpr sg::validation size = sg::validate(shd, sg::pipeline_layout()
+        .attr(0, SG_VERTEXFORMAT_FLOAT3)
+        .uniforms(0, sizeof(vs_params_t) + 16));
+    CHECK(size.err == sg::validation::uniform_block_size_mismatch && size.slot == 0);
+
+    constexpr sg::validation pass = sg::validate(pip, sg::pass_layout().color(0, SG_PIXELFORMAT_BGRA8));
+    CHECK(pass.err == sg::validation::color_format_mismatch);
+    CHECK(std::string(pass.message()) == "color attachment format does not match the pass");
+}
+
+} // namespace
+
+int main() {
+    test_validate();
+    return test::finish("test_gfx_validate");
+}
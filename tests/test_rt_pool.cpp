@@ -0,0 +1,57 @@
+// sg::rt_pool against the dummy backend
+
+#include "sokol.hpp"
+#include "test.hpp"
+
+namespace {
+
+void test_rt_pool() {
+    sg::rt_pool pool(2);
+    sg::rt_pool::target a = pool.acquire(64, 64);
+    CHECK(sg_query_image_state(a.image) == SG_RESOURCESTATE_VALID);
+    CHECK(a.attachment.id != SG_INVALID_ID && a.texture.id != SG_INVALID_ID);
+    CHECK(pool.query_stats().misses == 1 && pool.query_stats().in_use == 1);
+
+    // a matching target is only reused once it is handed back
+    sg::rt_pool::target b = pool.acquire(64, 64);
+    CHECK(b.image.id != a.image.id);
+    pool.release(a);
+    sg::rt_pool::target c = pool.acquire(64, 64);
+    CHECK(c.image.id == a.image.id);
+    CHECK(pool.query_stats().hits == 1 && pool.query_stats().misses == 2);
+
+    // different keys never match
+    sg::rt_pool::target d = pool.acquire(64, 64, SG_PIXELFORMAT_DEPTH_STENCIL);
+    CHECK(d.image.id != a.image.id && d.image.id != b.image.id);
+    sg::rt_pool::target msaa = pool.acquire(64, 64, SG_PIXELFORMAT_RGBA8, 4);
+    CHECK(msaa.texture.id == SG_INVALID_ID);
+    CHECK(pool.query_stats().resident == 4);
+
+    // end_frame() hands everything back for the next frame
+    pool.end_frame();
+    CHECK(pool.query_stats().in_use == 0);
+    pool.acquire(64, 64);
+    pool.acquire(64, 64);
+    CHECK(pool.query_stats().hits == 3 && pool.query_stats().resident == 4);
+
+    // entries unused for more than max_unused_frames are destroyed
+    for (int i = 0; i < 4; i++)
+        pool.end_frame();
+    CHECK(pool.query_stats().resident == 0 && pool.query_stats().resident_bytes == 0);
+    CHECK(pool.query_stats().evictions == 4);
+    CHECK(sg_query_image_state(a.image) == SG_RESOURCESTATE_INVALID);
+    CHECK(sg_query_view_state(a.attachment) == SG_RESOURCESTATE_INVALID);
+
+    sg::rt_pool::target e = pool.acquire(32, 32);
+    pool.clear();
+    CHECK(sg_query_image_state(e.image) == SG_RESOURCESTATE_INVALID);
+    CHECK(pool.query_stats().resident == 0);
+}
+
+} // namespace
+
+int main() {
+    sg::headless gfx(sg::desc().logger_func(slog_func));
+    test_rt_pool();
+    return test::finish("test_rt_pool");
+}